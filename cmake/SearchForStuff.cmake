@@ -88,6 +88,9 @@ endif()
 include(CheckLib)
 if(Linux)
     check_lib(AIO aio libaio.h)
+    # Kernel headers for the io_uring iso reader, aio is used on kernels without it
+    include(CheckIncludeFile)
+    check_include_file(linux/io_uring.h HAVE_IO_URING)
     # There are two udev pkg config files - udev.pc (wrong), libudev.pc (correct)
     # When cross compiling, pkg-config will be skipped so we have to look for
     # udev (it'll automatically be prefixed with lib). But when not cross
@@ -29,6 +29,15 @@
 
 #endif
 
+// Functions that use a newer instruction set than the one the project is built for, and are
+// only ever called after checking x86caps, must be tagged with this.  GCC/clang refuse to
+// inline the intrinsics otherwise; MSVC allows any intrinsic anywhere.
+#if defined(__GNUC__)
+#define __avx2_target __attribute__((target("avx2")))
+#else
+#define __avx2_target
+#endif
+
 // CPU information support
 #if defined(_WIN32)
 
@@ -25,6 +25,10 @@
 #endif
 #include <memory>
 
+#ifdef HAVE_IO_URING
+class IoUringReader;
+#endif
+
 class AsyncFileReader
 {
 protected:
@@ -76,6 +80,11 @@ class FlatFileReader : public AsyncFileReader
 #elif defined(__linux__)
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
+#ifdef HAVE_IO_URING
+	// io_uring backend, with read-ahead; NULL when the kernel doesn't support it, in
+	// which case reads go through m_aio_context.
+	std::unique_ptr<IoUringReader> m_uring;
+#endif
 #elif defined(__POSIX__)
 	int m_fd; // TODO OSX don't know if overlap as an equivalent on OSX
 	struct aiocb m_aiocb;
@@ -81,7 +81,7 @@ bool BlockdumpFileReader::Open(const wxString& fileName)
 	m_file->Read(&m_blockofs, sizeof(m_blockofs));
 
 	wxFileOffset flen = m_file->GetLength();
-	static const wxFileOffset datalen = flen - BlockDumpHeaderSize;
+	const wxFileOffset datalen = flen - BlockDumpHeaderSize;
 
 	pxAssert( (datalen % (m_blocksize + 4)) == 0);
 
@@ -0,0 +1,402 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "DiscScanner.h"
+#include "IsoFS/IsoFS.h"
+#include "IsoFS/IsoFSImage.h"
+#include "Elfheader.h"
+#include "GameDatabase.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <emmintrin.h>
+#include <mutex>
+#include <thread>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+static const wxChar* CacheHeader = L"PCSX2 disc scan cache 1";
+
+// Same list as the iso selector in the main menu.
+static const wxChar* ImageExtensions[] =
+{
+	L"iso", L"mdf", L"nrg", L"bin", L"img", L"dump", L"gz", L"cso", NULL
+};
+
+static void GetFileStamp(const wxString& filename, s64& size, s64& time)
+{
+	wxFileName fn(filename);
+	wxULongLong fsize = fn.GetSize();
+
+	size = (fsize == wxInvalidSize) ? 0 : (s64)fsize.GetValue();
+	time = fn.FileExists() ? (s64)fn.GetModificationTime().GetTicks() : 0;
+}
+
+// SYSTEM.CNF, parsed as GetPS2ElfName does, minus the console output.
+static void ReadSystemCnf(const IsoDirectory& rootdir, DiscScanResult& result)
+{
+	if (!rootdir.IsFile(L"SYSTEM.CNF;1"))
+		return;
+
+	IsoFile file(rootdir, L"SYSTEM.CNF;1");
+
+	while (!file.eof())
+	{
+		const ParsedAssignmentString parts(fromUTF8(file.readLine().c_str()));
+
+		if (parts.lvalue.IsEmpty() && parts.rvalue.IsEmpty()) continue;
+
+		if (parts.lvalue == L"BOOT2")
+		{
+			result.elfPath = parts.rvalue;
+			result.discType = 2;
+		}
+		else if (parts.lvalue == L"BOOT")
+		{
+			result.elfPath = parts.rvalue;
+			result.discType = 1;
+		}
+		else if (parts.lvalue == L"VMODE")
+			result.videoMode = parts.rvalue;
+		else if (parts.lvalue == L"VER")
+			result.version = parts.rvalue;
+	}
+}
+
+// Serial from the boot path, as cdvdReloadElfInfo / _reloadElfInfo work it out.
+static void SetSerial(DiscScanResult& result)
+{
+	if (result.discType == 1)
+	{
+		wxString fname = result.elfPath.AfterLast('\\').AfterLast(':');
+		result.serial = fname.BeforeFirst(';');
+		return;
+	}
+
+	wxString fname = result.elfPath.AfterLast('\\');
+	if (!fname)
+		fname = result.elfPath.AfterLast('/');
+	if (!fname)
+		fname = result.elfPath.AfterLast(':');
+	if (fname.Matches(L"????_???.??*"))
+		result.serial = fname(0,4) + L"-" + fname(5,3) + fname(9,2);
+}
+
+// ElfObject::getCRC is the xor of every 32 bit word of the ELF.  The file is streamed in
+// chunks that are multiples of 16 bytes, so each chunk starts on the same word boundary
+// and can be folded 16 bytes at a time, leaving only the last few words to the scalar loop.
+static bool ReadElf(const IsoDirectory& rootdir, DiscScanResult& result)
+{
+	static const uint ChunkSize = 64 * 1024;
+
+	// loadElf's fix for discs that don't use version ;1 in SYSTEM.CNF
+	const wxString elfname = wxStringTokenizer(result.elfPath, L';').GetNextToken() + L";1";
+
+	IsoFile file(rootdir, elfname);
+
+	const u32 length = file.getLength() & ~3;
+	if (length < sizeof(ELF_HEADER))
+	{
+		result.error = L"ELF file is too small: " + elfname;
+		return false;
+	}
+
+	__aligned16 u8 buffer[ChunkSize];
+	__m128i acc[4] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+	u32 crc = 0;
+
+	for (u32 pos = 0; pos < length; )
+	{
+		const u32 len = std::min<u32>(length - pos, ChunkSize);
+		if (file.read(buffer, len) != (int)len)
+		{
+			result.error = L"Unexpected end of file reading " + elfname;
+			return false;
+		}
+
+		if (pos == 0)
+		{
+			const ELF_HEADER& header = *(ELF_HEADER*)buffer;
+			if (memcmp(header.e_ident, "\x7f" "ELF", 4) != 0)
+			{
+				result.error = elfname + L" is not an ELF file";
+				return false;
+			}
+			result.entry = header.e_entry;
+		}
+
+		u32 i = 0;
+		for (; i + 64 <= len; i += 64)
+		{
+			acc[0] = _mm_xor_si128(acc[0], _mm_load_si128((const __m128i*)&buffer[i]));
+			acc[1] = _mm_xor_si128(acc[1], _mm_load_si128((const __m128i*)&buffer[i + 16]));
+			acc[2] = _mm_xor_si128(acc[2], _mm_load_si128((const __m128i*)&buffer[i + 32]));
+			acc[3] = _mm_xor_si128(acc[3], _mm_load_si128((const __m128i*)&buffer[i + 48]));
+		}
+		for (; i + 16 <= len; i += 16)
+			acc[0] = _mm_xor_si128(acc[0], _mm_load_si128((const __m128i*)&buffer[i]));
+		for (; i < len; i += 4)
+			crc ^= *(u32*)&buffer[i];
+
+		pos += len;
+	}
+
+	__aligned16 u32 lanes[4];
+	_mm_store_si128((__m128i*)lanes, _mm_xor_si128(_mm_xor_si128(acc[0], acc[1]), _mm_xor_si128(acc[2], acc[3])));
+	result.crc = crc ^ lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3];
+	return true;
+}
+
+bool DiscScanner::ScanImage(const wxString& filename, DiscScanResult& result)
+{
+	result = DiscScanResult();
+	result.filename = filename;
+	GetFileStamp(filename, result.fileSize, result.fileTime);
+
+	try
+	{
+		IsoFSImage image;
+		if (!image.Open(filename))
+		{
+			result.error = L"Can't open the image";
+			return false;
+		}
+
+		IsoDirectory rootdir(image);
+		ReadSystemCnf(rootdir, result);
+
+		if (result.discType == 0)
+			return true;
+
+		SetSerial(result);
+
+		// PS1 discs don't get a CRC in the emulator either
+		if (result.discType == 2 && !ReadElf(rootdir, result))
+			return false;
+	}
+	catch (BaseException& ex)
+	{
+		result.error = ex.FormatDiagnosticMessage();
+		return false;
+	}
+	catch (std::exception& ex)
+	{
+		result.error = fromUTF8(ex.what());
+		return false;
+	}
+
+	return true;
+}
+
+void DiscScanner::FindImages(const wxString& dir, std::vector<wxString>& files)
+{
+	wxArrayString found;
+	wxDir::GetAllFiles(dir, &found, wxEmptyString, wxDIR_FILES | wxDIR_DIRS);
+	found.Sort();
+
+	for (const wxString& file : found)
+	{
+		const wxString ext = wxFileName(file).GetExt().Lower();
+		for (const wxChar** known = ImageExtensions; *known; known++)
+		{
+			if (ext == *known)
+			{
+				files.push_back(file);
+				break;
+			}
+		}
+	}
+}
+
+// --------------------------------------------------------------------------------------
+//  Cache file
+// --------------------------------------------------------------------------------------
+// UTF-8 text, one image per line with tab separated fields, after a version header line.
+// The game database fields aren't stored: the database changes more often than the images.
+
+static wxString CacheField(const wxString& src)
+{
+	wxString dest(src);
+	dest.Replace(L"\t", L" ");
+	dest.Replace(L"\r", L" ");
+	dest.Replace(L"\n", L" ");
+	return dest;
+}
+
+bool DiscScanner::LoadCache(const wxString& filename)
+{
+	if (!wxFileExists(filename))
+		return false;
+
+	wxFFile file(filename, L"rb");
+	wxString contents;
+	if (!file.IsOpened() || !file.ReadAll(&contents, wxConvUTF8))
+		return false;
+
+	wxStringTokenizer lines(contents, L"\r\n", wxTOKEN_STRTOK);
+	if (!lines.HasMoreTokens() || lines.GetNextToken() != CacheHeader)
+	{
+		Console.Warning(L"(DiscScanner) Ignoring outdated cache: " + filename);
+		return false;
+	}
+
+	while (lines.HasMoreTokens())
+	{
+		wxStringTokenizer fields(lines.GetNextToken(), L"\t", wxTOKEN_RET_EMPTY_ALL);
+		if (fields.CountTokens() != 11)
+			continue;
+
+		DiscScanResult result;
+		wxLongLong_t ll;
+		unsigned long ul;
+
+		result.filename		= fields.GetNextToken();
+		result.fileSize		= fields.GetNextToken().ToLongLong(&ll) ? ll : -1;
+		result.fileTime		= fields.GetNextToken().ToLongLong(&ll) ? ll : -1;
+		result.discType		= wxAtoi(fields.GetNextToken());
+		result.serial		= fields.GetNextToken();
+		result.crc			= fields.GetNextToken().ToULong(&ul, 16) ? ul : 0;
+		result.entry		= fields.GetNextToken().ToULong(&ul, 16) ? ul : 0;
+		result.elfPath		= fields.GetNextToken();
+		result.version		= fields.GetNextToken();
+		result.videoMode	= fields.GetNextToken();
+		result.error		= fields.GetNextToken();
+
+		m_results[result.filename] = result;
+	}
+
+	return true;
+}
+
+bool DiscScanner::SaveCache(const wxString& filename) const
+{
+	wxFFile file(filename, L"wb");
+	if (!file.IsOpened())
+		return false;
+
+	wxString contents;
+	contents += CacheHeader;
+	contents += L"\n";
+
+	for (const auto& it : m_results)
+	{
+		const DiscScanResult& result = it.second;
+		contents += pxsFmt(L"%s\t%lld\t%lld\t%d\t%s\t%08x\t%08x\t%s\t%s\t%s\t%s\n",
+			WX_STR(CacheField(result.filename)), (long long)result.fileSize, (long long)result.fileTime,
+			result.discType, WX_STR(CacheField(result.serial)), result.crc, result.entry,
+			WX_STR(CacheField(result.elfPath)), WX_STR(CacheField(result.version)),
+			WX_STR(CacheField(result.videoMode)), WX_STR(CacheField(result.error)));
+	}
+
+	return file.Write(contents, wxConvUTF8);
+}
+
+// --------------------------------------------------------------------------------------
+//  Parallel scan
+// --------------------------------------------------------------------------------------
+// Workers pull the next image off a shared index and post it back once done; the calling
+// thread only reports progress and collects the results.  Most of the time goes into
+// waiting on reads, so there are never fewer than four workers, even on small cpus.
+
+void DiscScanner::Scan(const std::vector<wxString>& files, uint threads, const ProgressFn& progress)
+{
+	std::vector<wxString> todo;
+	for (const wxString& file : files)
+	{
+		auto it = m_results.find(file);
+		if (it != m_results.end())
+		{
+			s64 size, time;
+			GetFileStamp(file, size, time);
+			if (it->second.fileSize == size && it->second.fileTime == time)
+				continue;
+		}
+		todo.push_back(file);
+	}
+
+	if (todo.empty())
+		return;
+
+	if (threads == 0)
+		threads = std::max(std::thread::hardware_concurrency(), 4u);
+	threads = std::min<uint>(threads, todo.size());
+
+	std::vector<DiscScanResult> results(todo.size());
+	std::vector<size_t> done;
+	std::atomic<size_t> next(0);
+	std::mutex lock;
+	std::condition_variable finished;
+
+	auto worker = [&]()
+	{
+		for (size_t i; (i = next.fetch_add(1)) < todo.size(); )
+		{
+			ScanImage(todo[i], results[i]);
+
+			std::lock_guard<std::mutex> guard(lock);
+			done.push_back(i);
+			finished.notify_one();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (uint i = 0; i < threads; i++)
+		workers.emplace_back(worker);
+
+	std::vector<size_t> ready;
+	for (size_t reported = 0; reported < todo.size(); )
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			finished.wait(guard, [&]() { return !done.empty(); });
+			ready.swap(done);
+		}
+
+		for (size_t i : ready)
+		{
+			if (progress)
+				progress(results[i]);
+			m_results[todo[i]] = results[i];
+		}
+		reported += ready.size();
+		ready.clear();
+	}
+
+	for (std::thread& thread : workers)
+		thread.join();
+}
+
+void DiscScanner::LookupGameDatabase(IGameDatabase& db)
+{
+	for (auto& it : m_results)
+	{
+		DiscScanResult& result = it.second;
+		if (result.serial.IsEmpty())
+			continue;
+
+		Game_Data game;
+		if (!db.findGame(game, result.serial))
+			continue;
+
+		result.name		= game.getString(L"Name");
+		result.region	= game.getString(L"Region");
+		result.compat	= game.getInt(L"Compat");
+	}
+}
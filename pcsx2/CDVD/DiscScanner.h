@@ -0,0 +1,93 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <vector>
+
+class IGameDatabase;
+
+// --------------------------------------------------------------------------------------
+//  DiscScanResult
+// --------------------------------------------------------------------------------------
+struct DiscScanResult
+{
+	wxString	filename;
+	s64			fileSize;
+	s64			fileTime;		// modification time of the image, validates cached results
+
+	int			discType;		// as GetPS2ElfName: 0 = no SYSTEM.CNF, 1 = PS1, 2 = PS2
+	wxString	elfPath;		// BOOT2 (or BOOT) line of SYSTEM.CNF
+	wxString	serial;
+	wxString	version;		// VER line of SYSTEM.CNF
+	wxString	videoMode;		// VMODE line of SYSTEM.CNF
+	u32			crc;			// same as ElfCRC once the disc boots (PS2 only)
+	u32			entry;			// ELF entry point (PS2 only)
+
+	// From the game database, filled by DiscScanner::LookupGameDatabase (not cached).
+	wxString	name;
+	wxString	region;
+	int			compat;
+
+	wxString	error;			// why the image couldn't be scanned, empty on success
+
+	DiscScanResult()
+	{
+		fileSize	= 0;
+		fileTime	= 0;
+		discType	= 0;
+		crc			= 0;
+		entry		= 0;
+		compat		= 0;
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  DiscScanner
+// --------------------------------------------------------------------------------------
+// Reads the serial, ELF CRC and game database info of disc images without booting them.
+// Each image is opened through its own IsoFSImage rather than the global CDVD state, so
+// ScanImage can run on any thread and Scan runs several images at once.  Results can be
+// kept in a cache file, keyed on the image path, size and modification time.
+//
+class DiscScanner
+{
+public:
+	typedef std::function<void(const DiscScanResult&)> ProgressFn;
+
+protected:
+	std::map<wxString, DiscScanResult> m_results;
+
+public:
+	// Scans a single image.  Returns false (and sets result.error) if it couldn't be read.
+	static bool ScanImage(const wxString& filename, DiscScanResult& result);
+
+	// Appends the images in dir and its subfolders with extensions the iso loader knows.
+	static void FindImages(const wxString& dir, std::vector<wxString>& files);
+
+	bool LoadCache(const wxString& filename);
+	bool SaveCache(const wxString& filename) const;
+
+	// Scans files on the given number of threads (0 picks one per cpu), skipping those
+	// with an up-to-date cached result.  progress is called on the calling thread as each
+	// image is done.
+	void Scan(const std::vector<wxString>& files, uint threads = 0, const ProgressFn& progress = ProgressFn());
+
+	void LookupGameDatabase(IGameDatabase& db);
+
+	const std::map<wxString, DiscScanResult>& GetResults() const { return m_results; }
+};
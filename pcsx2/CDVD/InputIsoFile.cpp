@@ -48,6 +48,41 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 	return m_reader->ReadSync(dst+m_blockofs, lsn, 1);
 }
 
+// Reads the 2048 bytes of user data of count consecutive sectors, for IsoFS.  Not to be mixed
+// with BeginRead2/FinishRead3, it reuses the read buffer.
+int InputIsoFile::ReadUserData(u8* dst, uint lsn, uint count)
+{
+	if (lsn >= m_blocks || count > m_blocks - lsn)
+	{
+		Console.Error("isoFile error: Block index is past the end of file! (%u + %u > %u).", lsn, count, m_blocks);
+		return -1;
+	}
+
+	pxAssert(!m_read_inprogress);
+	m_read_lsn = -1;
+	m_read_count = 0;
+
+	// user data is 24 bytes into the raw sector
+	const int dataofs = 24 - m_blockofs;
+
+	while (count > 0)
+	{
+		const uint n = std::min(count, MaxReadUnit);
+		const int ret = m_reader->ReadSync(m_readbuffer, lsn, n);
+		if (ret < 0)
+			return ret;
+
+		for (uint i = 0; i < n; i++)
+			memcpy(dst + i * 2048, m_readbuffer + i * m_blocksize + dataofs, 2048);
+
+		dst += n * 2048;
+		lsn += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
 void InputIsoFile::BeginRead2(uint lsn)
 {
 	m_current_lsn = lsn;
@@ -293,7 +328,7 @@ bool InputIsoFile::IsOpened() const
 
 bool InputIsoFile::tryIsoType(u32 _size, s32 _offset, s32 _blockofs)
 {
-	static u8 buf[2456];
+	u8 buf[2456];
 
 	m_blocksize	= _size;
 	m_offset	= _offset;
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+
 enum IsoFS_Type
 {
 	FStype_ISO9660	= 1,
@@ -28,6 +31,13 @@ public:
 	std::vector<IsoFileDescriptor>	files;
 	IsoFS_Type						m_fstype;
 
+protected:
+	// hash of the name -> index in files
+	std::unordered_multimap<u32, int>	m_nameIndex;
+
+	// subdirectories FindFile has already walked through, by lba
+	mutable std::unordered_map<u32, std::unique_ptr<IsoDirectory>>	m_subdirs;
+
 public:
 	IsoDirectory(SectorSource& r);
 	IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry);
@@ -50,4 +60,5 @@ protected:
 
 	void Init(const IsoFileDescriptor& directoryEntry);
 	int GetIndexOf(const wxString& fileName) const;
+	const IsoDirectory& GetSubdirectory(const IsoFileDescriptor& directoryEntry) const;
 };
@@ -27,6 +27,15 @@
 //u8		filesystemType;	// 0x01 = ISO9660, 0x02 = Joliet, 0xFF = NULL
 //u8		volID[5];		// "CD001"
 
+static u32 HashName(const wxString& name)
+{
+	// FNV-1a
+	u32 hash = 2166136261u;
+	for (wxString::const_iterator it = name.begin(); it != name.end(); ++it)
+		hash = (hash ^ (u32)(wxChar)*it) * 16777619u;
+	return hash;
+}
+
 
 wxString IsoDirectory::FStype_ToString() const
 {
@@ -116,6 +125,8 @@ void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 	IsoFile dataStream (internalReader, directoryEntry);
 
 	files.clear();
+	m_nameIndex.clear();
+	m_subdirs.clear();
 
 	uint remainingSize = directoryEntry.size;
 
@@ -135,6 +146,7 @@ void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 		dataStream.read(b+1, b[0]-1);
 
 		files.push_back(IsoFileDescriptor(b, b[0]));
+		m_nameIndex.emplace(HashName(files.back().name), (int)files.size() - 1);
 	}
 
 	b[0] = 0;
@@ -147,12 +159,27 @@ const IsoFileDescriptor& IsoDirectory::GetEntry(int index) const
 
 int IsoDirectory::GetIndexOf(const wxString& fileName) const
 {
-	for(unsigned int i=0;i<files.size();i++)
+	// first match in directory order, if a name is listed more than once
+	int index = -1;
+	auto range = m_nameIndex.equal_range(HashName(fileName));
+	for (auto it = range.first; it != range.second; ++it)
 	{
-		if(files[i].name == fileName) return i;
+		if ((index < 0 || it->second < index) && files[it->second].name == fileName)
+			index = it->second;
 	}
 
-	throw Exception::FileNotFound(fileName);
+	if (index < 0)
+		throw Exception::FileNotFound(fileName);
+
+	return index;
+}
+
+const IsoDirectory& IsoDirectory::GetSubdirectory(const IsoFileDescriptor& directoryEntry) const
+{
+	std::unique_ptr<IsoDirectory>& dir = m_subdirs[directoryEntry.lba];
+	if (!dir)
+		dir.reset(new IsoDirectory(internalReader, directoryEntry));
+	return *dir;
 }
 
 const IsoFileDescriptor& IsoDirectory::GetEntry(const wxString& fileName) const
@@ -169,7 +196,6 @@ IsoFileDescriptor IsoDirectory::FindFile(const wxString& filePath) const
 	wxFileName parts( filePath, wxPATH_DOS );
 	IsoFileDescriptor info;
 	const IsoDirectory* dir = this;
-	std::unique_ptr<IsoDirectory> deleteme;
 
 	// walk through path ("." and ".." entries are in the directories themselves, so even if the
 	// path included . and/or .., it still works)
@@ -179,8 +205,7 @@ IsoFileDescriptor IsoDirectory::FindFile(const wxString& filePath) const
 		info = dir->GetEntry(parts.GetDirs()[i]);
 		if(info.IsFile()) throw Exception::FileNotFound( filePath );
 
-		deleteme.reset(new IsoDirectory(internalReader, info));
-		dir = deleteme.get();
+		dir = &dir->GetSubdirectory(info);
 	}
 
 	if( !parts.GetFullName().IsEmpty() )
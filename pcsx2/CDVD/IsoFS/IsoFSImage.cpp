@@ -0,0 +1,44 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PrecompiledHeader.h"
+
+#include "IsoFSImage.h"
+
+bool IsoFSImage::Open(const wxString& filename)
+{
+	return m_iso.Open(filename);
+}
+
+void IsoFSImage::Close()
+{
+	m_iso.Close();
+}
+
+bool IsoFSImage::readSector(unsigned char* buffer, int lba)
+{
+	return readSectors(buffer, lba, 1);
+}
+
+bool IsoFSImage::readSectors(unsigned char* buffer, int lba, int count)
+{
+	return m_iso.ReadUserData(buffer, lba, count) >= 0;
+}
+
+int IsoFSImage::getNumSectors()
+{
+	return m_iso.GetBlockCount();
+}
@@ -0,0 +1,47 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SectorSource.h"
+#include "../IsoFileFormats.h"
+
+// --------------------------------------------------------------------------------------
+//  IsoFSImage
+// --------------------------------------------------------------------------------------
+// SectorSource reading a disc image through its own InputIsoFile, instead of the global CDVD
+// state IsoFSCDVD goes through.  Each instance is independent, so any number of images can be
+// browsed at once, from as many threads, without mounting them.
+//
+class IsoFSImage: public SectorSource
+{
+protected:
+	InputIsoFile m_iso;
+
+public:
+	IsoFSImage() = default;
+	virtual ~IsoFSImage() = default;
+
+	// Throws Exception::BadStream if the image format isn't recognized.
+	bool Open(const wxString& filename);
+	void Close();
+
+	const InputIsoFile& GetIso() const { return m_iso; }
+
+	virtual bool readSector(unsigned char* buffer, int lba);
+	virtual bool readSectors(unsigned char* buffer, int lba, int count);
+
+	virtual int  getNumSectors();
+};
@@ -49,21 +49,39 @@ void IsoFile::Init()
 	sectorOffset		= 0;
 	maxOffset			= std::max<u32>( 0, fileEntry.size );
 
+	readBuffer.assign( sectorLength, 0 );
+	readBufferLba		= 0;
+	readBufferCount		= 0;
+	currentSector		= readBuffer.data();
+
 	if(maxOffset > 0)
-		internalReader.readSector(currentSector, currentSectorNumber);
+		loadSector(currentSectorNumber);
+}
+
+// Points currentSector at the given sector, reading it and the following sectors of the file
+// if it isn't buffered yet.
+void IsoFile::loadSector(int lba)
+{
+	if (lba < readBufferLba || lba >= readBufferLba + readBufferCount)
+	{
+		const int lastSector = fileEntry.lba + (int)((std::max<u32>(maxOffset, 1) - 1) / sectorLength);
+		const int count = std::max(1, std::min((int)readAheadSectors, lastSector - lba + 1));
+
+		readBuffer.resize( count * sectorLength );
+		readBufferLba = lba;
+		readBufferCount = internalReader.readSectors(readBuffer.data(), lba, count) ? count : 0;
+	}
+
+	currentSector = readBuffer.data() + (lba - readBufferLba) * sectorLength;
 }
 
 u32 IsoFile::seek(u32 absoffset)
 {
 	u32 endOffset = absoffset;
 
-	int oldSectorNumber = currentSectorNumber;
 	int newSectorNumber = fileEntry.lba + (int)(endOffset / sectorLength);
 
-	if(oldSectorNumber != newSectorNumber)
-	{
-		internalReader.readSector(currentSector, newSectorNumber);
-	}
+	loadSector(newSectorNumber);
 
 	currentOffset = endOffset;
 	currentSectorNumber = newSectorNumber;
@@ -129,7 +147,7 @@ void IsoFile::makeDataAvailable()
 	if (sectorOffset >= sectorLength)
 	{
 		currentSectorNumber++;
-		internalReader.readSector(currentSector, currentSectorNumber);
+		loadSector(currentSectorNumber);
 		sectorOffset -= sectorLength;
 	}
 }
@@ -183,6 +201,20 @@ s32 IsoFile::read(void* dest, s32 len)
 	len -= firstSector;
 	totalLength += firstSector;
 
+	// Large reads of whole sectors go straight to dest
+	const int wholeSectors = std::min<u32>(len, maxOffset - currentOffset) / sectorLength;
+	if ((sectorOffset == sectorLength) && (wholeSectors >= readAheadSectors))
+	{
+		internalReader.readSectors((u8*)dest + off, currentSectorNumber + 1, wholeSectors);
+
+		const int n = wholeSectors * sectorLength;
+		currentSectorNumber += wholeSectors;
+		currentOffset += n;
+		off += n;
+		len -= n;
+		totalLength += n;
+	}
+
 	// Read whole sectors
 	while ((len >= sectorLength) && (currentOffset < maxOffset))
 	{
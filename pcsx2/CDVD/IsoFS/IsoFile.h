@@ -18,11 +18,16 @@
 #include "IsoFileDescriptor.h"
 #include "SectorSource.h"
 
+#include <vector>
+
 class IsoFile
 {
 public:
 	static const int sectorLength = 2048;
 
+	// Sectors of the file read at once when reading sequentially
+	static const int readAheadSectors = 16;
+
 protected:
 	SectorSource&		internalReader;
 	IsoFileDescriptor	fileEntry;
@@ -31,9 +36,13 @@ protected:
 	u32 maxOffset;
 
 	int currentSectorNumber;
-	u8	currentSector[sectorLength];
+	u8*	currentSector;				// points into readBuffer
 	int sectorOffset;
 
+	std::vector<u8> readBuffer;
+	int readBufferLba;
+	int readBufferCount;
+
 public:
 	IsoFile(const IsoDirectory& dir, const wxString& filename);
 	IsoFile(SectorSource& reader, const wxString& filename);
@@ -71,6 +80,7 @@ public:
 
 protected:
 	void makeDataAvailable();
+	void loadSector(int lba);
 	int  internalRead(void* dest, int off, int len);
 	void Init();
 };
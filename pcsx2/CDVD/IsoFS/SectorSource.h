@@ -20,5 +20,18 @@ class SectorSource
 public:
 	virtual int  getNumSectors()=0;
 	virtual bool readSector(unsigned char* buffer, int lba)=0;
+
+	// Reads count consecutive 2048 byte sectors.  Sources that can do better than one sector at
+	// a time should override this.
+	virtual bool readSectors(unsigned char* buffer, int lba, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!readSector(buffer + i * 2048, lba + i))
+				return false;
+		}
+		return true;
+	}
+
 	virtual ~SectorSource() = default;
 };
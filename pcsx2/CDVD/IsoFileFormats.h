@@ -86,6 +86,7 @@ public:
 	bool Detect( bool readType=true );
 
 	int ReadSync(u8* dst, uint lsn);
+	int ReadUserData(u8* dst, uint lsn, uint count);
 
 	void BeginRead2(uint lsn);
 	int FinishRead3(u8* dest, uint mode);
@@ -44,7 +44,7 @@ int getFreeCache(u32 mem, int mode, int * way)
 {
 	int number = 0;
 	const int i = (mem >> 6) & 0x3F;
-	const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+	const u32 vmv = vtlb_GetVMapEntry(mem);
 	s32 ppf = mem + vmv;
 	const u32 hand = (u8)vmv;
 	const u32 paddr = ppf - hand + 0x80000000;
@@ -112,7 +112,7 @@ void writeCache8(u32 mem, u8 value)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		*reinterpret_cast<mem8_t*>(ppf) = value;
 		return;
@@ -130,7 +130,7 @@ void writeCache16(u32 mem, u16 value)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		*reinterpret_cast<mem16_t*>(ppf) = value;
 		return;
@@ -148,7 +148,7 @@ void writeCache32(u32 mem, u32 value)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		*reinterpret_cast<mem32_t*>(ppf) = value;
 		return;
@@ -166,7 +166,7 @@ void writeCache64(u32 mem, const u64 value)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		*reinterpret_cast<mem64_t*>(ppf) = value;
 		return;
@@ -184,7 +184,7 @@ void writeCache128(u32 mem, const mem128_t* value)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		*reinterpret_cast<mem64_t*>(ppf) = value->lo;
 		*reinterpret_cast<mem64_t*>(ppf+8) = value->hi;
@@ -204,7 +204,7 @@ u8 readCache8(u32 mem)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		return *reinterpret_cast<u8*>(ppf);
 	}
@@ -220,7 +220,7 @@ u16 readCache16(u32 mem)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		return *reinterpret_cast<u16*>(ppf);
 	}
@@ -236,7 +236,7 @@ u32 readCache32(u32 mem)
 
 	if (i == -1)
 	{
-		const u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		const u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf = mem + vmv;
 		return *reinterpret_cast<u32*>(ppf);
 	}
@@ -252,7 +252,7 @@ u64 readCache64(u32 mem)
 
 	if (i == -1)
 	{
-		u32 vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
+		u32 vmv = vtlb_GetVMapEntry(mem);
 		s32 ppf=mem + vmv;
 		return *reinterpret_cast<u64*>(ppf);
 	}
@@ -297,7 +297,7 @@ void CACHE()
 			const int index = (addr >> 6) & 0x3F;
 			int way = 0;
 			const u32 pfnaddr = addr;
-			const u32 vmv = vtlbdata.vmap[pfnaddr >> VTLB_PAGE_BITS];
+			const u32 vmv = vtlb_GetVMapEntry(pfnaddr);
 			const s32 ppf = pfnaddr + vmv;
 			const u32 hand = (u8)vmv;
 			const u32 paddr = ppf - hand + 0x80000000;
@@ -327,7 +327,7 @@ void CACHE()
 			const int index = (addr >> 6) & 0x3F;
 			int way = 0;
 			const u32 pfnaddr = addr;
-			const u32 vmv = vtlbdata.vmap[pfnaddr >> VTLB_PAGE_BITS];
+			const u32 vmv = vtlb_GetVMapEntry(pfnaddr);
 			s32 ppf = (pfnaddr + vmv) & ~0x3F;
 			const u32 hand = (u8)vmv;
 			const u32 paddr = ppf - hand + 0x80000000;
@@ -371,7 +371,7 @@ void CACHE()
 			const int index = (addr >> 6) & 0x3F;
 			int way = 0;
 			const u32 pfnaddr = (pCache[index].tag[way] & ~0x80000fff) | (addr & 0xfc0);
-			const u32 vmv = vtlbdata.vmap[pfnaddr >> VTLB_PAGE_BITS];
+			const u32 vmv = vtlb_GetVMapEntry(pfnaddr);
 			s32 ppf = (pfnaddr + vmv) & ~0x3F;
 			const u32 hand = (u8)vmv;
 			const u32 paddr = ppf - hand + 0x80000000;
@@ -439,7 +439,7 @@ void CACHE()
 			//DXLTG demands that SYNC.L is called before this command, which forces the cache to write back, so presumably games are checking the cache has updated the memory
 			//For speed, we will do it here.
 			const u32 pfnaddr = (pCache[index].tag[way] & ~0x80000fff) | (addr & 0xfc0);
-			const u32 vmv = vtlbdata.vmap[pfnaddr >> VTLB_PAGE_BITS];
+			const u32 vmv = vtlb_GetVMapEntry(pfnaddr);
 			s32 ppf = (pfnaddr + vmv) & ~0x3F;
 
 			if ((pCache[index].tag[way] & (DIRTY_FLAG | VALID_FLAG)) == (DIRTY_FLAG | VALID_FLAG))	// Dirty
@@ -489,7 +489,7 @@ void CACHE()
 			const int index = (addr >> 6) & 0x3F;
 			const int way = addr & 0x1;
 			const u32 pfnaddr = (pCache[index].tag[way] & ~0x80000fff) + (addr & 0xFC0);
-			const u32 vmv = vtlbdata.vmap[pfnaddr >> VTLB_PAGE_BITS];
+			const u32 vmv = vtlb_GetVMapEntry(pfnaddr);
 			s32 ppf = pfnaddr + vmv;
 			const u32 hand = (u8)vmv;
 			const u32 paddr = ppf - hand + 0x80000000;
@@ -154,19 +154,24 @@ struct TraceLogFilters
 	// so I prefer this to help keep them usable.
 	bool	Enabled;
 
+	// Binary - trace writes are recorded unformatted to emuLog.trace (see BinaryTrace.h),
+	// for tools/tracedump to render.
+	bool	Binary;
+
 	TraceFiltersEE	EE;
 	TraceFiltersIOP	IOP;
 
 	TraceLogFilters()
 	{
 		Enabled	= false;
+		Binary	= false;
 	}
 
 	void LoadSave( IniInterface& ini );
 
 	bool operator ==( const TraceLogFilters& right ) const
 	{
-		return OpEqu( Enabled ) && OpEqu( EE ) && OpEqu( IOP );
+		return OpEqu( Enabled ) && OpEqu( Binary ) && OpEqu( EE ) && OpEqu( IOP );
 	}
 
 	bool operator !=( const TraceLogFilters& right ) const
@@ -0,0 +1,480 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "BinaryTrace.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace BinaryTrace;
+
+namespace
+{
+	struct FormatInfo
+	{
+		u16 id;
+		bool raw;		// false: written pre-formatted
+		u8 argc;
+		u8 types[MaxArgs];
+		std::string text;
+	};
+
+	struct Definition
+	{
+		u16 type;
+		u16 id;
+		u8 flags;
+		std::string text;
+	};
+
+	// Single producer (the owning thread), single consumer (the writer thread).
+	struct Ring
+	{
+		static const u32 Size = 1 << 15;	// records, 2MB
+
+		std::atomic<u32> head;
+		std::atomic<u32> tail;
+		std::atomic<u32> dropped;	// entries that didn't fit, reported by the writer
+		u16 index;
+		bool released;				// the owning thread has exited, s_lock
+		Record records[Size];
+
+		Ring(u16 idx) : head(0), tail(0), dropped(0), index(idx), released(false) {}
+	};
+
+	// Frees the thread's lookups when it exits, and hands its ring back for the writer
+	// to free once it has drained it.
+	struct RingOwner
+	{
+		~RingOwner();
+	};
+
+	std::mutex s_lock;							// everything below, except the rings' contents
+	std::unordered_map<std::string, FormatInfo> s_formats;
+	std::unordered_map<const void*, u16> s_sources;
+	std::vector<Definition> s_definitions;
+	std::vector<Ring*> s_rings;
+	u16 s_nextRing = 0;
+
+	std::thread s_writer;
+	std::condition_variable s_wake;
+	bool s_quit = false;
+	bool s_draining = false;					// the writer will drain the rings again
+	FILE* s_file = NULL;
+	size_t s_written = 0;						// s_definitions already in the file
+	int s_lastRing = -1;
+	std::atomic<bool> s_closed(false);			// Shutdown() was called
+
+	const FormatInfo s_preformatted = { PreformattedId, false, 1, { Arg_String }, "%s" };
+
+	// Per thread lookups, so that the lock is only taken the first time a thread sees
+	// a format or a source.
+	thread_local Ring* t_ring = NULL;
+	thread_local std::unordered_map<const char*, const FormatInfo*>* t_formats = NULL;
+	thread_local std::unordered_map<const void*, u16>* t_sources = NULL;
+	thread_local RingOwner t_owner;
+}
+
+// s_lock held
+static void FreeRing(Ring* ring)
+{
+	s_rings.erase(std::find(s_rings.begin(), s_rings.end(), ring));
+	delete ring;
+}
+
+RingOwner::~RingOwner()
+{
+	if (!t_ring)
+		return;
+
+	delete t_formats;
+	delete t_sources;
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	if (s_draining)
+		t_ring->released = true;
+	else
+		FreeRing(t_ring);
+}
+
+static void AddDefinition(u16 type, u16 id, u8 flags, std::string text)
+{
+	Definition def = { type, id, flags, std::move(text) };
+	s_definitions.push_back(std::move(def));
+}
+
+static void WriteRecords(const Record* recs, u32 count)
+{
+	if (s_file && count)
+		fwrite(recs, sizeof(Record), count, s_file);
+}
+
+static void WriteDefinition(const Definition& def)
+{
+	Record rec = {};
+	rec.type = def.type;
+	rec.format = def.id;
+	rec.source = def.id;
+	rec.flags = def.flags;
+
+	u32 size = std::min<size_t>(def.text.size(), 255 * sizeof(Record));
+	rec.extra = (size + sizeof(Record) - 1) / sizeof(Record);
+	WriteRecords(&rec, 1);
+
+	Record data[255] = {};
+	memcpy(data, def.text.data(), size);
+	WriteRecords(data, rec.extra);
+}
+
+// Writer thread: definitions first, so they always precede the entries using them.  The
+// ring heads are read under the same lock, entries pushed after that (possibly using a
+// definition added in the meantime) wait for the next drain.  The rings of exited threads
+// are complete, they're freed once written out.
+static void Drain()
+{
+	std::vector<Ring*> rings;
+	std::vector<u32> heads;
+	std::vector<Ring*> released;
+	{
+		std::lock_guard<std::mutex> lock(s_lock);
+		for (; s_written < s_definitions.size(); s_written++)
+			WriteDefinition(s_definitions[s_written]);
+		rings = s_rings;
+		for (Ring* ring : rings)
+		{
+			heads.push_back(ring->head.load(std::memory_order_acquire));
+			if (ring->released)
+				released.push_back(ring);
+		}
+	}
+
+	for (size_t r = 0; r < rings.size(); r++)
+	{
+		Ring* ring = rings[r];
+		u32 tail = ring->tail.load(std::memory_order_relaxed);
+		u32 head = heads[r];
+		if (head == tail && !ring->dropped.load(std::memory_order_relaxed))
+			continue;
+
+		if (s_lastRing != ring->index)
+		{
+			Record rec = {};
+			rec.type = Record_Thread;
+			rec.source = ring->index;
+			WriteRecords(&rec, 1);
+			s_lastRing = ring->index;
+		}
+
+		u32 start = tail % Ring::Size;
+		u32 count = head - tail;
+		u32 first = std::min(count, Ring::Size - start);
+		WriteRecords(&ring->records[start], first);
+		WriteRecords(&ring->records[0], count - first);
+
+		ring->tail.store(head, std::memory_order_release);
+
+		if (u32 dropped = ring->dropped.exchange(0, std::memory_order_relaxed))
+		{
+			Record rec = {};
+			rec.type = Record_Dropped;
+			rec.source = ring->index;
+			rec.args[0] = dropped;
+			WriteRecords(&rec, 1);
+		}
+	}
+
+	if (s_file)
+		fflush(s_file);
+
+	if (released.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	for (Ring* ring : released)
+		FreeRing(ring);
+}
+
+static void WriterThread()
+{
+	std::unique_lock<std::mutex> lock(s_lock);
+	while (!s_quit)
+	{
+		s_wake.wait_for(lock, std::chrono::milliseconds(5));
+		lock.unlock();
+		Drain();
+		lock.lock();
+	}
+	lock.unlock();
+	Drain();
+
+	// Threads exiting from now on free their own ring.
+	lock.lock();
+	for (size_t i = s_rings.size(); i-- > 0;)
+	{
+		if (s_rings[i]->released)
+			FreeRing(s_rings[i]);
+	}
+	s_draining = false;
+}
+
+// s_lock held
+static void StartWriter()
+{
+	wxFileName name(emuLogName.IsEmpty() ? L"emuLog.txt" : emuLogName);
+	name.SetExt(L"trace");
+
+	s_file = wxFopen(name.GetFullPath(), L"wb");
+	if (!s_file)
+		Console.Error(L"(BinaryTrace) Can't create %s", WX_STR(name.GetFullPath()));
+	else
+	{
+		FileHeader header = { FileMagic, FileVersion, sizeof(Record), 0 };
+		fwrite(&header, sizeof(header), 1, s_file);
+	}
+
+	AddDefinition(Record_Format, PreformattedId, 0, s_preformatted.text);
+	AddDefinition(Record_Source, 0, 0, std::string(1, '\0'));
+	s_formats.emplace(s_preformatted.text, s_preformatted);
+	s_sources[NULL] = 0;
+
+	s_quit = false;
+	s_draining = true;
+	s_writer = std::thread(WriterThread);
+}
+
+static Ring* GetRing()
+{
+	if (t_ring)
+		return t_ring;
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	if (!s_writer.joinable() && !s_closed)
+		StartWriter();
+
+	(void)t_owner;	// constructed on first use, its destructor runs at thread exit
+	t_ring = new Ring(s_nextRing++);
+	t_formats = new std::unordered_map<const char*, const FormatInfo*>;
+	t_sources = new std::unordered_map<const void*, u16>;
+	s_rings.push_back(t_ring);
+	return t_ring;
+}
+
+// Formats are keyed by their text, some trace sites build them at runtime.  The per-thread
+// cache is keyed by pointer and checked against the text.
+static const FormatInfo* GetFormat(const char* fmt)
+{
+	auto it = t_formats->find(fmt);
+	if (it != t_formats->end() && it->second->text == fmt)
+		return it->second;
+
+	FormatInfo parsed = {};
+	bool raw = ParseFormat(fmt,
+		[](const char*, size_t) {},
+		[&](const Conversion& c) {
+			for (uint i = 0; i < c.count; i++)
+			{
+				if (parsed.argc < MaxArgs)
+					parsed.types[parsed.argc] = c.types[i];
+				parsed.argc++;
+			}
+		});
+
+	// Messages without arguments are mostly built at runtime (disasm), keep them out of
+	// the format table along with what can't be stored raw.
+	if (!raw || parsed.argc == 0 || parsed.argc > MaxArgs)
+		return &s_preformatted;
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	auto ins = s_formats.emplace(fmt, FormatInfo());
+	FormatInfo& info = ins.first->second;
+	if (ins.second)
+	{
+		if (s_formats.size() > 0xffff)
+		{
+			s_formats.erase(ins.first);
+			return &s_preformatted;
+		}
+
+		info = parsed;
+		info.raw = true;
+		info.id = (u16)(s_formats.size() - 1);
+		info.text = fmt;
+		AddDefinition(Record_Format, info.id, 0, info.text);
+	}
+
+	(*t_formats)[fmt] = &info;
+	return &info;
+}
+
+static u16 GetSource(const void* source, const Prefix* prefix)
+{
+	auto it = t_sources->find(source);
+	if (it != t_sources->end())
+		return it->second;
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	auto ins = s_sources.emplace(source, (u16)s_sources.size());
+	if (ins.second)
+	{
+		std::string text;
+		if (prefix && prefix->name)
+			text = prefix->name;
+		text.push_back('\0');
+		if (prefix && prefix->tag)
+			text += prefix->tag;
+		AddDefinition(Record_Source, ins.first->second, (prefix && prefix->name) ? 1 : 0, text);
+	}
+
+	(*t_sources)[source] = ins.first->second;
+	return ins.first->second;
+}
+
+// Owning thread: copies an entry and its string arguments (strings[i] non-NULL, with
+// rec.args[i] bytes) into the ring, or counts it as dropped when it doesn't fit.
+static void Push(Ring& ring, Record rec, const char* const* strings, uint argc, u32 bytes)
+{
+	u32 extra = (bytes + sizeof(Record) - 1) / sizeof(Record);
+	rec.extra = extra;
+
+	u32 head = ring.head.load(std::memory_order_relaxed);
+	u32 used = head - ring.tail.load(std::memory_order_acquire);
+	if (Ring::Size - used < 1 + extra)
+	{
+		ring.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// don't wait for the writer's timeout during bursts
+	if (used < Ring::Size / 2 && used + 1 + extra >= Ring::Size / 2)
+		s_wake.notify_one();
+
+	ring.records[head++ % Ring::Size] = rec;
+
+	// string contents, packed back to back across the data records
+	u32 pos = 0;
+	u8* data = NULL;
+	for (uint i = 0; i < argc; i++)
+	{
+		if (!strings[i])
+			continue;
+
+		const char* s = strings[i];
+		u32 len = rec.args[i];
+		while (len)
+		{
+			if (pos % sizeof(Record) == 0)
+			{
+				data = (u8*)&ring.records[head++ % Ring::Size];
+				memset(data, 0, sizeof(Record));
+			}
+
+			u32 n = std::min<u32>(len, sizeof(Record) - pos % sizeof(Record));
+			memcpy(data + pos % sizeof(Record), s, n);
+			s += n;
+			len -= n;
+			pos += n;
+		}
+	}
+
+	ring.head.store(head, std::memory_order_release);
+}
+
+void BinaryTrace::Write(const void* source, const Prefix* prefix, const char* fmt, va_list list)
+{
+	if (s_closed.load(std::memory_order_relaxed))
+		return;
+
+	Ring& ring = *GetRing();
+	const FormatInfo& info = *GetFormat(fmt);
+
+	Record rec;
+	rec.type = Record_Entry;
+	rec.format = info.id;
+	rec.source = GetSource(source, prefix);
+	rec.flags = 0;
+	rec.pc = prefix ? prefix->pc : 0;
+	rec.cycle = prefix ? prefix->cycle : 0;
+	memset(rec.args, 0, sizeof(rec.args));
+
+	const char* strings[MaxArgs];
+
+	if (info.raw)
+	{
+		u32 bytes = 0;
+		for (uint i = 0; i < info.argc; i++)
+		{
+			strings[i] = NULL;
+			switch (info.types[i])
+			{
+				case Arg_Int32:  rec.args[i] = va_arg(list, u32); break;
+				case Arg_Int64:  rec.args[i] = va_arg(list, u64); break;
+				case Arg_Double:
+				{
+					double d = va_arg(list, double);
+					memcpy(&rec.args[i], &d, sizeof(d));
+					break;
+				}
+				case Arg_String:
+				{
+					const char* s = va_arg(list, const char*);
+					if (!s) s = "(null)";
+					strings[i] = s;
+					rec.args[i] = strnlen(s, MaxString);
+					bytes += rec.args[i];
+					break;
+				}
+			}
+		}
+
+		Push(ring, rec, strings, info.argc, bytes);
+	}
+	else
+	{
+		FastFormatAscii text;
+		text.WriteV(fmt, list);
+		strings[0] = text;
+		rec.args[0] = strnlen(text, MaxText);
+		Push(ring, rec, strings, 1, rec.args[0]);
+	}
+}
+
+void BinaryTrace::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_lock);
+		s_closed = true;
+		if (!s_writer.joinable())
+			return;
+		s_quit = true;
+	}
+
+	s_wake.notify_one();
+	s_writer.join();
+
+	if (s_file)
+	{
+		fclose(s_file);
+		s_file = NULL;
+	}
+}
@@ -0,0 +1,218 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2020  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Pcsx2Types.h"
+#include <cstdarg>
+#include <cstddef>
+
+// --------------------------------------------------------------------------------------
+//  BinaryTrace
+// --------------------------------------------------------------------------------------
+// Binary mode of the SysTrace logs (EmuConfig.Trace.Binary).  Instead of formatting the
+// message on the emulation thread, a trace write stores the format id, the cpu pc/cycle
+// and the raw printf arguments as fixed-size records in a ring owned by the calling thread.
+// A background thread appends the rings to emuLog.trace, and tools/tracedump renders that
+// file back into the text emuLog.txt would have had.
+//
+// This header is shared with tracedump, so it only depends on Pcsx2Types.h.
+//
+namespace BinaryTrace
+{
+	static const u32 FileMagic		= 0x43525450; // "PTRC"
+	static const u32 FileVersion	= 1;
+
+	static const uint MaxArgs		= 6;
+	static const uint MaxString		= 256;	// longest %s argument kept, in chars
+	static const uint MaxText		= 4096;	// longest pre-formatted message
+
+	struct FileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 recordSize;
+		u32 reserved;
+	};
+
+	enum RecordType
+	{
+		Record_Entry,		// one trace write; args[] hold the values, string lengths for %s
+		Record_Data,		// 64 raw bytes following an entry or definition (string contents)
+		Record_Format,		// defines format id 'format' as the text in the data records
+		Record_Source,		// defines source id 'source' as "name\0tag" in the data records
+		Record_Dropped,		// args[0] entries were dropped because the ring was full
+		Record_Thread,		// the following entries come from ring 'source'
+	};
+
+	// Format id 0 is always "%s": messages that can't be stored raw are formatted on the
+	// spot and written as a single string.  Source id 0 has no prefix (__Log).
+	static const u16 PreformattedId = 0;
+
+	struct Record
+	{
+		u16 type;
+		u16 format;
+		u16 source;
+		u8 extra;		// number of Record_Data following this one
+		u8 flags;		// Record_Source: the source prints a "name(pc cycle): " prefix
+		u32 pc;
+		u32 cycle;
+		u64 args[MaxArgs];
+	};
+
+	static_assert(sizeof(Record) == 64, "BinaryTrace records must stay 64 bytes");
+
+	enum ArgType
+	{
+		Arg_Int32,
+		Arg_Int64,
+		Arg_Double,
+		Arg_String,
+		Arg_Unsupported,
+	};
+
+	// One printf conversion: the flags/width/precision text (without the length modifier,
+	// which depends on the host's type sizes), the conversion char and the arguments it
+	// takes, '*' widths included.
+	struct Conversion
+	{
+		char spec[16];
+		char conv;
+		u8 count;
+		u8 types[3];
+	};
+
+	// Splits fmt into literal text and conversions, as printf would.  Returns false if it
+	// uses anything the binary format can't store (long doubles, wide strings, %n).
+	template< typename LiteralFn, typename ConversionFn >
+	bool ParseFormat(const char* fmt, const LiteralFn& literal, const ConversionFn& conversion)
+	{
+		const char* text = fmt;
+
+		while (*fmt)
+		{
+			if (*fmt != '%')
+			{
+				fmt++;
+				continue;
+			}
+
+			if (fmt[1] == '%')
+			{
+				literal(text, fmt + 1 - text);
+				fmt += 2;
+				text = fmt;
+				continue;
+			}
+
+			if (fmt > text)
+				literal(text, fmt - text);
+
+			Conversion c = {};
+			uint len = 0;
+			c.spec[len++] = *fmt++;
+
+			auto spec = [&](char ch) { if (len < sizeof(c.spec) - 1) c.spec[len++] = ch; };
+
+			while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' || *fmt == '0')
+				spec(*fmt++);
+
+			if (*fmt == '*') { spec(*fmt++); c.types[c.count++] = Arg_Int32; }
+			while (*fmt >= '0' && *fmt <= '9') spec(*fmt++);
+
+			if (*fmt == '.')
+			{
+				spec(*fmt++);
+				if (*fmt == '*') { spec(*fmt++); c.types[c.count++] = Arg_Int32; }
+				while (*fmt >= '0' && *fmt <= '9') spec(*fmt++);
+			}
+
+			// length modifiers, sized for the host doing the recording
+			uint size = 4;
+			bool wide = false;
+			switch (*fmt)
+			{
+				case 'h':
+					fmt += (fmt[1] == 'h') ? 2 : 1;
+					break;
+				case 'l':
+					if (fmt[1] == 'l') { size = 8; fmt += 2; }
+					else { size = sizeof(long); wide = true; fmt++; }
+					break;
+				case 'j': case 'q':
+					size = 8; fmt++;
+					break;
+				case 'z': case 't':
+					size = sizeof(size_t); fmt++;
+					break;
+				case 'I':
+					if (fmt[1] == '6' && fmt[2] == '4') { size = 8; fmt += 3; }
+					else { size = sizeof(size_t); fmt++; }
+					break;
+				case 'L':
+					return false;
+			}
+
+			c.conv = *fmt;
+			switch (*fmt)
+			{
+				case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+					c.types[c.count++] = (size == 8) ? Arg_Int64 : Arg_Int32;
+					break;
+				case 'c':
+					if (wide) return false;
+					c.types[c.count++] = Arg_Int32;
+					break;
+				case 'p':
+					c.types[c.count++] = (sizeof(void*) == 8) ? Arg_Int64 : Arg_Int32;
+					break;
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+					c.types[c.count++] = Arg_Double;
+					break;
+				case 's':
+					if (wide) return false;
+					c.types[c.count++] = Arg_String;
+					break;
+				default:
+					return false;
+			}
+
+			fmt++;
+			conversion(c);
+			text = fmt;
+		}
+
+		if (fmt > text)
+			literal(text, fmt - text);
+
+		return true;
+	}
+
+	// What the text log's prefix would print, for SysTraceLog::GetBinaryPrefix.
+	struct Prefix
+	{
+		const char* name;	// NULL if the source has no prefix
+		const char* tag;	// printed after the prefix
+		u32 pc;
+		u32 cycle;
+	};
+
+	// source identifies the trace log (any stable pointer), NULL for __Log.
+	extern void Write(const void* source, const Prefix* prefix, const char* fmt, va_list list);
+
+	// Drains what's left and closes the trace file.
+	extern void Shutdown();
+}
@@ -20,12 +20,14 @@
 #include <cstdio>
 #include "../R5900.h"
 #include "../System.h"
+#include "../System/SysThreads.h"
 
 std::vector<BreakPoint> CBreakPoints::breakPoints_;
 u32 CBreakPoints::breakSkipFirstAt_ = 0;
 u64 CBreakPoints::breakSkipFirstTicks_ = 0;
 std::vector<MemCheck> CBreakPoints::memChecks_;
 std::vector<MemCheck *> CBreakPoints::cleanupMemChecks_;
+std::set<u32> CBreakPoints::watchedPages_;
 bool CBreakPoints::breakpointTriggered_ = false;
 
 // called from the dynarec
@@ -59,6 +61,13 @@ MemCheck::MemCheck() :
 
 void MemCheck::Log(u32 addr, bool write, int size, u32 pc)
 {
+	if (result & MEMCHECK_LOG)
+	{
+		if (write)
+			DevCon.WriteLn("Hit store breakpoint @0x%x (pc 0x%x)", addr, pc);
+		else
+			DevCon.WriteLn("Hit load breakpoint @0x%x (pc 0x%x)", addr, pc);
+	}
 }
 
 void MemCheck::Action(u32 addr, bool write, int size, u32 pc)
@@ -279,8 +288,12 @@ BreakPointCond *CBreakPoints::GetBreakPointCondition(u32 addr)
 	return NULL;
 }
 
+// The watched pages read memChecks_ on the EE thread, so it may only change while
+// the cpu is paused.
 void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	bool resume = PauseForMemChecks();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -294,50 +307,93 @@ void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCh
 		check.result = result;
 
 		memChecks_.push_back(check);
-		Update();
 	}
 	else
 	{
 		memChecks_[mc].cond = (MemCheckCondition)(memChecks_[mc].cond | cond);
 		memChecks_[mc].result = (MemCheckResult)(memChecks_[mc].result | result);
-		Update();
 	}
+
+	UpdateMemChecks(resume);
 }
 
 void CBreakPoints::RemoveMemCheck(u32 start, u32 end)
 {
+	bool resume = PauseForMemChecks();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
 	size_t mc = FindMemCheck(start, end);
 	if (mc != INVALID_MEMCHECK)
-	{
 		memChecks_.erase(memChecks_.begin() + mc);
-		Update();
-	}
+
+	UpdateMemChecks(resume);
 }
 
 void CBreakPoints::ChangeMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	bool resume = PauseForMemChecks();
+
 	size_t mc = FindMemCheck(start, end);
 	if (mc != INVALID_MEMCHECK)
 	{
 		memChecks_[mc].cond = cond;
 		memChecks_[mc].result = result;
-		Update();
 	}
+
+	UpdateMemChecks(resume);
 }
 
 void CBreakPoints::ClearAllMemChecks()
 {
+	bool resume = PauseForMemChecks();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
+	memChecks_.clear();
 
-	if (!memChecks_.empty())
+	UpdateMemChecks(resume);
+}
+
+bool CBreakPoints::CheckMemChecks(u32 address, bool write, int size, u32 pc)
+{
+	// The debugger's own memory views read through the same pages.
+	if (!GetCoreThread().IsSelf())
+		return false;
+
+	u32 start = standardizeBreakpointAddress(address);
+	u32 end = start + size;
+	bool hit = false;
+
+	for (auto it = memChecks_.begin(); it != memChecks_.end(); ++it)
 	{
-		memChecks_.clear();
-		Update();
+		if (it->result == 0)
+			continue;
+
+		// logic: memAddress < bpEnd && bpStart < memAddress+memSize
+		if (start < standardizeBreakpointAddress(it->end) && standardizeBreakpointAddress(it->start) < end)
+		{
+			it->Action(address, write, size, pc);
+			if ((it->cond & (write ? MEMCHECK_WRITE : MEMCHECK_READ)) && (it->result & MEMCHECK_BREAK))
+				hit = true;
+		}
 	}
+
+	return hit;
+}
+
+void CBreakPoints::ExecMemCheck(u32 address, bool write, int size, u32 pc)
+{
+	if (!CheckMemChecks(address, write, size, pc))
+		return;
+
+	// The access can't be cancelled from a vtlb handler, so stop at the next event test,
+	// right after the block doing it.
+	SetBreakpointTriggered(true);
+	GetCoreThread().PauseSelfDebug();
+	eeMemCheckBreak = true;
+	cpuSetNextEventDelta(0);
 }
 
 void CBreakPoints::SetSkipFirst(u32 pc)
@@ -385,6 +441,77 @@ const std::vector<BreakPoint> CBreakPoints::GetBreakpoints()
 #include "App.h"
 #include "Debugger/DisassemblyDialog.h"
 
+bool CBreakPoints::PauseForMemChecks()
+{
+	if (r5900Debug.isCpuPaused())
+		return false;
+
+	r5900Debug.pauseCpu();
+	return true;
+}
+
+// Standardizing only changes the top nibble of an address, so a page is aliased by at most
+// one page in each 256MB segment.
+static bool WatchPageAliases(u32 page, bool watch)
+{
+	bool changed = false;
+	for (u32 segment = 0; segment < 16; segment++)
+	{
+		u32 vaddr = (segment << 28) | (page & 0x0FFFFFFF);
+		if (standardizeBreakpointAddress(vaddr) != page || watch == vtlb_IsWatched(vaddr))
+			continue;
+
+		if (watch)
+			vtlb_VMapWatch(vaddr, 0x1000);
+		else
+			vtlb_VMapUnwatch(vaddr, 0x1000);
+		changed = true;
+	}
+
+	return changed;
+}
+
+void CBreakPoints::UpdateMemChecks(bool resume)
+{
+	// Memchecks are standardized addresses, map them back to every virtual page aliasing them.
+	std::set<u32> watched;
+	for (auto it = memChecks_.begin(); it != memChecks_.end(); ++it)
+	{
+		u32 start = standardizeBreakpointAddress(it->start);
+		u32 end = standardizeBreakpointAddress(it->end);
+		if (it->result == 0 || end <= start)
+			continue;
+
+		for (u32 page = start >> 12; page <= (end - 1) >> 12; page++)
+			watched.insert(page << 12);
+	}
+
+	// Only the pages that stopped or started being watched need their mapping changed.
+	bool changed = false;
+	for (auto it = watchedPages_.begin(); it != watchedPages_.end(); ++it)
+	{
+		if (watched.find(*it) == watched.end())
+			changed |= WatchPageAliases(*it, false);
+	}
+	for (auto it = watched.begin(); it != watched.end(); ++it)
+	{
+		if (watchedPages_.find(*it) == watchedPages_.end())
+			changed |= WatchPageAliases(*it, true);
+	}
+	watchedPages_.swap(watched);
+
+	// Only blocks that resolved a constant address to a page whose mapping has just changed
+	// are stale, the same as after a TLB write.
+	if (changed)
+		SysClearExecutionCache();
+
+	if (resume)
+		r5900Debug.resumeCpu();
+	auto disassembly_window = wxGetApp().GetDisassemblyPtr();
+	if (disassembly_window)
+		disassembly_window->update();
+}
+
 void CBreakPoints::Update(u32 addr)
 {
 	bool resume = false;
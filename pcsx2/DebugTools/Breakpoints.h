@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <set>
 #include <vector>
 
 #include "DebugInterface.h"
@@ -107,7 +108,7 @@ struct MemCheck
 
 // BreakPoints cannot overlap, only one is allowed per address.
 // MemChecks can overlap, as long as their ends are different.
-// WARNING: MemChecks are not used in the interpreter or HLE currently.
+// MemChecks are checked by the vtlb on the pages they cover, so they break after the access.
 class CBreakPoints
 {
 public:
@@ -133,6 +134,11 @@ public:
 	static void ChangeMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result);
 	static void ClearAllMemChecks();
 
+	// Runs the memchecks covering an access and returns whether one of them breaks.
+	static bool CheckMemChecks(u32 address, bool write, int size, u32 pc);
+	// called from the vtlb handlers of watched pages when the recompiler is running
+	static void ExecMemCheck(u32 address, bool write, int size, u32 pc);
+
 	static void SetSkipFirst(u32 pc);
 	static u32 CheckSkipFirst(u32 pc);
 
@@ -153,6 +159,9 @@ private:
 	// Finds exactly, not using a range check.
 	static size_t FindMemCheck(u32 start, u32 end);
 
+	static bool PauseForMemChecks();
+	static void UpdateMemChecks(bool resume);
+
 	static std::vector<BreakPoint> breakPoints_;
 	static u32 breakSkipFirstAt_;
 	static u64 breakSkipFirstTicks_;
@@ -160,6 +169,8 @@ private:
 
 	static std::vector<MemCheck> memChecks_;
 	static std::vector<MemCheck *> cleanupMemChecks_;
+	// Standardized addresses of the pages the memchecks currently watch.
+	static std::set<u32> watchedPages_;
 };
 
 
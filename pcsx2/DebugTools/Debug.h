@@ -17,6 +17,7 @@
 
 #include "Utilities/TraceLog.h"
 #include "../Memory.h"
+#include "BinaryTrace.h"
 
 extern FILE *emuLog;
 extern wxString emuLogName;
@@ -71,11 +72,17 @@ public:
 	SysTraceLog( const SysTraceLogDescriptor* desc )
 		: TextFileTraceLog( &desc->base ) {}
 
+	// Hides TextFileTraceLog::Write, so that binary traces skip the formatting.
+	bool Write( const char* fmt, ... ) const;
+
 	void DoWrite( const char *fmt ) const override;
 	bool IsActive() const override
 	{
 		return EmuConfig.Trace.Enabled && Enabled;
 	}
+
+	// Binary trace counterpart of ApplyPrefix.
+	virtual void GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const {}
 };
 
 class SysTraceLog_EE : public SysTraceLog
@@ -86,6 +93,7 @@ public:
 	SysTraceLog_EE( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	void GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const override;
 	bool IsActive() const override
 	{
 		return SysTraceLog::IsActive() && EmuConfig.Trace.EE.m_EnableAll;
@@ -102,6 +110,7 @@ public:
 	SysTraceLog_VIFcode( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	void GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const override;
 };
 
 class SysTraceLog_EE_Disasm : public SysTraceLog_EE
@@ -158,6 +167,7 @@ public:
 	SysTraceLog_IOP( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	void GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const override;
 	bool IsActive() const override
 	{
 		return SysTraceLog::IsActive() && EmuConfig.Trace.IOP.m_EnableAll;
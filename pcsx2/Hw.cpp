@@ -55,6 +55,8 @@ void hwReset()
 {
 	hwInit();
 
+	// The IPU thread works on eeHw, let it finish first.
+	ipuWorkerSync();
 	memzero( eeHw );
 
 	psHu32(SBUS_F260) = 0x1D000060;
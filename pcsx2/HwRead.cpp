@@ -86,6 +86,7 @@ mem32_t __fastcall _hwRead32(u32 mem)
 
 			if (mem == INTC_STAT)
 			{
+				ipuWorkerSync();
 				if (intcstathack) IntCHackCheck();
 				return psHu32(INTC_STAT);
 			}
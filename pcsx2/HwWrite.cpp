@@ -141,11 +141,13 @@ void __fastcall _hwWrite32( u32 mem, u32 value )
 			switch( HELPSWITCH(mem) )
 			{
 				mcase(INTC_STAT):
+					ipuWorkerSync();
 					psHu32(INTC_STAT) &= ~value;
 					//cpuTestINTCInts();
 				return;
 
 				mcase(INTC_MASK):
+					ipuWorkerSync();
 					psHu32(INTC_MASK) ^= (u16)value;
 					cpuTestINTCInts();
 				return;
@@ -28,6 +28,10 @@
 #include "AppConfig.h"
 
 #include "Utilities/MemsetFast.inl"
+#include "Utilities/PersistentThread.h"
+
+#include <atomic>
+#include <thread>
 
 // the BP doesn't advance and returns -1 if there is no data to be read
 __aligned16 tIPU_cmd ipu_cmd;
@@ -43,7 +47,7 @@ void IPUWorker();
 //u8 PCT[] = {'r', 'I', 'P', 'B', 'D', '-', '-', '-'};		// unused?
 
 // Quantization matrix
-static rgb16_t vqclut[16];			//clut conversion table
+rgb16_t vqclut[16];					//clut conversion table
 static u8 s_thresh[2];				//thresholds for color conversions
 int coded_block_pattern = 0;
 
@@ -59,10 +63,168 @@ void tIPU_cmd::clear()
 	current = 0xffffffff;
 }
 
+// --------------------------------------------------------------------------------------
+//  IPU_Thread
+// --------------------------------------------------------------------------------------
+// Runs IPUWorker() off the EE thread.  IPUProcessInterrupt() hands the current command to
+// the worker and the EE keeps running until it next touches IPU state (IPU registers and
+// FIFOs, IPU DMA, INTC_STAT/INTC_MASK, the event test), where ipuWorkerSync() waits for
+// the worker.  The two things IPUWorker used to do to the EE directly -- request more
+// IPU1 DMA and raise INTC_IPU -- are recorded by the worker and replayed by the sync,
+// timed from the cycle the command was handed over on, so the EE sees them no later than
+// when the worker ran inline.
+
+#define IPU_THREAD_SYNC_MODE 0 // Runs IPUWorker() on the EE thread (debugging)
+
+class IPU_Thread : public pxThread
+{
+	// Note: keep atomics on separate cache lines to avoid CPU conflict
+	__aligned(64) std::atomic<u32> m_queued;   // Only modified by EE thread
+	__aligned(64) std::atomic<u32> m_done;     // Only modified by IPU thread
+	__aligned(64) std::atomic<bool> m_sleeping;
+	Semaphore m_sem;
+
+public:
+	IPU_Thread();
+	virtual ~IPU_Thread();
+
+	// Hands the current ipu_cmd to the thread, starting it on first use
+	void Run();
+
+	// Waits till the thread is done with the last command handed over
+	void Wait();
+
+protected:
+	void ExecuteTaskInThread();
+};
+
+static IPU_Thread ipuThread;
+
+bool ipuWorkerPending = false;          // EE thread: a command is out on ipuThread
+static u32 s_kickCycle = 0;             // EE cycle the pending command was handed over on
+static bool s_dmaWaiting = false;       // IPU1 DMA was stalled on an empty FIFO at handover
+static bool s_dmaRequested = false;     // worker: wants IPU1 DMA restarted
+static bool s_irqRaised = false;        // worker: command finished, raise INTC_IPU
+
+IPU_Thread::IPU_Thread()
+	: m_queued(0), m_done(0), m_sleeping(false)
+{
+	m_name = L"IPU";
+}
+
+IPU_Thread::~IPU_Thread()
+{
+	try {
+		pxThread::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void IPU_Thread::ExecuteTaskInThread()
+{
+	PCSX2_PAGEFAULT_PROTECT {
+		u32 done = m_done.load(std::memory_order_relaxed);
+		for (;;) {
+			// Commands arrive in bursts (one per DMA chunk while a stream plays), so
+			// spin for a bit before going to sleep.
+			for (int spin = 0; m_queued.load(std::memory_order_acquire) == done; ++spin) {
+				if (spin < 4096) {
+					_mm_pause();
+					continue;
+				}
+				m_sleeping.store(true);
+				if (m_queued.load() == done)
+					m_sem.WaitWithoutYield();
+				m_sleeping.store(false, std::memory_order_relaxed);
+				spin = 0;
+			}
+
+			IPUWorker();
+			m_done.store(++done, std::memory_order_release);
+		}
+	} PCSX2_PAGEFAULT_EXCEPT;
+}
+
+void IPU_Thread::Run()
+{
+	if (!IsRunning()) Start();
+
+	m_queued.store(m_queued.load(std::memory_order_relaxed) + 1);
+	if (m_sleeping.load()) m_sem.Post();
+}
+
+void IPU_Thread::Wait()
+{
+	const u32 queued = m_queued.load(std::memory_order_relaxed);
+	for (int spin = 0; m_done.load(std::memory_order_acquire) != queued; ++spin) {
+		if (spin < 1024)
+			_mm_pause();
+		else
+			std::this_thread::yield();
+	}
+}
+
+void ipuWorkerCancel()
+{
+	ipuThread.Cancel();
+}
+
+// Called by IPU_Fifo_Input::read (on the worker) when the input FIFO runs low.
+void ipuRequestInput()
+{
+	// IPU FIFO is empty and DMA is waiting so lets tell the DMA we are ready to put data in the FIFO
+	if (s_dmaWaiting)
+	{
+		s_dmaWaiting = false;
+		s_dmaRequested = true;
+	}
+}
+
 __fi void IPUProcessInterrupt()
 {
-	if (ipuRegs.ctrl.BUSY) // && (g_BP.FP || g_BP.IFC || (ipu1ch.chcr.STR && ipu1ch.qwc > 0)))
+	ipuWorkerSync();
+
+	if (!ipuRegs.ctrl.BUSY) // && (g_BP.FP || g_BP.IFC || (ipu1ch.chcr.STR && ipu1ch.qwc > 0)))
+		return;
+
+	s_kickCycle = cpuRegs.cycle;
+	s_dmaWaiting = cpuRegs.eCycle[DMAC_TO_IPU] == 0x9999;
+	s_dmaRequested = false;
+	s_irqRaised = false;
+	ipuWorkerPending = true;
+
+	// Make sure the event test comes around by the time either result could have been
+	// delivered; it syncs before doing anything else.
+	if (s_dmaWaiting)
+		cpuSetNextEvent(s_kickCycle, CHECK_EETIMINGHACK ? 8 : 32);
+	if (psHu32(INTC_MASK) & (1 << INTC_IPU))
+		cpuSetNextEventDelta(4);
+
+	if (IPU_THREAD_SYNC_MODE)
+	{
 		IPUWorker();
+		ipuWorkerSync();
+	}
+	else
+		ipuThread.Run();
+}
+
+void ipuWorkerSync()
+{
+	if (!ipuWorkerPending) return;
+
+	if (!IPU_THREAD_SYNC_MODE) ipuThread.Wait();
+	ipuWorkerPending = false;
+
+	if (s_dmaRequested)
+	{
+		CPU_INT(DMAC_TO_IPU, 32);
+		cpuRegs.sCycle[DMAC_TO_IPU] = s_kickCycle;
+		cpuSetNextEvent(s_kickCycle, cpuRegs.eCycle[DMAC_TO_IPU]);
+	}
+	if (s_irqRaised)
+		hwIntcIrq(INTC_IPU);
+
 	if (ipuRegs.ctrl.BUSY && ipuRegs.cmd.BUSY && ipuRegs.cmd.DATA == 0x000001B7) {
 		// 0x000001B7 is the MPEG2 sequence end code, signalling the end of a video.
 		// At the end of a video BUSY values should be automatically set to 0. 
@@ -104,6 +266,8 @@ void ReportIPU()
 
 void SaveStateBase::ipuFreeze()
 {
+	ipuWorkerSync();
+
 	// Get a report of the status of the ipu variables when saving and loading savestates.
 	//ReportIPU();
 	FreezeTag("IPU");
@@ -201,6 +365,7 @@ __fi u32 ipuRead32(u32 mem)
 	mem &= 0xff;	// ipu repeats every 0x100
 
 	IPUProcessInterrupt();
+	ipuWorkerSync();
 
 	switch (mem)
 	{
@@ -243,6 +408,7 @@ __fi u64 ipuRead64(u32 mem)
 	mem &= 0xff;	// ipu repeats every 0x100
 
 	IPUProcessInterrupt();
+	ipuWorkerSync();
 
 	switch (mem)
 	{
@@ -293,6 +459,8 @@ __fi bool ipuWrite32(u32 mem, u32 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipuWorkerSync();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD): // IPU_CMD
@@ -329,6 +497,8 @@ __fi bool ipuWrite64(u32 mem, u64 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipuWorkerSync();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD):
@@ -417,7 +587,7 @@ static __fi bool ipuVDEC(u32 val)
 			}
 			count = 0;
 		}
-		eecount_on_last_vdec = cpuRegs.cycle;
+		eecount_on_last_vdec = s_kickCycle;
 	}
 	switch (ipu_cmd.pos[0])
 	{
@@ -676,35 +846,6 @@ __fi void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
 	}
 }
 
-__fi void ipu_vq(macroblock_rgb16& rgb16, u8* indx4)
-{
-	const auto closest_index = [&](int i, int j) {
-		u8 index = 0;
-		int min_distance = std::numeric_limits<int>::max();
-		for (u8 k = 0; k < 16; ++k)
-		{
-			const int dr = rgb16.c[i][j].r - vqclut[k].r;
-			const int dg = rgb16.c[i][j].g - vqclut[k].g;
-			const int db = rgb16.c[i][j].b - vqclut[k].b;
-			const int distance = dr * dr + dg * dg + db * db;
-
-			// XXX: If two distances are the same which index is used?
-			if (min_distance > distance)
-			{
-				index = k;
-				min_distance = distance;
-			}
-		}
-
-		return index;
-	};
-
-	for (int i = 0; i < 16; ++i)
-		for (int j = 0; j < 8; ++j)
-			indx4[i * 8 + j] = closest_index(i, 2 * j + 1) << 4 | closest_index(i, 2 * j);
-}
-
-
 // --------------------------------------------------------------------------------------
 //  Buffer reader
 // --------------------------------------------------------------------------------------
@@ -834,7 +975,7 @@ u8 getBits8(u8 *address, bool advance)
 // --------------------------------------------------------------------------------------
 
 // When a command is written, we set some various busy flags and clear some other junk.
-// The actual decoding will be handled by IPUworker.
+// The actual decoding will be handled by IPUworker, on the IPU thread.
 __fi void IPUCMD_WRITE(u32 val)
 {
 	// don't process anything if currently busy
@@ -979,5 +1120,5 @@ __noinline void IPUWorker()
 	// success
 	ipuRegs.ctrl.BUSY = 0;
 	ipu_cmd.current = 0xffffffff;
-	hwIntcIrq(INTC_IPU);
+	s_irqRaised = true;
 }
@@ -295,6 +295,11 @@ extern void IPUCMD_WRITE(u32 val);
 extern void ipuSoftReset();
 extern void IPUProcessInterrupt();
 
+extern bool ipuWorkerPending;
+extern void ipuWorkerSync();
+extern void ipuWorkerCancel();
+extern void ipuRequestInput();
+
 extern u8 getBits128(u8 *address, bool advance);
 extern u8 getBits64(u8 *address, bool advance);
 extern u8 getBits32(u8 *address, bool advance);
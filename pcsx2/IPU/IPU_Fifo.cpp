@@ -87,11 +87,7 @@ int IPU_Fifo_Input::read(void *value)
 	// wait until enough data to ensure proper streaming.
 	if (g_BP.IFC < 3)
 	{
-		// IPU FIFO is empty and DMA is waiting so lets tell the DMA we are ready to put data in the FIFO
-		if(cpuRegs.eCycle[4] == 0x9999)
-		{
-			CPU_INT( DMAC_TO_IPU, 32 );
-		}
+		ipuRequestInput();
 
 		if (g_BP.IFC == 0) return 0;
 		pxAssert(g_BP.IFC > 0);
@@ -151,6 +147,8 @@ void IPU_Fifo_Output::read(void *value, uint size)
 
 void __fastcall ReadFIFO_IPUout(mem128_t* out)
 {
+	ipuWorkerSync();
+
 	if (!pxAssertDev( ipuRegs.ctrl.OFC > 0, "Attempted read from IPUout's FIFO, but the FIFO is empty!" )) return;
 	ipu_fifo.out.read(out, 1);
 
@@ -162,6 +160,8 @@ void __fastcall WriteFIFO_IPUin(const mem128_t* value)
 {
 	IPU_LOG( "WriteFIFO/IPUin <- %ls", WX_STR(value->ToString()) );
 
+	ipuWorkerSync();
+
 	//committing every 16 bytes
 	if( ipu_fifo.in.write((u32*)value, 1) == 0 )
 	{
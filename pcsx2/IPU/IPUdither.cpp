@@ -21,12 +21,14 @@
 #include "yuv2rgb.h"
 #include "mpeg2lib/Mpeg.h"
 
-void ipu_dither_reference(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16, int dte);
-void ipu_dither_sse2(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16, int dte);
+#include <limits>
 
 __ri void ipu_dither(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16, int dte)
 {
-    ipu_dither_sse2(rgb32, rgb16, dte);
+    if (x86caps.hasAVX2)
+        ipu_dither_avx2(rgb32, rgb16, dte);
+    else
+        ipu_dither_sse2(rgb32, rgb16, dte);
 }
 
 __ri void ipu_dither_reference(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16, int dte)
@@ -120,3 +122,146 @@ __ri void ipu_dither_sse2(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16
         }
     }
 }
+
+// Same as ipu_dither_sse2, with the two 8 pixel halves of a row handled in separate lanes.
+__avx2_target void ipu_dither_avx2(const macroblock_rgb32 &rgb32, macroblock_rgb16 &rgb16, int dte)
+{
+    const __m256i alpha_test = _mm256_set1_epi16(0x40);
+    const __m128i dither_add_matrix[] = {
+        _mm_setr_epi32(0x00000000, 0x00000000, 0x00000000, 0x00010101),
+        _mm_setr_epi32(0x00020202, 0x00000000, 0x00030303, 0x00000000),
+        _mm_setr_epi32(0x00000000, 0x00010101, 0x00000000, 0x00000000),
+        _mm_setr_epi32(0x00030303, 0x00000000, 0x00020202, 0x00000000),
+    };
+    const __m128i dither_sub_matrix[] = {
+        _mm_setr_epi32(0x00040404, 0x00000000, 0x00030303, 0x00000000),
+        _mm_setr_epi32(0x00000000, 0x00020202, 0x00000000, 0x00010101),
+        _mm_setr_epi32(0x00030303, 0x00000000, 0x00040404, 0x00000000),
+        _mm_setr_epi32(0x00000000, 0x00010101, 0x00000000, 0x00020202),
+    };
+    for (int i = 0; i < 16; ++i) {
+        const __m256i dither_add = _mm256_broadcastsi128_si256(dither_add_matrix[i & 3]);
+        const __m256i dither_sub = _mm256_broadcastsi128_si256(dither_sub_matrix[i & 3]);
+
+        const __m256i rgba_8_01234567 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&rgb32.c[i][0]));
+        const __m256i rgba_8_89abcdef = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&rgb32.c[i][8]));
+
+        // Pixels 0-3 / 8-11 and 4-7 / 12-15, so each lane matches one iteration of the SSE2 loop
+        __m256i rgba_8_0123 = _mm256_permute2x128_si256(rgba_8_01234567, rgba_8_89abcdef, 0x20);
+        __m256i rgba_8_4567 = _mm256_permute2x128_si256(rgba_8_01234567, rgba_8_89abcdef, 0x31);
+
+        // Dither and clamp
+        if (dte) {
+            rgba_8_0123 = _mm256_adds_epu8(rgba_8_0123, dither_add);
+            rgba_8_0123 = _mm256_subs_epu8(rgba_8_0123, dither_sub);
+            rgba_8_4567 = _mm256_adds_epu8(rgba_8_4567, dither_add);
+            rgba_8_4567 = _mm256_subs_epu8(rgba_8_4567, dither_sub);
+        }
+
+        // Split into channel components and extend to 16 bits
+        const __m256i rgba_16_0415 = _mm256_unpacklo_epi8(rgba_8_0123, rgba_8_4567);
+        const __m256i rgba_16_2637 = _mm256_unpackhi_epi8(rgba_8_0123, rgba_8_4567);
+        const __m256i rgba_32_0246 = _mm256_unpacklo_epi8(rgba_16_0415, rgba_16_2637);
+        const __m256i rgba_32_1357 = _mm256_unpackhi_epi8(rgba_16_0415, rgba_16_2637);
+        const __m256i rg_64_01234567 = _mm256_unpacklo_epi8(rgba_32_0246, rgba_32_1357);
+        const __m256i ba_64_01234567 = _mm256_unpackhi_epi8(rgba_32_0246, rgba_32_1357);
+
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i r = _mm256_unpacklo_epi8(rg_64_01234567, zero);
+        __m256i g = _mm256_unpackhi_epi8(rg_64_01234567, zero);
+        __m256i b = _mm256_unpacklo_epi8(ba_64_01234567, zero);
+        __m256i a = _mm256_unpackhi_epi8(ba_64_01234567, zero);
+
+        // Create RGBA
+        r = _mm256_srli_epi16(r, 3);
+        g = _mm256_slli_epi16(_mm256_srli_epi16(g, 3), 5);
+        b = _mm256_slli_epi16(_mm256_srli_epi16(b, 3), 10);
+        a = _mm256_slli_epi16(_mm256_cmpeq_epi16(a, alpha_test), 15);
+
+        const __m256i rgba16 = _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&rgb16.c[i][0]), rgba16);
+    }
+}
+
+__ri void ipu_vq_c(macroblock_rgb16& rgb16, u8* indx4)
+{
+    const auto closest_index = [&](int i, int j) {
+        u8 index = 0;
+        int min_distance = std::numeric_limits<int>::max();
+        for (u8 k = 0; k < 16; ++k)
+        {
+            const int dr = rgb16.c[i][j].r - vqclut[k].r;
+            const int dg = rgb16.c[i][j].g - vqclut[k].g;
+            const int db = rgb16.c[i][j].b - vqclut[k].b;
+            const int distance = dr * dr + dg * dg + db * db;
+
+            // XXX: If two distances are the same which index is used?
+            if (min_distance > distance)
+            {
+                index = k;
+                min_distance = distance;
+            }
+        }
+
+        return index;
+    };
+
+    for (int i = 0; i < 16; ++i)
+        for (int j = 0; j < 8; ++j)
+            indx4[i * 8 + j] = closest_index(i, 2 * j + 1) << 4 | closest_index(i, 2 * j);
+}
+
+// One row (16 pixels) at a time, searching all 16 CLUT entries in parallel per pixel.  The
+// largest possible distance (3 * 31 * 31) still fits in a signed 16-bit lane.
+__noinline __avx2_target void ipu_vq_avx2(macroblock_rgb16& rgb16, u8* indx4)
+{
+    __m256i clut_r[16], clut_g[16], clut_b[16];
+    for (int k = 0; k < 16; ++k)
+    {
+        clut_r[k] = _mm256_set1_epi16(vqclut[k].r);
+        clut_g[k] = _mm256_set1_epi16(vqclut[k].g);
+        clut_b[k] = _mm256_set1_epi16(vqclut[k].b);
+    }
+
+    const __m256i mask5 = _mm256_set1_epi16(0x1f);
+    const __m256i mask8 = _mm256_set1_epi32(0xff);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&rgb16.c[i][0]));
+        const __m256i r = _mm256_and_si256(c, mask5);
+        const __m256i g = _mm256_and_si256(_mm256_srli_epi16(c, 5), mask5);
+        const __m256i b = _mm256_and_si256(_mm256_srli_epi16(c, 10), mask5);
+
+        __m256i min_distance = _mm256_set1_epi16(0x7fff);
+        __m256i index = _mm256_setzero_si256();
+
+        for (int k = 0; k < 16; ++k)
+        {
+            const __m256i dr = _mm256_sub_epi16(r, clut_r[k]);
+            const __m256i dg = _mm256_sub_epi16(g, clut_g[k]);
+            const __m256i db = _mm256_sub_epi16(b, clut_b[k]);
+            const __m256i distance = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(dr, dr),
+                _mm256_mullo_epi16(dg, dg)), _mm256_mullo_epi16(db, db));
+
+            // Only a strictly smaller distance replaces the index, like the C version.
+            const __m256i closer = _mm256_cmpgt_epi16(min_distance, distance);
+            min_distance = _mm256_min_epi16(min_distance, distance);
+            index = _mm256_blendv_epi8(index, _mm256_set1_epi16(k), closer);
+        }
+
+        // Each 32-bit lane holds an even/odd pixel pair: fold the odd index into the upper nibble.
+        const __m256i pairs = _mm256_and_si256(_mm256_or_si256(index, _mm256_srli_epi32(index, 12)), mask8);
+        const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(pairs), _mm256_extracti128_si256(pairs, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&indx4[i * 8]), _mm_packus_epi16(words, words));
+    }
+}
+
+__ri void ipu_vq(macroblock_rgb16& rgb16, u8* indx4)
+{
+    if (x86caps.hasAVX2)
+        ipu_vq_avx2(rgb16, indx4);
+    else
+        ipu_vq_c(rgb16, indx4);
+}
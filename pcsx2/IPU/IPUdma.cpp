@@ -112,6 +112,8 @@ int IPU1dma()
 	int ipu1cycles = 0;
 	int totalqwc = 0;
 
+	ipuWorkerSync();
+
 	//We need to make sure GIF has flushed before sending IPU data, it seems to REALLY screw FFX videos
 
 	if(!ipu1ch.chcr.STR || IPU1Status.DMAMode == 2)
@@ -194,6 +196,8 @@ int IPU1dma()
 
 void IPU0dma()
 {
+	ipuWorkerSync();
+
 	if(!ipuRegs.ctrl.OFC) 
 	{
 		IPU_INT_FROM( 64 );
@@ -155,7 +155,7 @@ static __fi void idct_col (s16 * const block)
     block[8*7] = (a0 - b0) >> 17;
 }
 
-__ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
+__ri void idct_copy_c(s16 * block, u8 * dest, const int stride)
 {
     int i;
 
@@ -182,6 +182,188 @@ __ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
     } while (--i);
 }
 
+__ri void idct_add_c(s16 * block, s16 * dest, const int stride)
+{
+	int i;
+	for (i = 0; i < 8; i++)
+		idct_row (block + 8 * i);
+	for (i = 0; i < 8; i++)
+		idct_col (block + i);
+
+	__m128 zero = _mm_setzero_ps();
+	do {
+		_mm_store_ps((float*)dest, _mm_load_ps((float*)block));
+		_mm_store_ps((float*)block, zero);
+
+		dest += stride;
+		block += 8;
+	} while (--i);
+}
+
+// --------------------------------------------------------------------------------------
+//  AVX2 IDCT
+// --------------------------------------------------------------------------------------
+// Same arithmetic as idct_row/idct_col, but each pass handles all eight rows (or columns) at
+// once in 32-bit lanes.  The results are truncated back to s16 after each pass exactly like
+// the stores into block[] above, so the output is bit-identical to the C version (the final
+// clamp matches CLIP over the whole range clip_lut covers).
+
+static __fi __avx2_target void idct_transpose_avx2(__m256i (&v)[8])
+{
+	const __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+static __fi __avx2_target __m256i idct_trunc16_avx2(const __m256i v)
+{
+	return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+
+static __fi __avx2_target void BUTTERFLY_avx2(__m256i& t0, __m256i& t1, int w0, int w1, const __m256i d0, const __m256i d1)
+{
+	const __m256i tmp = _mm256_mullo_epi32(_mm256_set1_epi32(w0), _mm256_add_epi32(d0, d1));
+	t0 = _mm256_add_epi32(tmp, _mm256_mullo_epi32(_mm256_set1_epi32(w1 - w0), d1));
+	t1 = _mm256_sub_epi32(tmp, _mm256_mullo_epi32(_mm256_set1_epi32(w1 + w0), d0));
+}
+
+// col == false: idct_row on 8 rows (v[n] holds coefficient n of every row)
+// col == true : idct_col on 8 columns (v[n] holds row n of every column)
+template< bool col >
+static __fi __avx2_target void idct_pass_avx2(__m256i (&v)[8])
+{
+	static const int shift = col ? 17 : 8;
+	const __m256i c181 = _mm256_set1_epi32(181);
+
+	__m256i d0, d1, d2, d3;
+	__m256i a0, a1, a2, a3, b0, b1, b2, b3;
+	__m256i t0, t1, t2, t3;
+
+	d0 = _mm256_add_epi32(_mm256_slli_epi32(v[0], 11), _mm256_set1_epi32(col ? 65536 : 128));
+	d1 = v[1];
+	d2 = _mm256_slli_epi32(v[2], 11);
+	d3 = v[3];
+	t0 = _mm256_add_epi32(d0, d2);
+	t1 = _mm256_sub_epi32(d0, d2);
+	BUTTERFLY_avx2(t2, t3, W6, W2, d3, d1);
+	a0 = _mm256_add_epi32(t0, t2);
+	a1 = _mm256_add_epi32(t1, t3);
+	a2 = _mm256_sub_epi32(t1, t3);
+	a3 = _mm256_sub_epi32(t0, t2);
+
+	d0 = v[4];
+	d1 = v[5];
+	d2 = v[6];
+	d3 = v[7];
+	BUTTERFLY_avx2(t0, t1, W7, W1, d3, d0);
+	BUTTERFLY_avx2(t2, t3, W3, W5, d1, d2);
+	b0 = _mm256_add_epi32(t0, t2);
+	b3 = _mm256_add_epi32(t1, t3);
+	t0 = _mm256_sub_epi32(t0, t2);
+	t1 = _mm256_sub_epi32(t1, t3);
+	if (col)
+	{
+		t0 = _mm256_srai_epi32(t0, 8);
+		t1 = _mm256_srai_epi32(t1, 8);
+		b1 = _mm256_mullo_epi32(_mm256_add_epi32(t0, t1), c181);
+		b2 = _mm256_mullo_epi32(_mm256_sub_epi32(t0, t1), c181);
+	}
+	else
+	{
+		b1 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_add_epi32(t0, t1), c181), 8);
+		b2 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(t0, t1), c181), 8);
+	}
+
+	v[0] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_add_epi32(a0, b0), shift));
+	v[1] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_add_epi32(a1, b1), shift));
+	v[2] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_add_epi32(a2, b2), shift));
+	v[3] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_add_epi32(a3, b3), shift));
+	v[4] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_sub_epi32(a3, b3), shift));
+	v[5] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_sub_epi32(a2, b2), shift));
+	v[6] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_sub_epi32(a1, b1), shift));
+	v[7] = idct_trunc16_avx2(_mm256_srai_epi32(_mm256_sub_epi32(a0, b0), shift));
+}
+
+// Transforms the block and clears it.  rows[n] receives rows 2n and 2n+1 as packed s16.
+static __fi __avx2_target void idct_avx2(s16 * block, __m256i (&rows)[4])
+{
+	__m256i v[8];
+
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm256_cvtepi16_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(block + 8 * i)));
+
+	const __m256i zero = _mm256_setzero_si256();
+	for (int i = 0; i < 4; i++)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(block) + i, zero);
+
+	idct_transpose_avx2(v);
+	idct_pass_avx2<false>(v);
+	idct_transpose_avx2(v);
+	idct_pass_avx2<true>(v);
+
+	// Everything is already truncated to 16 bits, so the saturating pack is lossless.
+	for (int i = 0; i < 4; i++)
+		rows[i] = _mm256_permute4x64_epi64(_mm256_packs_epi32(v[i * 2], v[i * 2 + 1]), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+__noinline __avx2_target void idct_copy_avx2(s16 * block, u8 * dest, const int stride)
+{
+	__m256i rows[4];
+	idct_avx2(block, rows);
+
+	for (int i = 0; i < 4; i++)
+	{
+		const __m256i rgb8 = _mm256_packus_epi16(rows[i], rows[i]);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm256_castsi256_si128(rgb8));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dest + stride), _mm256_extracti128_si256(rgb8, 1));
+		dest += stride * 2;
+	}
+}
+
+__noinline __avx2_target void idct_add_avx2(s16 * block, s16 * dest, const int stride)
+{
+	__m256i rows[4];
+	idct_avx2(block, rows);
+
+	for (int i = 0; i < 4; i++)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(dest), _mm256_castsi256_si128(rows[i]));
+		_mm_store_si128(reinterpret_cast<__m128i*>(dest + stride), _mm256_extracti128_si256(rows[i], 1));
+		dest += stride * 2;
+	}
+}
+
+__ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
+{
+	if (x86caps.hasAVX2)
+		idct_copy_avx2(block, dest, stride);
+	else
+		idct_copy_c(block, dest, stride);
+}
+
 
 // stride = increment for dest in 16-bit units (typically either 8 [128 bits] or 16 [256 bits]).
 __ri void mpeg2_idct_add (const int last, s16 * block, s16 * dest, const int stride)
@@ -190,21 +372,10 @@ __ri void mpeg2_idct_add (const int last, s16 * block, s16 * dest, const int str
 
     if (last != 129 || (block[0] & 7) == 4)
     {
-		int i;
-		for (i = 0; i < 8; i++)
-			idct_row (block + 8 * i);
-		for (i = 0; i < 8; i++)
-			idct_col (block + i);
-
-		__m128 zero = _mm_setzero_ps();
-		do {
-			_mm_store_ps((float*)dest, _mm_load_ps((float*)block));
-			_mm_store_ps((float*)block, zero);
-
-			dest += stride;
-			block += 8;
-		} while (--i);
-
+		if (x86caps.hasAVX2)
+			idct_add_avx2(block, dest, stride);
+		else
+			idct_add_c(block, dest, stride);
     }
     else
     {
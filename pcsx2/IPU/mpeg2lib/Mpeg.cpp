@@ -29,6 +29,7 @@
 #include "PrecompiledHeader.h"
 
 #include "Common.h"
+#include "Utilities/MathUtils.h"
 #include "IPU/IPU.h"
 #include "Mpeg.h"
 #include "Vlc.h"
@@ -57,106 +58,111 @@ int bitstream_init ()
 	return g_BP.FillBuffer(32);
 }
 
+// Takes the next num bits after the first used bits of a 16-bit UBITS peek.
+static __fi u32 take_bits(u32 code, uint& used, uint num)
+{
+	const u32 ret = ((code << used) & 0xffff) >> (16 - num);
+	used += num;
+	return ret;
+}
+
+// macroblock_type plus the motion_type and dct_type fields after it are 9 bits at most, so
+// they're all decoded from a single peek and consumed with one DUMPBITS.
 int get_macroblock_modes()
 {
 	int macroblock_modes;
 	const MBtab * tab;
+	const u32 code = UBITS(16);
+	uint used;
 
 	switch (decoder.coding_type)
 	{
 		case I_TYPE:
-			macroblock_modes = UBITS(2);
+			if ((code >> 14) == 0) return 0;   // error
 
-			if (macroblock_modes == 0) return 0;   // error
-
-			tab = MB_I + (macroblock_modes >> 1);
-			DUMPBITS(tab->len);
+			tab = MB_I + (code >> 15);
+			used = tab->len;
 			macroblock_modes = tab->modes;
 
 			if ((!(decoder.frame_pred_frame_dct)) &&
 				(decoder.picture_structure == FRAME_PICTURE))
 			{
-				macroblock_modes |= GETBITS(1) * DCT_TYPE_INTERLACED;
+				macroblock_modes |= take_bits(code, used, 1) * DCT_TYPE_INTERLACED;
 			}
+
+			DUMPBITS(used);
 			return macroblock_modes;
 
 		case P_TYPE:
-			macroblock_modes = UBITS(6);
+			if ((code >> 10) == 0) return 0;   // error
 
-			if (macroblock_modes == 0) return 0;   // error
-
-			tab = MB_P + (macroblock_modes >> 1);
-			DUMPBITS(tab->len);
+			tab = MB_P + (code >> 11);
+			used = tab->len;
 			macroblock_modes = tab->modes;
 
 			if (decoder.picture_structure != FRAME_PICTURE)
 			{
 				if (macroblock_modes & MACROBLOCK_MOTION_FORWARD)
 				{
-					macroblock_modes |= GETBITS(2) * MOTION_TYPE_BASE;
+					macroblock_modes |= take_bits(code, used, 2) * MOTION_TYPE_BASE;
 				}
-
-				return macroblock_modes;
 			}
 			else if (decoder.frame_pred_frame_dct)
 			{
 				if (macroblock_modes & MACROBLOCK_MOTION_FORWARD)
 					macroblock_modes |= MC_FRAME;
-
-				return macroblock_modes;
 			}
 			else
 			{
 				if (macroblock_modes & MACROBLOCK_MOTION_FORWARD)
 				{
-					macroblock_modes |= GETBITS(2) * MOTION_TYPE_BASE;
+					macroblock_modes |= take_bits(code, used, 2) * MOTION_TYPE_BASE;
 				}
 
 				if (macroblock_modes & (MACROBLOCK_INTRA | MACROBLOCK_PATTERN))
 				{
-					macroblock_modes |= GETBITS(1) * DCT_TYPE_INTERLACED;
+					macroblock_modes |= take_bits(code, used, 1) * DCT_TYPE_INTERLACED;
 				}
-
-				return macroblock_modes;
 			}
 
-		case B_TYPE:
-			macroblock_modes = UBITS(6);
+			DUMPBITS(used);
+			return macroblock_modes;
 
-			if (macroblock_modes == 0) return 0;   // error
+		case B_TYPE:
+			if ((code >> 10) == 0) return 0;   // error
 
-			tab = MB_B + macroblock_modes;
-			DUMPBITS(tab->len);
+			tab = MB_B + (code >> 10);
+			used = tab->len;
 			macroblock_modes = tab->modes;
 
 			if (decoder.picture_structure != FRAME_PICTURE)
 			{
 				if (!(macroblock_modes & MACROBLOCK_INTRA))
 				{
-					macroblock_modes |= GETBITS(2) * MOTION_TYPE_BASE;
+					macroblock_modes |= take_bits(code, used, 2) * MOTION_TYPE_BASE;
 				}
-				return (macroblock_modes | (tab->len << 16));
 			}
 			else if (decoder.frame_pred_frame_dct)
 			{
 				/* if (! (macroblock_modes & MACROBLOCK_INTRA)) */
 				macroblock_modes |= MC_FRAME;
-				return (macroblock_modes | (tab->len << 16));
 			}
 			else
 			{
-				if (macroblock_modes & MACROBLOCK_INTRA) goto intra;
-
-				macroblock_modes |= GETBITS(2) * MOTION_TYPE_BASE;
+				if (!(macroblock_modes & MACROBLOCK_INTRA))
+				{
+					macroblock_modes |= take_bits(code, used, 2) * MOTION_TYPE_BASE;
+				}
 
 				if (macroblock_modes & (MACROBLOCK_INTRA | MACROBLOCK_PATTERN))
 				{
-intra:
-					macroblock_modes |= GETBITS(1) * DCT_TYPE_INTERLACED;
+					macroblock_modes |= take_bits(code, used, 1) * DCT_TYPE_INTERLACED;
 				}
-				return (macroblock_modes | (tab->len << 16));
 			}
 
+			DUMPBITS(used);
+			return (macroblock_modes | (tab->len << 16));
+
 		case D_TYPE:
 			macroblock_modes = GETBITS(1);
 			//I suspect (as this is actually a 2 bit command) that this should be getbits(2)
@@ -198,30 +204,20 @@ static __fi int get_coded_block_pattern()
 
 int __fi get_motion_delta(const int f_code)
 {
-	int delta;
-	int sign;
-	const MVtab * tab;
-	u16 code = UBITS(16);
+	// The longest motion code is 10 bits, so code and sign come from one 11-bit peek.
+	const u32 code = UBITS(11);
 
-	if ((code & 0x8000))
+	if (code & 0x400)
 	{
 		DUMPBITS(1);
 		return 0x00010000;
 	}
-	else if ((code & 0xf000) || ((code & 0xfc00) == 0x0c00))
-	{
-		tab = MV_4 + UBITS(4);
-	}
-	else
-	{
-		tab = MV_10 + UBITS(10);
-	}
 
-	delta = tab->delta + 1;
-	DUMPBITS(tab->len);
+	const MVtab * tab = MVlut.mv + (code >> 1);
+	const int delta = tab->delta + 1;
+	const int sign = -(int)((code >> (10 - tab->len)) & 1);
 
-	sign = SBITS(1);
-	DUMPBITS(1);
+	DUMPBITS(tab->len + 1);
 
 	return (((delta ^ sign) - sign) | (tab->len << 16));
 }
@@ -345,9 +341,9 @@ static bool get_intra_block()
 {
 	const u8 * scan = decoder.scantype ? mpeg2_scan.alt : mpeg2_scan.norm;
 	const u8 (&quant_matrix)[64] = decoder.iq;
+	const DCTtab * lut = (decoder.intra_vlc_format && !decoder.mpeg1) ? DCTlut.b15 : DCTlut.b14_next;
 	int quantizer_scale = decoder.quantizer_scale;
 	s16 * dest = decoder.DCTblock;
-	u16 code; 
 
 	/* decode AC coefficients */
   for (int i=1 + ipu_cmd.pos[4]; ; i++)
@@ -361,64 +357,79 @@ static bool get_intra_block()
 		  return false;
 		}
 
-		code = UBITS(16);
+		tab = DCT_LOOKUP(lut, UBITS(16));
 
-		if (code >= 16384 && (!decoder.intra_vlc_format || decoder.mpeg1))
+		if (tab->run == DCT_LUT_ERROR)
 		{
-		  tab = &DCT.next[(code >> 12) - 4];
+		  ipu_cmd.pos[4] = 0;
+		  return true;
 		}
-		else if (code >= 1024)
+
+		if (tab->run != 64 && HAVE32BITS())
 		{
-			if (decoder.intra_vlc_format && !decoder.mpeg1)
+			// Fast path: the whole coefficient (28 bits at most, for an MPEG-1 long escape)
+			// is already buffered, so decode it from a single peek and skip the resumable
+			// state below.
+			const u32 bits = PEEKBITS32();
+			uint used = tab->len;
+
+			if (tab->run == 65)
 			{
-				tab = &DCT.tab0a[(code >> 8) - 4];
+				i += (bits << used) >> 26;
+				used += 6;
 			}
 			else
+				i += tab->run;
+
+			if (i >= 64)
 			{
-				tab = &DCT.tab0[(code >> 8) - 4];
+				DUMPBITS(used);
+				ipu_cmd.pos[4] = 0;
+				return true;
 			}
-		}
-		else if (code >= 512)
-		{
-			if (decoder.intra_vlc_format && !decoder.mpeg1)
+
+			int val;
+
+			if (tab->run == 65) /* escape */
 			{
-				tab = &DCT.tab1a[(code >> 6) - 8];
+				if (!decoder.mpeg1)
+				{
+					val = (((s32)(bits << used) >> 20) * quantizer_scale * quant_matrix[i]) >> 4;
+					used += 12;
+				}
+				else
+				{
+					val = (s32)(bits << used) >> 24;
+					used += 8;
+
+					if (!(val & 0x7f))
+					{
+						val = (int)((bits << used) >> 24) + 2 * val;
+						used += 8;
+					}
+
+					val = (val * quantizer_scale * quant_matrix[i]) >> 4;
+					val = (val + ~ (((s32)val) >> 31)) | 1;
+				}
 			}
 			else
 			{
-				tab = &DCT.tab1[(code >> 6) - 8];
-			}
-		}
+				val = (tab->level * quantizer_scale * quant_matrix[i]) >> 4;
+				if (decoder.mpeg1)
+				{
+					/* oddification */
+					val = (val - 1) | 1;
+				}
 
-		// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-		// that should use a single unrolled DCT table instead of five separate tables used
-		// here.  Multiple conditional statements are very slow, while modern CPU data caches
-		// have lots of room to spare.
+				int bit1 = (s32)(bits << used) >> 31;
+				val = (val ^ bit1) - bit1;
+				used += 1;
+			}
 
-		else if (code >= 256)
-		{
-			tab = &DCT.tab2[(code >> 4) - 16];
-		}
-		else if (code >= 128)
-		{
-			tab = &DCT.tab3[(code >> 3) - 16];
-		}
-		else if (code >= 64)
-		{
-			tab = &DCT.tab4[(code >> 2) - 16];
-		}
-		else if (code >= 32)
-		{
-			tab = &DCT.tab5[(code >> 1) - 16];
-		}
-		else if (code >= 16)
-		{
-			tab = &DCT.tab6[code - 16];
-		}
-		else
-		{
-		  ipu_cmd.pos[4] = 0;
-		  return true;
+			DUMPBITS(used);
+			SATURATE(val);
+			dest[scan[i]] = val;
+			continue;
 		}
 
 		DUMPBITS(tab->len);
@@ -505,7 +516,6 @@ static bool get_non_intra_block(int * last)
 	const u8 (&quant_matrix)[64] = decoder.niq;
 	int quantizer_scale = decoder.quantizer_scale;
 	s16 * dest = decoder.DCTblock;
-	u16 code;
 
 	/* decode AC coefficients */
 	for (i= ipu_cmd.pos[4] ; ; i++)
@@ -519,57 +529,71 @@ static bool get_non_intra_block(int * last)
 				return false;
 			}
 
-			code = UBITS(16);
+			tab = DCT_LOOKUP((i == 0) ? DCTlut.b14_first : DCTlut.b14_next, UBITS(16));
 
-			if (code >= 16384)
+			if (tab->run == DCT_LUT_ERROR)
 			{
-				if (i==0)
+				ipu_cmd.pos[4] = 0;
+				return true;
+			}
+
+			if (tab->run != 64 && HAVE32BITS())
+			{
+				// Fast path, see get_intra_block.
+				const u32 bits = PEEKBITS32();
+				uint used = tab->len;
+
+				if (tab->run == 65)
 				{
-					tab = &DCT.first[(code >> 12) - 4];
+					i += (bits << used) >> 26;
+					used += 6;
 				}
 				else
-				{			
-					tab = &DCT.next[(code >> 12)- 4];
+					i += tab->run;
+
+				if (i >= 64)
+				{
+					DUMPBITS(used);
+					*last = i;
+					ipu_cmd.pos[4] = 0;
+					return true;
 				}
-			}
-			else if (code >= 1024)
-			{
-				tab = &DCT.tab0[(code >> 8) - 4];
-			}
-			else if (code >= 512)
-			{		
-				tab = &DCT.tab1[(code >> 6) - 8];
-			}
 
-			// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-			// that should use a single unrolled DCT table instead of five separate tables used
-			// here.  Multiple conditional statements are very slow, while modern CPU data caches
-			// have lots of room to spare.
+				if (tab->run == 65) /* escape */
+				{
+					if (!decoder.mpeg1)
+					{
+						const s32 level = (s32)(bits << used) >> 20;
+						val = ((2 * (level + (level >> 31)) + 1) * quantizer_scale * quant_matrix[i]) >> 5;
+						used += 12;
+					}
+					else
+					{
+						val = (s32)(bits << used) >> 24;
+						used += 8;
 
-			else if (code >= 256)
-			{		
-				tab = &DCT.tab2[(code >> 4) - 16];
-			}
-			else if (code >= 128)
-			{		
-				tab = &DCT.tab3[(code >> 3) - 16];
-			}
-			else if (code >= 64)
-			{		
-				tab = &DCT.tab4[(code >> 2) - 16];
-			}
-			else if (code >= 32)
-			{		
-				tab = &DCT.tab5[(code >> 1) - 16];
-			}
-			else if (code >= 16)
-			{		
-				tab = &DCT.tab6[code - 16];
-			}
-			else
-			{
-				ipu_cmd.pos[4] = 0;
-				return true;
+						if (!(val & 0x7f))
+						{
+							val = (int)((bits << used) >> 24) + 2 * val;
+							used += 8;
+						}
+
+						val = ((2 * (val + (((s32)val) >> 31)) + 1) * quantizer_scale * quant_matrix[i]) / 32;
+						val = (val + ~ (((s32)val) >> 31)) | 1;
+					}
+				}
+				else
+				{
+					int bit1 = (s32)(bits << used) >> 31;
+					val = ((2 * tab->level + 1) * quantizer_scale * quant_matrix[i]) >> 5;
+					val = (val ^ bit1) - bit1;
+					used += 1;
+				}
+
+				DUMPBITS(used);
+				SATURATE(val);
+				dest[scan[i]] = val;
+				continue;
 			}
 
 			DUMPBITS(tab->len);
@@ -739,8 +763,8 @@ __fi bool mpeg2sliceIDEC()
 				}
 
 				decoder.coded_block_pattern = 0x3F;//all 6 blocks
-				memzero_sse_a(mb8);
-				memzero_sse_a(rgb32);
+				// No need to clear mb8/rgb32 here: all six blocks are always coded for IDEC, so
+				// mpeg2_idct_copy rewrites the whole of mb8 and ipu_csc then rewrites all of rgb32.
 				// Fall through
 
 			case 1:
@@ -207,6 +207,17 @@ extern void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn);
 extern void ipu_dither(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte);
 extern void ipu_vq(macroblock_rgb16& rgb16, u8* indx4);
 
+// The kernels behind the dispatchers above, for tools/ipucheck.
+extern void idct_copy_c(s16 * block, u8 * dest, const int stride);
+extern void idct_copy_avx2(s16 * block, u8 * dest, const int stride);
+extern void idct_add_c(s16 * block, s16 * dest, const int stride);
+extern void idct_add_avx2(s16 * block, s16 * dest, const int stride);
+extern void ipu_dither_reference(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte);
+extern void ipu_dither_sse2(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte);
+extern void ipu_dither_avx2(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte);
+extern void ipu_vq_c(macroblock_rgb16& rgb16, u8* indx4);
+extern void ipu_vq_avx2(macroblock_rgb16& rgb16, u8* indx4);
+
 extern int slice (u8 * buffer);
 
 #ifdef _MSC_VER
@@ -229,4 +240,5 @@ extern const int non_linear_quantizer_scale[];
 
 extern __aligned16 tIPU_BP g_BP;
 extern __aligned16 decoder_t decoder;
+extern rgb16_t vqclut[16];
 
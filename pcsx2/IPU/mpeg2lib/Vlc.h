@@ -52,6 +52,23 @@ static __fi u32 GETBITS(uint num)
 	return retVal;
 }
 
+// True when at least 32 bits are already sitting in the internal buffer.  Only meaningful
+// right after GETWORD, which tops the buffer up from the FIFO as far as it can.
+static __fi bool HAVE32BITS()
+{
+	return g_BP.FP == 2 || (g_BP.FP == 1 && g_BP.BP + 32 <= 128);
+}
+
+// Returns the next 32 bits (MSB first) without advancing.  A single 64-bit load covers any
+// bit offset, and since BP is always below 128 the load never leaves internal_qwc.
+static __fi u32 PEEKBITS32()
+{
+	pxAssume(g_BP.BP < 128);
+
+	const u8* readpos = &g_BP.internal_qwc[0]._u8[g_BP.BP / 8];
+	return (u32)((BigEndian64(*(u64*)readpos) << (g_BP.BP & 7)) >> 32);
+}
+
 struct MBtab {
     u8 modes;
     u8 len;
@@ -158,6 +175,28 @@ static const __aligned16 MVtab MV_10 [] = {
 };
 
 
+// Flattened MV_4/MV_10, indexed by the first 10 bits of a motion code that starts with 0
+// (the 1-bit code for a zero delta is handled by the caller).  Invalid codes map to MV_10's
+// {0,10} entries as before.
+struct MVlutSet
+{
+	MVtab mv[512];
+
+	MVlutSet()
+	{
+		for (uint idx = 0; idx < 512; ++idx)
+		{
+			// same split as the old code: top 4 bits of the 10-bit code non-zero, or 000011
+			if (idx >= 64 || (idx >> 4) == 3)
+				mv[idx] = MV_4[idx >> 6];
+			else
+				mv[idx] = MV_10[idx];
+		}
+	}
+};
+
+static const MVlutSet MVlut;
+
 static const DMVtab DMV_2 [] = {
     { 0, 1}, { 0, 1}, { 1, 2}, {-1, 2}
 };
@@ -663,4 +702,70 @@ static const __aligned16 DCTtabSet DCT =
 
 };
 
+// --------------------------------------------------------------------------------------
+//  DCTlut - flattened DCT coefficient tables
+// --------------------------------------------------------------------------------------
+// The tables above are split by code length, which means a chain of range checks for every
+// coefficient.  DCTlut merges them into one table per VLC set, indexed through the number of
+// leading zeros of the next 16 bits, so a coefficient is resolved by a single lookup:
+//
+//   lz 0-5  : (code >> 8) - 4        [first/next/tab0 or tab0a]
+//   lz 6    : (code >> 6) - 8 + 252  [tab1 or tab1a]
+//   lz 7-11 : tab2 ... tab6
+//   lz 12+  : invalid code (run == DCT_LUT_ERROR, nothing gets consumed)
+
+static const u8 DCT_LUT_ERROR = 66;
+static const uint DCT_LUT_SIZE = 341;
+
+static const u8 dct_lut_shift[17] = {
+	8, 8, 8, 8, 8, 8, 6, 4, 3, 2, 1, 0, 16, 16, 16, 16, 16
+};
+
+static const s16 dct_lut_offset[17] = {
+	-4, -4, -4, -4, -4, -4, 252 - 8, 260 - 16, 276 - 16, 292 - 16, 308 - 16, 324 - 16,
+	340, 340, 340, 340, 340
+};
+
+struct DCTlutSet
+{
+	DCTtab b14_first[DCT_LUT_SIZE];	// Table B-14, first coefficient of non-intra blocks
+	DCTtab b14_next[DCT_LUT_SIZE];	// Table B-14, all other coefficients
+	DCTtab b15[DCT_LUT_SIZE];		// Table B-15 (intra_vlc_format)
+
+	DCTlutSet()
+	{
+		for (uint idx = 0; idx < 252; ++idx)
+		{
+			const uint code8 = idx + 4; // code >> 8
+
+			b14_first[idx] = (code8 >= 64) ? DCT.first[(code8 >> 4) - 4] : DCT.tab0[idx];
+			b14_next[idx] = (code8 >= 64) ? DCT.next[(code8 >> 4) - 4] : DCT.tab0[idx];
+			b15[idx] = DCT.tab0a[idx];
+		}
+
+		const DCTtab* const common[] = { DCT.tab2, DCT.tab3, DCT.tab4, DCT.tab5, DCT.tab6 };
+
+		for (uint idx = 0; idx < 8; ++idx)
+		{
+			b14_first[252 + idx] = b14_next[252 + idx] = DCT.tab1[idx];
+			b15[252 + idx] = DCT.tab1a[idx];
+		}
+
+		for (uint t = 0; t < 5; ++t)
+			for (uint idx = 0; idx < 16; ++idx)
+				b14_first[260 + t * 16 + idx] = b14_next[260 + t * 16 + idx] = b15[260 + t * 16 + idx] = common[t][idx];
+
+		const DCTtab error = { DCT_LUT_ERROR, 0, 0 };
+		b14_first[340] = b14_next[340] = b15[340] = error;
+	}
+};
+
+static const DCTlutSet DCTlut;
+
+static __fi const DCTtab* DCT_LOOKUP(const DCTtab* lut, u32 code)
+{
+	const int lz = count_leading_sign_bits(code) - 16;
+	return &lut[(code >> dct_lut_shift[lz]) + dct_lut_offset[lz]];
+}
+
 #endif//__VLC_H__
@@ -16,6 +16,13 @@
 #pragma once
 
 extern void yuv2rgb_reference();
-
-#define yuv2rgb yuv2rgb_sse2
 extern void yuv2rgb_sse2();
+extern void yuv2rgb_avx2();
+
+static __fi void yuv2rgb()
+{
+	if (x86caps.hasAVX2)
+		yuv2rgb_avx2();
+	else
+		yuv2rgb_sse2();
+}
@@ -64,64 +64,36 @@ void intBreakpoint(bool memcheck)
 	throw Exception::ExitCpuExecute();
 }
 
-void intMemcheck(u32 op, u32 bits, bool store)
-{
-	// compute accessed address
-	u32 start = cpuRegs.GPR.r[(op >> 21) & 0x1F].UD[0];
-	if ((s16)op != 0)
-		start += (s16)op;
-	if (bits == 128)
-		start &= ~0x0F;
-
-	start = standardizeBreakpointAddress(start);
-	u32 end = start + bits/8;
-	
-	auto checks = CBreakPoints::GetMemChecks();
-	for (size_t i = 0; i < checks.size(); i++)
-	{
-		auto& check = checks[i];
+// Called by the vtlb handlers of watched pages before the access is made, so a memcheck
+// stops on the instruction doing it.  Only the loads and stores of the current instruction
+// are checked, not the fetch of the next one or the accesses of patches.
+void intMemcheck(u32 addr, bool write, int size)
+{
+	u32 pc = cpuRegs.pc - 4;
+	if (!write && addr == pc)
+		return;
 
-		if (check.result == 0)
-			continue;
-		if ((check.cond & MEMCHECK_WRITE) == 0 && store)
-			continue;
-		if ((check.cond & MEMCHECK_READ) == 0 && !store)
-			continue;
+	const OPCODE& opcode = GetCurrentInstruction();
+	if (!(opcode.flags & IS_MEMORY))
+		return;
 
-		if (start < check.end && check.start < end)
-			intBreakpoint(true);
-	}
-}
+	u32 start = cpuRegs.GPR.r[_Rs_].UL[0] + _Imm_;
+	if ((start ^ addr) & ~0x0F)
+		return;
 
-void intCheckMemcheck()
-{
-	u32 pc = cpuRegs.pc;
-	int needed = isMemcheckNeeded(pc);
-	if (needed == 0)
+	// A delay slot is run again with its branch.
+	u32 breakPc = cpuRegs.branch ? pc - 4 : pc;
+	if (CBreakPoints::CheckSkipFirst(breakPc) != 0)
 		return;
 
-	u32 op = memRead32(needed == 2 ? pc+4 : pc);
-	const OPCODE& opcode = GetInstruction(op);
+	if (!CBreakPoints::CheckMemChecks(addr, write, size, pc))
+		return;
 
-	bool store = (opcode.flags & IS_STORE) != 0;
-	switch (opcode.flags & MEMTYPE_MASK)
-	{
-	case MEMTYPE_BYTE:
-		intMemcheck(op,8,store);
-		break;
-	case MEMTYPE_HALF:
-		intMemcheck(op,16,store);
-		break;
-	case MEMTYPE_WORD:
-		intMemcheck(op,32,store);
-		break;
-	case MEMTYPE_DWORD:
-		intMemcheck(op,64,store);
-		break;
-	case MEMTYPE_QWORD:
-		intMemcheck(op,128,store);
-		break;
-	}
+	cpuRegs.pc = breakPc;
+	cpuRegs.branch = 0;
+	CBreakPoints::SetBreakpointTriggered(true);
+	GetCoreThread().PauseSelfDebug();
+	throw Exception::ExitCpuExecute();
 }
 
 static void execI()
@@ -133,11 +105,9 @@ static void execI()
 	// not yet usable with the interpreter
 //#define EXTRA_DEBUG
 #ifdef EXTRA_DEBUG
-	// check if any breakpoints or memchecks are triggered by this instruction
+	// check if any breakpoints are triggered by this instruction
 	if (isBreakpointNeeded(cpuRegs.pc))
 		intBreakpoint(false);
-
-	intCheckMemcheck();
 #endif
 
 	u32 pc = cpuRegs.pc;
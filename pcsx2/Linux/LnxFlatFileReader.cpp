@@ -16,6 +16,485 @@
 #include "PrecompiledHeader.h"
 #include "AsyncFileReader.h"
 
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#ifndef IORING_FEAT_SINGLE_MMAP		// 5.4 headers
+#define IORING_FEAT_SINGLE_MMAP (1U << 0)
+#endif
+
+// --------------------------------------------------------------------------------------
+//  IoUringReader
+// --------------------------------------------------------------------------------------
+// io_uring backend of FlatFileReader, through the raw syscalls so there's no liburing
+// dependency.  A read that isn't buffered goes straight into the caller's buffer.  While
+// reads are sequential, the next ReadAheadSectors are read into registered buffers as well,
+// several requests in flight at once, so that the following BeginRead usually finds its data
+// already there or on its way.  This hides most of the latency of network storage, which
+// otherwise shows up as stutter in FMVs and streamed loads.
+//
+class IoUringReader
+{
+public:
+	static const uint ReadAheadSectors = 256;
+	static const uint SlotCount = 4;
+	static const uint SlotSize = 128 * 2448;	// InputIsoFile::MaxReadUnit sectors of the largest block size
+
+protected:
+	static const u64 DirectTag = SlotCount;
+
+	struct Slot
+	{
+		u8*		buffer;
+		u64		offset;
+		u32		length;
+		s32		result;		// bytes read, or -errno
+		bool	valid;		// holds (or will hold) the data at offset
+		bool	pending;	// the read is in flight
+		iovec	iov;		// for READV, when the buffers couldn't be registered
+	};
+
+	// Part of the current request served from a slot.
+	struct Piece
+	{
+		uint	slot;
+		u64		offset;
+		u8*		dest;
+		u32		length;
+	};
+
+	int m_fd;
+	int m_ring;
+	u64 m_fileSize;
+
+	void* m_sqPtr;
+	size_t m_sqSize;
+	void* m_cqPtr;
+	size_t m_cqSize;
+	io_uring_sqe* m_sqes;
+	size_t m_sqesSize;
+
+	u32* m_sqHead;
+	u32* m_sqTail;
+	u32* m_sqMask;
+	u32* m_sqArray;
+	u32* m_cqHead;
+	u32* m_cqTail;
+	u32* m_cqMask;
+	io_uring_cqe* m_cqes;
+	uint m_toSubmit;
+
+	u8* m_buffers;
+	bool m_fixed;			// buffers are registered, slots use READ_FIXED
+	Slot m_slots[SlotCount];
+
+	// current request
+	bool m_direct;
+	bool m_directPending;
+	s32 m_directResult;
+	iovec m_directIov;
+	u8* m_dest;
+	u64 m_offset;
+	u32 m_length;
+	Piece m_pieces[SlotCount];
+	uint m_numPieces;
+
+	u64 m_lastEnd;			// end of the previous request, to spot sequential reads
+
+public:
+	IoUringReader();
+	~IoUringReader();
+
+	bool Open(int fd);
+	void Close();
+
+	void BeginRead(void* pBuffer, u64 offset, u32 length, uint blocksize);
+	int FinishRead();
+	void CancelRead();
+
+protected:
+	void Submit();
+	void Reap();
+	void Wait(bool& pending);
+
+	void QueueRead(u64 tag, u8* buffer, u64 offset, u32 length);
+	bool PlanFromSlots();
+	void QueueReadAhead(u64 start, u64 end);
+};
+
+IoUringReader::IoUringReader()
+{
+	m_fd = -1;
+	m_ring = -1;
+	m_fileSize = 0;
+	m_sqPtr = m_cqPtr = MAP_FAILED;
+	m_sqSize = m_cqSize = 0;
+	m_sqes = (io_uring_sqe*)MAP_FAILED;
+	m_sqesSize = 0;
+	m_toSubmit = 0;
+	m_buffers = NULL;
+	m_fixed = false;
+	memzero(m_slots);
+	m_direct = false;
+	m_directPending = false;
+	m_directResult = 0;
+	m_numPieces = 0;
+	m_lastEnd = 0;
+}
+
+IoUringReader::~IoUringReader()
+{
+	Close();
+}
+
+bool IoUringReader::Open(int fd)
+{
+	io_uring_params params;
+	memzero(params);
+
+	m_ring = syscall(__NR_io_uring_setup, 8, &params);
+	if (m_ring < 0)
+		return false;
+
+	m_sqSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+	m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+
+	m_sqPtr = mmap(NULL, m_sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+	if (m_sqPtr == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		m_cqPtr = m_sqPtr;
+	else
+		m_cqPtr = mmap(NULL, m_cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+
+	m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	m_sqes = (io_uring_sqe*)mmap(NULL, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+
+	if (m_cqPtr == MAP_FAILED || m_sqes == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	u8* sq = (u8*)m_sqPtr;
+	m_sqHead	= (u32*)(sq + params.sq_off.head);
+	m_sqTail	= (u32*)(sq + params.sq_off.tail);
+	m_sqMask	= (u32*)(sq + params.sq_off.ring_mask);
+	m_sqArray	= (u32*)(sq + params.sq_off.array);
+
+	u8* cq = (u8*)m_cqPtr;
+	m_cqHead	= (u32*)(cq + params.cq_off.head);
+	m_cqTail	= (u32*)(cq + params.cq_off.tail);
+	m_cqMask	= (u32*)(cq + params.cq_off.ring_mask);
+	m_cqes		= (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	m_buffers = (u8*)_aligned_malloc(SlotCount * SlotSize, 4096);
+	if (!m_buffers)
+	{
+		Close();
+		return false;
+	}
+
+	iovec iovs[SlotCount];
+	for (uint i = 0; i < SlotCount; i++)
+	{
+		m_slots[i].buffer = m_buffers + i * SlotSize;
+		iovs[i].iov_base = m_slots[i].buffer;
+		iovs[i].iov_len = SlotSize;
+	}
+
+	// Needs RLIMIT_MEMLOCK room for the buffers, plain reads do otherwise.
+	m_fixed = syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_BUFFERS, iovs, SlotCount) == 0;
+	if (!m_fixed)
+		DevCon.Warning("(FlatFileReader) Can't register io_uring buffers (errno %d)", errno);
+
+	struct stat st;
+	m_fileSize = (fstat(fd, &st) == 0) ? st.st_size : 0;
+	m_fd = fd;
+	return true;
+}
+
+void IoUringReader::Close()
+{
+	// The kernel may still be writing to the buffers.
+	if (m_ring >= 0 && m_sqes != MAP_FAILED)
+	{
+		CancelRead();
+		for (Slot& slot : m_slots)
+			Wait(slot.pending);
+	}
+
+	if (m_sqes != MAP_FAILED)
+		munmap(m_sqes, m_sqesSize);
+	if (m_cqPtr != MAP_FAILED && m_cqPtr != m_sqPtr)
+		munmap(m_cqPtr, m_cqSize);
+	if (m_sqPtr != MAP_FAILED)
+		munmap(m_sqPtr, m_sqSize);
+	if (m_ring >= 0)
+		close(m_ring);
+
+	safe_aligned_free(m_buffers);
+
+	m_sqPtr = m_cqPtr = MAP_FAILED;
+	m_sqes = (io_uring_sqe*)MAP_FAILED;
+	m_ring = -1;
+	m_fd = -1;
+	memzero(m_slots);
+}
+
+void IoUringReader::Submit()
+{
+	while (m_toSubmit)
+	{
+		int ret = syscall(__NR_io_uring_enter, m_ring, m_toSubmit, 0, 0, NULL, 0);
+		if (ret >= 0)
+			m_toSubmit -= std::min<uint>(ret, m_toSubmit);
+		else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			Console.Error("(FlatFileReader) io_uring submit failed (errno %d)", errno);
+			break;
+		}
+	}
+}
+
+void IoUringReader::Reap()
+{
+	u32 head = *m_cqHead;
+	const u32 tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; head++)
+	{
+		const io_uring_cqe& cqe = m_cqes[head & *m_cqMask];
+
+		if (cqe.user_data == DirectTag)
+		{
+			m_directResult = cqe.res;
+			m_directPending = false;
+		}
+		else
+		{
+			Slot& slot = m_slots[cqe.user_data];
+			slot.result = cqe.res;
+			slot.pending = false;
+			if (cqe.res < 0)
+				slot.valid = false;
+		}
+	}
+
+	__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+}
+
+void IoUringReader::Wait(bool& pending)
+{
+	Submit();
+	Reap();
+
+	while (pending)
+	{
+		int ret = syscall(__NR_io_uring_enter, m_ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			Console.Error("(FlatFileReader) io_uring wait failed (errno %d)", errno);
+			break;
+		}
+		Reap();
+	}
+}
+
+void IoUringReader::QueueRead(u64 tag, u8* buffer, u64 offset, u32 length)
+{
+	// At most SlotCount + 1 reads are in flight, the ring has room for all of them.
+	const u32 tail = *m_sqTail;
+	const u32 index = tail & *m_sqMask;
+
+	io_uring_sqe* sqe = &m_sqes[index];
+	memzero(*sqe);
+	sqe->fd = m_fd;
+	sqe->off = offset;
+	sqe->user_data = tag;
+
+	if (tag != DirectTag && m_fixed)
+	{
+		sqe->opcode = IORING_OP_READ_FIXED;
+		sqe->addr = (u64)(uptr)buffer;
+		sqe->len = length;
+		sqe->buf_index = tag;
+	}
+	else
+	{
+		iovec& iov = (tag == DirectTag) ? m_directIov : m_slots[tag].iov;
+		iov.iov_base = buffer;
+		iov.iov_len = length;
+
+		sqe->opcode = IORING_OP_READV;
+		sqe->addr = (u64)(uptr)&iov;
+		sqe->len = 1;
+	}
+
+	m_sqArray[index] = index;
+	__atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+	m_toSubmit++;
+}
+
+// Splits the current request over the slots holding it, if they hold all of it.
+bool IoUringReader::PlanFromSlots()
+{
+	m_numPieces = 0;
+
+	u64 pos = m_offset;
+	const u64 end = m_offset + m_length;
+	while (pos < end)
+	{
+		uint i = 0;
+		for (; i < SlotCount; i++)
+		{
+			const Slot& slot = m_slots[i];
+			if (!slot.valid || pos < slot.offset || pos >= slot.offset + slot.length)
+				continue;
+			if (!slot.pending && pos >= slot.offset + slot.result)
+				continue;
+			break;
+		}
+
+		if (i == SlotCount || m_numPieces == SlotCount)
+			return false;
+
+		const Slot& slot = m_slots[i];
+		Piece& piece = m_pieces[m_numPieces++];
+		piece.slot = i;
+		piece.offset = pos;
+		piece.dest = m_dest + (pos - m_offset);
+		piece.length = std::min<u64>(end, slot.offset + slot.length) - pos;
+		pos += piece.length;
+	}
+
+	return true;
+}
+
+// Makes sure [start, end) is read or being read, in free slots.
+void IoUringReader::QueueReadAhead(u64 start, u64 end)
+{
+	end = std::min(end, m_fileSize);
+
+	u64 pos = start;
+	while (pos < end)
+	{
+		Slot* found = NULL;
+		Slot* free = NULL;
+		for (Slot& slot : m_slots)
+		{
+			if (slot.valid && pos >= slot.offset && pos < slot.offset + slot.length)
+				found = &slot;
+			else if (!slot.pending && (!slot.valid || slot.offset + slot.length <= m_offset || slot.offset >= end))
+				free = &slot;
+		}
+
+		if (found)
+		{
+			// a short read only happens at the end of the file
+			if (!found->pending && found->result < (s32)found->length)
+				break;
+			pos = found->offset + found->length;
+			continue;
+		}
+
+		if (!free)
+			break;
+
+		free->offset = pos;
+		free->length = std::min<u64>(end - pos, SlotSize);
+		free->result = 0;
+		free->valid = true;
+		free->pending = true;
+
+		QueueRead(free - m_slots, free->buffer, free->offset, free->length);
+		pos += free->length;
+	}
+}
+
+void IoUringReader::BeginRead(void* pBuffer, u64 offset, u32 length, uint blocksize)
+{
+	CancelRead();
+
+	m_dest = (u8*)pBuffer;
+	m_offset = offset;
+	m_length = length;
+
+	const bool sequential = (offset == m_lastEnd);
+	m_lastEnd = offset + length;
+
+	m_direct = !PlanFromSlots();
+	if (m_direct)
+	{
+		m_directPending = true;
+		m_directResult = 0;
+		QueueRead(DirectTag, m_dest, offset, length);
+	}
+
+	if (sequential || !m_direct)
+		QueueReadAhead(m_lastEnd, m_lastEnd + (u64)ReadAheadSectors * blocksize);
+
+	Submit();
+}
+
+int IoUringReader::FinishRead()
+{
+	if (m_direct)
+	{
+		Wait(m_directPending);
+		m_direct = false;
+		return (m_directResult < 0) ? -1 : m_directResult;
+	}
+
+	u32 copied = 0;
+	for (uint i = 0; i < m_numPieces; i++)
+	{
+		const Piece& piece = m_pieces[i];
+		Slot& slot = m_slots[piece.slot];
+		Wait(slot.pending);
+
+		const s64 avail = slot.valid ? (s64)slot.offset + slot.result - (s64)piece.offset : 0;
+		const u32 len = (u32)std::max<s64>(0, std::min<s64>(avail, piece.length));
+		memcpy(piece.dest, slot.buffer + (piece.offset - slot.offset), len);
+		copied += len;
+
+		if (len < piece.length)
+		{
+			// the read ahead failed, read the rest directly
+			ssize_t ret = pread(m_fd, m_dest + copied, m_length - copied, m_offset + copied);
+			if (ret < 0)
+				return -1;
+			copied += ret;
+			break;
+		}
+	}
+
+	m_numPieces = 0;
+	return copied;
+}
+
+void IoUringReader::CancelRead()
+{
+	// Reads of regular files can't really be cancelled, but the caller may reuse its buffer
+	// as soon as this returns.
+	if (m_direct)
+	{
+		Wait(m_directPending);
+		m_direct = false;
+	}
+	m_numPieces = 0;
+}
+#endif
+
 FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
 {
 	m_blocksize = 2048;
@@ -32,12 +511,26 @@ bool FlatFileReader::Open(const wxString& fileName)
 {
 	m_filename = fileName;
 
-	int err = io_setup(64, &m_aio_context);
-	if (err) return false;
+	m_fd = wxOpen(fileName, O_RDONLY, 0);
+	if (m_fd == -1) return false;
 
-    m_fd = wxOpen(fileName, O_RDONLY, 0);
+#ifdef HAVE_IO_URING
+	m_uring = std::make_unique<IoUringReader>();
+	if (m_uring->Open(m_fd))
+		return true;
 
-	return (m_fd != -1);
+	DevCon.Warning("(FlatFileReader) io_uring isn't available (errno %d), using aio", errno);
+	m_uring = nullptr;
+#endif
+
+	int err = io_setup(64, &m_aio_context);
+	if (err)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
 }
 
 int FlatFileReader::ReadSync(void* pBuffer, uint sector, uint count)
@@ -53,6 +546,14 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 	u32 bytesToRead = count * m_blocksize;
 
+#ifdef HAVE_IO_URING
+	if (m_uring)
+	{
+		m_uring->BeginRead(pBuffer, offset, bytesToRead, m_blocksize);
+		return;
+	}
+#endif
+
 	struct iocb iocb;
 	struct iocb* iocbs = &iocb;
 
@@ -62,6 +563,11 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
+#ifdef HAVE_IO_URING
+	if (m_uring)
+		return m_uring->FinishRead();
+#endif
+
 	int min_nr = 1;
 	int max_nr = 1;
 	struct io_event events[max_nr];
@@ -76,6 +582,14 @@ int FlatFileReader::FinishRead(void)
 
 void FlatFileReader::CancelRead(void)
 {
+#ifdef HAVE_IO_URING
+	if (m_uring)
+	{
+		m_uring->CancelRead();
+		return;
+	}
+#endif
+
 	// Will be done when m_aio_context context is destroyed
 	// Note: io_cancel exists but need the iocb structure as parameter
 	// int io_cancel(aio_context_t ctx_id, struct iocb *iocb,
@@ -84,10 +598,13 @@ void FlatFileReader::CancelRead(void)
 
 void FlatFileReader::Close(void)
 {
+#ifdef HAVE_IO_URING
+	m_uring = nullptr;
+#endif
 
 	if (m_fd != -1) close(m_fd);
 
-	io_destroy(m_aio_context);
+	if (m_aio_context) io_destroy(m_aio_context);
 
 	m_fd = -1;
 	m_aio_context = 0;
@@ -27,6 +27,7 @@ void TraceLogFilters::LoadSave( IniInterface& ini )
 	ScopedIniGroup path( ini, L"TraceLog" );
 
 	IniEntry( Enabled );
+	IniEntry( Binary );
 	
 	// Retaining backwards compat of the trace log enablers isn't really important, and
 	// doing each one by hand would be murder.  So let's cheat and just save it as an int:
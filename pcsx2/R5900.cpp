@@ -55,6 +55,8 @@ bool g_GameLoading; // EELOAD has been called to load the game
 static const uint eeWaitCycles = 3072;
 
 bool eeEventTestIsActive = false;
+bool eeMemCheckBreak = false;
+u32 eeMemCheckPC = 0;	// pc of the last load or store run by the recompiler, when memchecks are set
 
 u32 g_eeloadMain = 0, g_eeloadExec = 0, g_osdsys_str = 0;
 
@@ -89,6 +91,7 @@ void cpuReset()
 	fpuRegs.fprc[31]		= 0x01000001; // fpu Status/Control
 
 	g_nextEventCycle = cpuRegs.cycle + 4;
+	eeMemCheckBreak = false;
 	EEsCycle = 0;
 	EEoCycle = cpuRegs.cycle;
 
@@ -367,6 +370,9 @@ u32 g_nextEventCycle = 0;
 // and the recompiler.  (moved here to help alleviate redundant code)
 __fi void _cpuEventTest_Shared()
 {
+	// Deliver whatever the IPU thread raised since it was handed its command.
+	ipuWorkerSync();
+
 	ScopedBool etest(eeEventTestIsActive);
 	g_nextEventCycle = cpuRegs.cycle + eeWaitCycles;
 
@@ -456,10 +462,22 @@ __fi void _cpuEventTest_Shared()
 
 	// Apply vsync and other counter nextCycles
 	cpuSetNextEvent( nextsCounter, nextCounter );
+
+	// ---- Debugger memchecks -------------
+	// A memcheck hit has already requested the pause; act on it now rather than waiting
+	// for the next vsync to check the execution state.
+
+	if( eeMemCheckBreak )
+	{
+		eeMemCheckBreak = false;
+		Cpu->CheckExecutionState();
+	}
 }
 
 __ri void cpuTestINTCInts()
 {
+	ipuWorkerSync();
+
 	// Check the COP0's Status register for general interrupt disables, and the 0x400
 	// bit (which is INTC master toggle).
 	if( !cpuIntsEnabled(0x400) ) return;
@@ -759,9 +777,8 @@ inline bool isBranchOrJump(u32 addr)
 	return (opcode.flags & IS_BRANCH) != 0;
 }
 
-// The next two functions return 0 if no breakpoint is needed,
-// 1 if it's needed on the current pc, 2 if it's needed in the delay slot
-// 3 if needed in both
+// Returns 0 if no breakpoint is needed, 1 if it's needed on the current pc,
+// 2 if it's needed in the delay slot, 3 if needed in both
 
 int isBreakpointNeeded(u32 addr)
 {
@@ -775,21 +792,3 @@ int isBreakpointNeeded(u32 addr)
 
 	return bpFlags;
 }
-
-int isMemcheckNeeded(u32 pc)
-{
-	if (CBreakPoints::GetNumMemchecks() == 0)
-		return 0;
-	
-	u32 addr = pc;
-	if (isBranchOrJump(addr))
-		addr += 4;
-
-	u32 op = memRead32(addr);
-	const OPCODE& opcode = GetInstruction(op);
-
-	if (opcode.flags & IS_MEMORY)
-		return addr == pc ? 1 : 2;
-
-	return 0;
-}
@@ -259,10 +259,13 @@ extern __aligned16 tlbs tlb[48];
 
 extern u32 g_nextEventCycle;
 extern bool eeEventTestIsActive;
+extern bool eeMemCheckBreak;
+extern u32 eeMemCheckPC;
 extern u32 s_iLastCOP0Cycle;
 extern u32 s_iLastPERFCycle[2];
 
 void intSetBranch();
+void intMemcheck(u32 addr, bool write, int size);
 
 // This is a special form of the interpreter's doBranch that is run from various
 // parts of the Recs (namely COP0's branch codes and stuff).
@@ -453,7 +456,6 @@ extern void cpuTestDMACInts();
 extern void cpuTestTIMRInts();
 
 // breakpoint code shared between interpreter and recompiler
-int isMemcheckNeeded(u32 pc);
 int isBreakpointNeeded(u32 addr);
 
 ////////////////////////////////////////////////////////////////////
@@ -38,6 +38,37 @@ long InputRecordingFile::GetBlockSeekPoint(const long & frame)
 	}
 }
 
+u8* InputRecordingFile::GetFrameBlock(unsigned long frame)
+{
+	if ((frame + 1) * RecordingBlockSize > padData.size())
+	{
+		return NULL;
+	}
+	return &padData[frame * RecordingBlockSize];
+}
+
+void InputRecordingFile::ReserveFrames(unsigned long frames)
+{
+	if (padData.size() < frames * RecordingBlockSize)
+	{
+		padData.resize(frames * RecordingBlockSize, 0);
+	}
+}
+
+void InputRecordingFile::SetFramesDirty(unsigned long start, unsigned long end)
+{
+	if (dirtyStart == dirtyEnd)
+	{
+		dirtyStart = start;
+		dirtyEnd = end;
+	}
+	else
+	{
+		dirtyStart = std::min(dirtyStart, start);
+		dirtyEnd = std::max(dirtyEnd, end);
+	}
+}
+
 // Inits the new (or existing) input recording file
 bool InputRecordingFile::Open(const wxString path, bool fNewOpen, bool fromSaveState)
 {
@@ -57,6 +88,11 @@ bool InputRecordingFile::Open(const wxString path, bool fNewOpen, bool fromSaveS
 		return false;
 	}
 	filename = path;
+	padData.clear();
+	dirtyStart = dirtyEnd = 0;
+	headerDirty = false;
+	lastWriteFrame = 0;
+	framesSinceFlush = 0;
 
 	if (fNewOpen)
 	{
@@ -87,30 +123,54 @@ bool InputRecordingFile::Close()
 		return false;
 	}
 	WriteHeader();
-	WriteSaveState();
+	Flush();
 	fclose(recordingFile);
 	recordingFile = NULL;
 	filename = "";
+	padData.clear();
 	return true;
 }
 
-// Write savestate flag to file
-bool InputRecordingFile::WriteSaveState() {
+// Write the frames changed since the last flush in one go
+bool InputRecordingFile::Flush()
+{
 	if (recordingFile == NULL)
 	{
 		return false;
 	}
+	framesSinceFlush = 0;
 
-	fseek(recordingFile, RecordingSeekpointSaveState, SEEK_SET);
-	if (fwrite(&savestate.fromSavestate, sizeof(bool), 1, recordingFile) != 1)
+	if (headerDirty)
 	{
-		return false;
+		headerDirty = false;
+		u32 fields[2] = { (u32)MaxFrame, (u32)UndoCount };
+		if (fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET) != 0
+			|| fwrite(fields, sizeof(fields), 1, recordingFile) != 1)
+		{
+			return false;
+		}
+	}
+
+	if (dirtyStart != dirtyEnd)
+	{
+		const unsigned long start = dirtyStart;
+		const unsigned long count = std::min(dirtyEnd, (unsigned long)(padData.size() / RecordingBlockSize)) - start;
+		dirtyStart = dirtyEnd = 0;
+
+		if (count > 0
+			&& (fseek(recordingFile, GetBlockSeekPoint(start), SEEK_SET) != 0
+				|| fwrite(&padData[start * RecordingBlockSize], RecordingBlockSize, count, recordingFile) != count))
+		{
+			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: %s\n", strerror(errno)));
+			return false;
+		}
 	}
 
+	fflush(recordingFile);
 	return true;
 }
 
-// Write controller input buffer to file (per frame)
+// Write controller input buffer (per frame)
 bool InputRecordingFile::WriteKeyBuf(const uint & frame, const uint port, const uint bufIndex, const u8 & buf)
 {
 	if (recordingFile == NULL)
@@ -118,36 +178,32 @@ bool InputRecordingFile::WriteKeyBuf(const uint & frame, const uint port, const
 		return false;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
-
-	if (fseek(recordingFile, seek, SEEK_SET) != 0
-		|| fwrite(&buf, 1, 1, recordingFile) != 1)
+	// Bulk write the previous frames once enough of them have been recorded
+	if (frame != lastWriteFrame)
 	{
-		return false;
+		lastWriteFrame = frame;
+		if (++framesSinceFlush >= RecordingFlushInterval)
+		{
+			Flush();
+		}
 	}
 
-	fflush(recordingFile);
+	ReserveFrames(frame + 1);
+	GetFrameBlock(frame)[RecordingBlockHeaderSize + 18 * port + bufIndex] = buf;
+	SetFramesDirty(frame, frame + 1);
 	return true;
 }
 
-// Read controller input buffer from file (per frame)
+// Read controller input buffer (per frame)
 bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint port, const uint  bufIndex)
 {
-	if (recordingFile == NULL)
-	{
-		return false;
-	}
-
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
-	if (fseek(recordingFile, seek, SEEK_SET) != 0)
-	{
-		return false;
-	}
-	if (fread(&result, 1, 1, recordingFile) != 1)
+	const u8* block = GetFrameBlock(frame);
+	if (recordingFile == NULL || block == NULL)
 	{
 		return false;
 	}
 
+	result = block[RecordingBlockHeaderSize + 18 * port + bufIndex];
 	return true;
 }
 
@@ -155,97 +211,49 @@ bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint p
 void InputRecordingFile::GetPadData(PadData & result, unsigned long frame)
 {
 	result.fExistKey = false;
-	if (recordingFile == NULL)
-	{
-		return;
-	}
-
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	if (fseek(recordingFile, seek, SEEK_SET) != 0
-		|| fread(result.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
+	const u8* block = GetFrameBlock(frame);
+	if (recordingFile == NULL || block == NULL)
 	{
 		return;
 	}
 
+	memcpy(result.buf, block + RecordingBlockHeaderSize, RecordingBlockDataSize);
 	result.fExistKey = true;
 }
 
 bool InputRecordingFile::DeletePadData(unsigned long frame)
 {
-	if (recordingFile == NULL)
+	if (recordingFile == NULL || frame >= MaxFrame)
 	{
 		return false;
 	}
 
-	for (unsigned long i = frame; i < MaxFrame - 1; i++)
-	{
-		long seek1 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
-
-		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
-	}
+	ReserveFrames(MaxFrame);
+	u8* block = padData.data() + frame * RecordingBlockSize;
+	memmove(block, block + RecordingBlockSize, (MaxFrame - 1 - frame) * RecordingBlockSize);
+	SetFramesDirty(frame, MaxFrame - 1);
 	MaxFrame--;
-	WriteMaxFrame();
-	fflush(recordingFile);
+	headerDirty = true;
 
-	return true;
+	return Flush();
 }
 
 bool InputRecordingFile::InsertPadData(unsigned long frame, const PadData& key)
 {
-	if (recordingFile == NULL || !key.fExistKey)
+	if (recordingFile == NULL || !key.fExistKey || frame > MaxFrame)
 	{
 		return false;
 	}
 
-	for (unsigned long i = MaxFrame - 1; i >= frame; i--)
-	{
-		long seek1 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
-
-		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
-		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
-			return false;
-		}
-	}
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	int rSize = fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile);
-	if (rSize != RecordingBlockDataSize)
-	{
-		recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
-		return false;
-	}
+	ReserveFrames(MaxFrame + 1);
+	u8* block = padData.data() + frame * RecordingBlockSize;
+	memmove(block + RecordingBlockSize, block, (MaxFrame - frame) * RecordingBlockSize);
+	memcpy(block + RecordingBlockHeaderSize, key.buf, RecordingBlockDataSize);
+	SetFramesDirty(frame, MaxFrame + 1);
 	MaxFrame++;
-	WriteMaxFrame();
-	fflush(recordingFile);
+	headerDirty = true;
 
-	return true;
+	return Flush();
 }
 
 bool InputRecordingFile::UpdatePadData(unsigned long frame, const PadData& key)
@@ -259,14 +267,32 @@ bool InputRecordingFile::UpdatePadData(unsigned long frame, const PadData& key)
 		return false;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	if (fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
+	ReserveFrames(frame + 1);
+	memcpy(GetFrameBlock(frame) + RecordingBlockHeaderSize, key.buf, RecordingBlockDataSize);
+	SetFramesDirty(frame, frame + 1);
+
+	return Flush();
+}
+
+// Load all the controller data of the movie
+bool InputRecordingFile::ReadPadData()
+{
+	const long start = GetBlockSeekPoint(0);
+	if (fseek(recordingFile, 0, SEEK_END) != 0)
 	{
 		return false;
 	}
+	const long end = ftell(recordingFile);
+	const unsigned long frames = end > start ? (end - start) / RecordingBlockSize : 0;
 
-	fflush(recordingFile);
+	padData.assign(frames * RecordingBlockSize, 0);
+	if (frames > 0
+		&& (fseek(recordingFile, start, SEEK_SET) != 0
+			|| fread(padData.data(), RecordingBlockSize, frames, recordingFile) != frames))
+	{
+		padData.clear();
+		return false;
+	}
 	return true;
 }
 
@@ -281,7 +307,8 @@ bool InputRecordingFile::ReadHeaderAndCheck()
 	if (fread(&header, sizeof(InputRecordingHeader), 1, recordingFile) != 1
 		|| fread(&MaxFrame, 4, 1, recordingFile) != 1
 		|| fread(&UndoCount, 4, 1, recordingFile) != 1
-		|| fread(&savestate.fromSavestate, sizeof(bool), 1, recordingFile) != 1)
+		|| fread(&savestate.fromSavestate, sizeof(bool), 1, recordingFile) != 1
+		|| !ReadPadData())
 	{
 		return false;
 	}
@@ -315,25 +342,21 @@ bool InputRecordingFile::WriteHeader()
 	{
 		return false;
 	}
-	rewind(recordingFile);
-	if (fwrite(&header, sizeof(InputRecordingHeader), 1, recordingFile) != 1)
-	{
-		return false;
-	}
-	return true;
-}
 
-bool InputRecordingFile::WriteMaxFrame()
-{
-	if (recordingFile == NULL)
-	{
-		return false;
-	}
-	fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
-	if (fwrite(&MaxFrame, 4, 1, recordingFile) != 1)
+	u8 block[RecordingSeekpointSaveState + RecordingSavestateHeaderSize];
+	const u32 maxFrame = MaxFrame;
+	const u32 undoCount = UndoCount;
+	memcpy(block, &header, sizeof(InputRecordingHeader));
+	memcpy(block + RecordingSeekpointFrameMax, &maxFrame, 4);
+	memcpy(block + RecordingSeekpointUndoCount, &undoCount, 4);
+	memcpy(block + RecordingSeekpointSaveState, &savestate.fromSavestate, sizeof(bool));
+
+	rewind(recordingFile);
+	if (fwrite(block, sizeof(block), 1, recordingFile) != 1)
 	{
 		return false;
 	}
+	headerDirty = false;
 	return true;
 }
 
@@ -344,19 +367,13 @@ void InputRecordingFile::UpdateFrameMax(unsigned long frame)
 		return;
 	}
 	MaxFrame = frame;
-	fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
-	fwrite(&MaxFrame, 4, 1, recordingFile);
+	headerDirty = true;
 }
 
 void InputRecordingFile::AddUndoCount()
 {
 	UndoCount++;
-	if (recordingFile == NULL)
-	{
-		return;
-	}
-	fseek(recordingFile, RecordingSeekpointUndoCount, SEEK_SET);
-	fwrite(&UndoCount, 4, 1, recordingFile);
+	headerDirty = true;
 }
 
 void InputRecordingHeader::SetAuthor(wxString _author)
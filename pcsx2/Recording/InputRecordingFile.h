@@ -18,6 +18,8 @@
 #include "PadData.h"
 #include "System.h"
 
+#include <vector>
+
 
 #ifndef DISABLE_RECORDING
 struct InputRecordingHeader
@@ -66,9 +68,10 @@ public:
 	unsigned long& GetUndoCount();
 	const wxString & GetFilename();
 
+	// Writes the header, MaxFrame, UndoCount and the savestate flag
 	bool WriteHeader();
-	bool WriteMaxFrame();
-	bool WriteSaveState();
+	// Writes the frames and header fields changed since the last flush
+	bool Flush();
 
 	bool ReadHeaderAndCheck();
 	void UpdateFrameMax(unsigned long frame);
@@ -82,12 +85,28 @@ private:
 	static const int RecordingSeekpointFrameMax = sizeof(InputRecordingHeader);
 	static const int RecordingSeekpointUndoCount = sizeof(InputRecordingHeader) + 4;
 	static const int RecordingSeekpointSaveState = RecordingSeekpointUndoCount + 4;
+	// Frames recorded between two writes to the file
+	static const uint RecordingFlushInterval = 60;
 
 	// Movie File
 	FILE * recordingFile = NULL;
 	wxString filename = "";
 	long GetBlockSeekPoint(const long & frame);
 
+	// Controller data of the whole movie, RecordingBlockSize bytes per frame.  Frames are
+	// written back to the file in bulk every RecordingFlushInterval frames and on Close().
+	std::vector<u8> padData;
+	unsigned long dirtyStart = 0;
+	unsigned long dirtyEnd = 0;
+	bool headerDirty = false;
+	uint lastWriteFrame = 0;
+	uint framesSinceFlush = 0;
+
+	u8* GetFrameBlock(unsigned long frame);
+	void ReserveFrames(unsigned long frames);
+	void SetFramesDirty(unsigned long start, unsigned long end);
+	bool ReadPadData();
+
 	// Header
 	InputRecordingHeader header;
 	InputRecordingSavestate savestate;
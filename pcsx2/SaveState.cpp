@@ -320,3 +320,237 @@ void memLoadingState::FreezeMem( void* data, int size )
 	m_idx += size;
 	memcpy( data, src, size );
 }
+
+// --------------------------------------------------------------------------------------
+//  memSnapshotRing  (implementations)
+// --------------------------------------------------------------------------------------
+struct SnapshotRegion
+{
+	u8*		ptr;
+	uint	size;
+};
+
+static const uint SnapshotRegionCount = 9;
+
+static const uint SnapshotMemorySizeInBytes = MainMemorySizeInBytes +
+	VU0_PROGSIZE + VU0_MEMSIZE + VU1_PROGSIZE + VU1_MEMSIZE;
+
+static const uint SnapshotPageCount = SnapshotMemorySizeInBytes / memSnapshotRing::PageSize;
+
+// Same blocks as FreezeMainMemory.  Resolved on demand since PS2 memory is allocated
+// dynamically.  All of them are a multiple of the snapshot page size.
+static void GetSnapshotRegions( SnapshotRegion (&dest)[SnapshotRegionCount] )
+{
+	const SnapshotRegion regions[SnapshotRegionCount] =
+	{
+		{ eeMem->Main,			Ps2MemSize::MainRam },
+		{ eeMem->Scratch,		Ps2MemSize::Scratch },
+		{ eeHw,					Ps2MemSize::Hardware },
+		{ iopMem->Main,			Ps2MemSize::IopRam },
+		{ iopHw,				Ps2MemSize::IopHardware },
+		{ vuRegs[0].Micro,		VU0_PROGSIZE },
+		{ vuRegs[0].Mem,		VU0_MEMSIZE },
+		{ vuRegs[1].Micro,		VU1_PROGSIZE },
+		{ vuRegs[1].Mem,		VU1_MEMSIZE },
+	};
+
+	for (uint i=0; i<SnapshotRegionCount; ++i)
+	{
+		pxAssume( (regions[i].size % memSnapshotRing::PageSize) == 0 );
+		dest[i] = regions[i];
+	}
+}
+
+static __fi u64 rotl64( u64 x, uint s )
+{
+	return (x << s) | (x >> (64 - s));
+}
+
+// 64-bit page hash, built like xxHash64's main loop.  Every step is invertible, so pages
+// that differ in a single u64 are guaranteed to hash differently; beyond that a change
+// goes unnoticed with a chance of about 1 in 2^64.
+static u64 HashSnapshotPage( const u8* src )
+{
+	static const u64 Prime1 = 0x9E3779B185EBCA87ull;
+	static const u64 Prime2 = 0xC2B2AE3D27D4EB4Full;
+
+	const u64* words = (const u64*)src;
+	u64 acc[4] = { Prime1 + Prime2, Prime2, 0, 0 - Prime1 };
+
+	for (uint i=0; i<memSnapshotRing::PageSize / 8; i+=4)
+	{
+		for (uint j=0; j<4; ++j)
+			acc[j] = rotl64( acc[j] + words[i+j] * Prime2, 31 ) * Prime1;
+	}
+
+	u64 hash = rotl64( acc[0], 1 ) + rotl64( acc[1], 7 ) + rotl64( acc[2], 12 ) + rotl64( acc[3], 18 );
+	hash ^= hash >> 33;
+	hash *= Prime2;
+	hash ^= hash >> 29;
+	return hash;
+}
+
+// Hashes every page of PS2 memory, in snapshot page order.
+static void HashSnapshotPages( const SnapshotRegion (&regions)[SnapshotRegionCount], std::vector<u64>& dest )
+{
+	dest.resize( SnapshotPageCount );
+
+	u32 page = 0;
+	for (uint i=0; i<SnapshotRegionCount; ++i)
+	{
+		for (uint offset=0; offset<regions[i].size; offset+=memSnapshotRing::PageSize, ++page)
+			dest[page] = HashSnapshotPage( regions[i].ptr + offset );
+	}
+}
+
+memSnapshotRing::memSnapshotRing( uint capacity )
+{
+	m_capacity = std::max( capacity, 1u );
+}
+
+void memSnapshotRing::SetCapacity( uint capacity )
+{
+	m_capacity = std::max( capacity, 1u );
+
+	while (m_ring.size() > m_capacity)
+		m_ring.pop_front();
+}
+
+void memSnapshotRing::Clear()
+{
+	m_ring.clear();
+	m_base.reset();
+	std::vector<u64>().swap( m_hashes );
+}
+
+const memSnapshotRing::Snapshot& memSnapshotRing::GetSnapshot( uint age ) const
+{
+	pxAssertDev( age < m_ring.size(), "Snapshot index is out of range." );
+	return *m_ring[m_ring.size() - 1 - age];
+}
+
+uint memSnapshotRing::GetDirtyPageCount( uint age ) const
+{
+	return GetSnapshot( age ).pages.size();
+}
+
+// Copies the current contents of PS2 memory into a new base image, given the hashes of its
+// pages.  Snapshots which were taken against the old base keep it alive for as long as they
+// stay in the ring.
+void memSnapshotRing::Rebase( const std::vector<u64>& hashes )
+{
+	SnapshotRegion regions[SnapshotRegionCount];
+	GetSnapshotRegions( regions );
+
+	m_base = std::make_shared<BaseImage>( SnapshotMemorySizeInBytes );
+	m_base->hashes = hashes;
+
+	u8* dest = m_base->memory.GetPtr();
+	for (uint i=0; i<SnapshotRegionCount; ++i)
+	{
+		memcpy( dest, regions[i].ptr, regions[i].size );
+		dest += regions[i].size;
+	}
+}
+
+void memSnapshotRing::Capture()
+{
+	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+
+	std::unique_ptr<Snapshot> snap( new Snapshot );
+
+	SnapshotRegion regions[SnapshotRegionCount];
+	GetSnapshotRegions( regions );
+
+	// One read-only pass over memory; only the dirty pages are read a second time.
+	HashSnapshotPages( regions, m_hashes );
+
+	if (m_base)
+	{
+		const std::vector<u64>& base = m_base->hashes;
+
+		for (u32 page=0; page<SnapshotPageCount; ++page)
+		{
+			if (m_hashes[page] != base[page])
+				snap->pages.push_back( page );
+		}
+
+		if (snap->pages.size() > SnapshotPageCount / 2)
+		{
+			snap->pages.clear();
+			Rebase( m_hashes );
+		}
+		else if (!snap->pages.empty())
+		{
+			snap->pagedata.ExactAlloc( snap->pages.size() * PageSize );
+			snap->hashes.reserve( snap->pages.size() );
+
+			uint region = 0, region_first = 0;
+			u8* dest = snap->pagedata.GetPtr();
+
+			for (u32 dirty : snap->pages)
+			{
+				while (dirty >= region_first + regions[region].size / PageSize)
+					region_first += regions[region++].size / PageSize;
+
+				memcpy( dest, regions[region].ptr + (dirty - region_first) * PageSize, PageSize );
+				dest += PageSize;
+				snap->hashes.push_back( m_hashes[dirty] );
+			}
+		}
+	}
+	else
+		Rebase( m_hashes );
+
+	snap->base = m_base;
+
+	memSavingState saveme( snap->state );
+	saveme.MakeRoomForData();
+	saveme.FreezeBios();
+	saveme.FreezeInternals();
+	saveme.FreezePlugins();
+
+	if (m_ring.size() >= m_capacity)
+		m_ring.pop_front();
+
+	m_ring.push_back( std::move(snap) );
+}
+
+void memSnapshotRing::Restore( uint age ) const
+{
+	const Snapshot& snap = GetSnapshot( age );
+
+	vu1Thread.WaitVU();
+	PreLoadPrep();
+
+	SnapshotRegion regions[SnapshotRegionCount];
+	GetSnapshotRegions( regions );
+
+	// Pages which still hold the snapshot's contents are left alone, so going back a few
+	// frames only rewrites what the game touched since.
+	const u8* base = snap.base->memory.GetPtr();
+	const u8* pagedata = snap.pages.empty() ? NULL : snap.pagedata.GetPtr();
+	uint dirty = 0;
+	u32 page = 0;
+
+	for (uint i=0; i<SnapshotRegionCount; ++i)
+	{
+		for (uint offset=0; offset<regions[i].size; offset+=PageSize, ++page)
+		{
+			const u8* src = base + page * PageSize;
+			u64 hash = snap.base->hashes[page];
+
+			if (dirty < snap.pages.size() && snap.pages[dirty] == page)
+			{
+				src = pagedata + dirty * PageSize;
+				hash = snap.hashes[dirty];
+				++dirty;
+			}
+
+			if (HashSnapshotPage( regions[i].ptr + offset ) != hash)
+				memcpy( regions[i].ptr + offset, src, PageSize );
+		}
+	}
+
+	memLoadingState( snap.state ).FreezeBios().FreezeInternals().FreezePlugins();
+}
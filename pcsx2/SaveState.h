@@ -18,6 +18,10 @@
 #include "PS2Edefs.h"
 #include "System.h"
 
+#include <deque>
+#include <memory>
+#include <vector>
+
 // Savestate Versioning!
 //  If you make changes to the savestate version, please increment the value below.
 //  If the change is minor and compatibility with old states is retained, increment
@@ -196,3 +200,85 @@ public:
 	bool IsFinished() const { return m_idx >= m_memory->GetSizeInBytes(); }
 };
 
+
+// --------------------------------------------------------------------------------------
+//  memSnapshotRing
+// --------------------------------------------------------------------------------------
+// Keeps the most recent in-memory snapshots of the VM for fast save/restore, which is
+// mostly useful for automated testing where states are taken very frequently.
+//
+// PS2 memory (EE/IOP RAM, scratchpad, hardware registers and VU memory) is stored
+// incrementally: each snapshot only keeps the pages that differ from a shared base image,
+// plus the usual bios/internals/plugins blob.  Dirty pages are found by hashing memory
+// when capturing and comparing against the hashes of the base; EE RAM page protection is
+// owned by the recompiler's block tracking, and IOP RAM is written to by DMA and plugins
+// directly, so neither could give us a reliable write log.  Restoring likewise only copies
+// the pages whose hash differs from the snapshot's.  A new base is taken once the delta
+// grows past half of memory.
+//
+// The ring holds snapshots of a single boot: it's cleared when the VM is reset and when a
+// game starts.
+//
+// Like memSavingState and memLoadingState, the caller is responsible for having the core
+// thread paused while capturing or restoring.
+//
+class memSnapshotRing
+{
+	DeclareNoncopyableObject(memSnapshotRing);
+
+public:
+	static const uint PageSize			= _4kb;
+	static const uint DefaultCapacity	= 8;
+
+protected:
+	struct BaseImage
+	{
+		VmStateBuffer		memory;
+		std::vector<u64>	hashes;		// hash of each page of memory
+
+		BaseImage( uint size )
+			: memory( size, L"Snapshot Base" )
+			, hashes( size / PageSize )
+		{
+		}
+	};
+
+	struct Snapshot
+	{
+		std::shared_ptr<BaseImage>		base;		// memory image the pages below apply to
+		std::vector<u32>				pages;		// indices of pages which differ from base
+		std::vector<u64>				hashes;		// hashes of those pages, in the same order
+		VmStateBuffer					pagedata;	// contents of those pages, in the same order
+		VmStateBuffer					state;		// bios, internals and plugins
+
+		Snapshot()
+			: pagedata( L"Snapshot Pages" )
+			, state( L"Snapshot State" )
+		{
+		}
+	};
+
+	std::deque<std::unique_ptr<Snapshot>>	m_ring;
+	std::shared_ptr<BaseImage>				m_base;
+	std::vector<u64>						m_hashes;	// scratch, hashes of the live pages
+	uint									m_capacity;
+
+public:
+	memSnapshotRing( uint capacity=DefaultCapacity );
+	virtual ~memSnapshotRing() = default;
+
+	void Capture();
+	void Restore( uint age=0 ) const;
+	void Clear();
+
+	void SetCapacity( uint capacity );
+	uint GetCapacity() const	{ return m_capacity; }
+	uint GetCount() const		{ return m_ring.size(); }
+
+	// Number of pages stored by the given snapshot (0 = most recent) on top of its base.
+	uint GetDirtyPageCount( uint age=0 ) const;
+
+protected:
+	const Snapshot& GetSnapshot( uint age ) const;
+	void Rebase( const std::vector<u64>& hashes );
+};
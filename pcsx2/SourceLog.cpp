@@ -51,7 +51,9 @@ void __Log( const char* fmt, ... )
 	va_list list;
 	va_start(list, fmt);
 
-	if( emuLog != NULL )
+	if( EmuConfig.Trace.Binary )
+		BinaryTrace::Write( NULL, NULL, fmt, list );
+	else if( emuLog != NULL )
 	{
 		fputs( FastFormatAscii().WriteV(fmt,list), emuLog );
 		fputs( "\n", emuLog );
@@ -61,6 +63,24 @@ void __Log( const char* fmt, ... )
 	va_end( list );
 }
 
+bool SysTraceLog::Write( const char* fmt, ... ) const
+{
+	va_list list;
+	va_start(list, fmt);
+
+	if( EmuConfig.Trace.Binary )
+	{
+		BinaryTrace::Prefix prefix = { NULL, NULL, 0, 0 };
+		GetBinaryPrefix( prefix );
+		BinaryTrace::Write( this, &prefix, fmt, list );
+	}
+	else
+		WriteV( fmt, list );
+
+	va_end( list );
+	return false;
+}
+
 void SysTraceLog::DoWrite( const char *msg ) const
 {
 	if( emuLog == NULL ) return;
@@ -75,17 +95,37 @@ void SysTraceLog_EE::ApplyPrefix( FastFormatAscii& ascii ) const
 	ascii.Write( "%-4s(%8.8lx %8.8lx): ", ((SysTraceLogDescriptor*)m_Descriptor)->Prefix, cpuRegs.pc, cpuRegs.cycle );
 }
 
+void SysTraceLog_EE::GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const
+{
+	prefix.name = ((SysTraceLogDescriptor*)m_Descriptor)->Prefix;
+	prefix.pc = cpuRegs.pc;
+	prefix.cycle = cpuRegs.cycle;
+}
+
 void SysTraceLog_IOP::ApplyPrefix( FastFormatAscii& ascii ) const
 {
 	ascii.Write( "%-4s(%8.8lx %8.8lx): ", ((SysTraceLogDescriptor*)m_Descriptor)->Prefix, psxRegs.pc, psxRegs.cycle );
 }
 
+void SysTraceLog_IOP::GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const
+{
+	prefix.name = ((SysTraceLogDescriptor*)m_Descriptor)->Prefix;
+	prefix.pc = psxRegs.pc;
+	prefix.cycle = psxRegs.cycle;
+}
+
 void SysTraceLog_VIFcode::ApplyPrefix( FastFormatAscii& ascii ) const
 {
 	_parent::ApplyPrefix(ascii);
 	ascii.Write( "vifCode_" );
 }
 
+void SysTraceLog_VIFcode::GetBinaryPrefix( BinaryTrace::Prefix& prefix ) const
+{
+	_parent::GetBinaryPrefix(prefix);
+	prefix.tag = "vifCode_";
+}
+
 // --------------------------------------------------------------------------------------
 //  SysConsoleLogPack  (descriptions)
 // --------------------------------------------------------------------------------------
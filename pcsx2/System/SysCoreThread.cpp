@@ -24,6 +24,7 @@
 #include "Patch.h"
 #include "SysThreads.h"
 #include "MTVU.h"
+#include "IPU/IPU.h"
 
 #include "../DebugTools/MIPSAnalyst.h"
 #include "../DebugTools/SymbolMap.h"
@@ -255,6 +256,7 @@ void SysCoreThread::DoCpuExecute()
 	m_hasActiveMachine = true;
 	UI_EnableSysActions();
 	Cpu->Execute();
+	ipuWorkerSync();
 }
 
 void SysCoreThread::ExecuteTaskInThread()
@@ -293,6 +295,7 @@ void SysCoreThread::OnCleanupInThread()
 
 	// FIXME: temporary workaround for deadlock on exit, which actually should be a crash
 	vu1Thread.WaitVU();
+	ipuWorkerSync();
 	GetCorePlugins().Close();
 	GetCorePlugins().Shutdown();
 
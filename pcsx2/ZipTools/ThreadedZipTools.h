@@ -139,6 +139,89 @@ public:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  ZipChunkIndex
+// --------------------------------------------------------------------------------------
+// Savestate entries are deflated as a series of independent fixed-size chunks, each ending
+// on a full flush.  The entry is still a single valid deflate stream (readable by any zip
+// tool), but given the compressed size of each chunk it can also be inflated in parallel.
+// The chunk sizes for every entry are kept in a separate stored entry of the archive.
+//
+static const wxChar* const EntryFilename_ChunkIndex = L"PCSX2 Chunk Index.dat";
+
+struct ZipChunkList
+{
+	wxString			name;
+	u32					chunksize;		// uncompressed size of every chunk but the last
+	u32					datasize;		// uncompressed size of the whole entry
+	std::vector<u32>	sizes;			// compressed size of each chunk
+};
+
+class ZipChunkIndex
+{
+protected:
+	std::vector<ZipChunkList> m_list;
+
+public:
+	void Add( const ZipChunkList& src )		{ m_list.push_back( src ); }
+	bool IsEmpty() const					{ return m_list.empty(); }
+
+	const ZipChunkList* Find( const wxString& name ) const;
+
+	void Save( std::vector<u8>& dest ) const;
+	bool Load( const u8* src, uint size );
+};
+
+// --------------------------------------------------------------------------------------
+//  ParallelZipWriter
+// --------------------------------------------------------------------------------------
+// Minimal zip archive writer used for savestates.  Deflating is split across worker threads
+// (see ZipChunkIndex), and data is compressed straight from the caller's buffer.
+//
+class ParallelZipWriter
+{
+	DeclareNoncopyableObject( ParallelZipWriter );
+
+public:
+	static const uint ChunkSize = _1mb;
+
+protected:
+	struct CentralEntry
+	{
+		std::string		name;
+		u16				method;
+		u32				crc;
+		u32				csize;
+		u32				usize;
+		u32				offset;
+	};
+
+	pxOutputStream&				m_out;
+	u32							m_pos;
+	u16							m_dostime;
+	u16							m_dosdate;
+	std::vector<CentralEntry>	m_central;
+	ZipChunkIndex				m_index;
+
+public:
+	ParallelZipWriter( pxOutputStream& out );
+	virtual ~ParallelZipWriter() = default;
+
+	void PutStored( const wxString& name, const void* data, uint size );
+	void PutDeflated( const wxString& name, const void* data, uint size );
+
+	// Writes the chunk index and the central directory.  The stream itself is left open.
+	void Finish();
+
+protected:
+	void WriteLocalHeader( CentralEntry& entry );
+};
+
+// Inflates a deflated entry written by ParallelZipWriter straight into dest, using worker
+// threads.  file must be a separate (seekable) stream over the archive.  Returns false if
+// the entry does not match the chunk list, in which case it should be read normally.
+extern bool InflateZipEntryParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks, void* dest, uint destsize );
+
 // --------------------------------------------------------------------------------------
 //  BaseCompressThread
 // --------------------------------------------------------------------------------------
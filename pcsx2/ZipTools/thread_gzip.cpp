@@ -21,6 +21,378 @@
 #include "Utilities/SafeArray.inl"
 #include "wx/wfstream.h"
 
+#include <atomic>
+#include <thread>
+
+#ifdef __POSIX__
+#include <zlib.h>
+#else
+#include <zlib/zlib.h>
+#endif
+
+// Runs func(0) ... func(count-1) across all host threads.  func must not throw.
+template< typename Func >
+static void ParallelFor( uint count, const Func& func )
+{
+	std::atomic<uint> next( 0 );
+
+	const auto worker = [&]()
+	{
+		for (uint i; (i = next++) < count; )
+			func( i );
+	};
+
+	const uint threads = std::min( count, std::max( std::thread::hardware_concurrency(), 1u ) );
+
+	std::vector<std::thread> pool;
+	for (uint i=1; i<threads; ++i)
+		pool.emplace_back( worker );
+
+	worker();
+
+	for (std::thread& thr : pool)
+		thr.join();
+}
+
+static void AppendLE( std::vector<u8>& dest, u32 value, uint bytes )
+{
+	for (uint i=0; i<bytes; ++i)
+		dest.push_back( (u8)(value >> (i * 8)) );
+}
+
+// --------------------------------------------------------------------------------------
+//  ZipChunkIndex  (implementations)
+// --------------------------------------------------------------------------------------
+const ZipChunkList* ZipChunkIndex::Find( const wxString& name ) const
+{
+	for (const ZipChunkList& list : m_list)
+	{
+		if (list.name.CmpNoCase( name ) == 0)
+			return &list;
+	}
+
+	return NULL;
+}
+
+// Layout: u32 count, then per entry: u16 namelen, name (utf8), u32 chunksize,
+// u32 datasize, u32 chunkcount, u32 sizes[chunkcount].  All little endian.
+void ZipChunkIndex::Save( std::vector<u8>& dest ) const
+{
+	AppendLE( dest, m_list.size(), 4 );
+
+	for (const ZipChunkList& list : m_list)
+	{
+		const wxCharBuffer name( list.name.ToUTF8() );
+		const uint namelen = strlen( name.data() );
+
+		AppendLE( dest, namelen, 2 );
+		dest.insert( dest.end(), name.data(), name.data() + namelen );
+		AppendLE( dest, list.chunksize, 4 );
+		AppendLE( dest, list.datasize, 4 );
+		AppendLE( dest, list.sizes.size(), 4 );
+
+		for (u32 size : list.sizes)
+			AppendLE( dest, size, 4 );
+	}
+}
+
+bool ZipChunkIndex::Load( const u8* src, uint size )
+{
+	const u8* const end = src + size;
+
+	const auto read = [&]( uint bytes, u32& value )
+	{
+		if ((uint)(end - src) < bytes) return false;
+
+		value = 0;
+		for (uint i=0; i<bytes; ++i)
+			value |= (u32)*src++ << (i * 8);
+		return true;
+	};
+
+	m_list.clear();
+
+	u32 count;
+	if (!read( 4, count )) return false;
+
+	for (u32 i=0; i<count; ++i)
+	{
+		ZipChunkList list;
+		u32 namelen, chunkcount;
+
+		if (!read( 2, namelen ) || (uint)(end - src) < namelen) return false;
+		list.name = wxString::FromUTF8( (const char*)src, namelen );
+		src += namelen;
+
+		if (!read( 4, list.chunksize ) || !read( 4, list.datasize ) || !read( 4, chunkcount )) return false;
+		if (chunkcount > (uint)(end - src) / 4) return false;
+
+		list.sizes.resize( chunkcount );
+		for (u32& chunk : list.sizes)
+			read( 4, chunk );
+
+		m_list.push_back( list );
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------
+//  ParallelZipWriter  (implementations)
+// --------------------------------------------------------------------------------------
+ParallelZipWriter::ParallelZipWriter( pxOutputStream& out )
+	: m_out( out )
+{
+	m_pos = 0;
+
+	const wxDateTime now( wxDateTime::Now() );
+	m_dostime = (now.GetHour() << 11) | (now.GetMinute() << 5) | (now.GetSecond() / 2);
+	m_dosdate = ((now.GetYear() - 1980) << 9) | ((now.GetMonth() + 1) << 5) | now.GetDay();
+}
+
+void ParallelZipWriter::WriteLocalHeader( CentralEntry& entry )
+{
+	entry.offset = m_pos;
+
+	std::vector<u8> header;
+	AppendLE( header, 0x04034b50, 4 );		// local file header signature
+	AppendLE( header, 20, 2 );				// version needed to extract (2.0)
+	AppendLE( header, 0, 2 );				// flags
+	AppendLE( header, entry.method, 2 );
+	AppendLE( header, m_dostime, 2 );
+	AppendLE( header, m_dosdate, 2 );
+	AppendLE( header, entry.crc, 4 );
+	AppendLE( header, entry.csize, 4 );
+	AppendLE( header, entry.usize, 4 );
+	AppendLE( header, entry.name.length(), 2 );
+	AppendLE( header, 0, 2 );				// extra field length
+	header.insert( header.end(), entry.name.begin(), entry.name.end() );
+
+	m_out.Write( header.data(), header.size() );
+	m_pos += header.size();
+}
+
+void ParallelZipWriter::PutStored( const wxString& name, const void* data, uint size )
+{
+	CentralEntry entry;
+	entry.name		= name.ToUTF8().data();
+	entry.method	= 0;
+	entry.crc		= crc32( 0, (const Bytef*)data, size );
+	entry.csize		= size;
+	entry.usize		= size;
+
+	WriteLocalHeader( entry );
+	if (size) m_out.Write( data, size );
+	m_pos += size;
+
+	m_central.push_back( entry );
+}
+
+void ParallelZipWriter::PutDeflated( const wxString& name, const void* data, uint size )
+{
+	struct DeflatedChunk
+	{
+		std::vector<u8>	data;
+		u32				crc;
+		bool			ok;
+	};
+
+	const u8* const src = (const u8*)data;
+	const uint chunkcount = std::max( (size + ChunkSize - 1) / ChunkSize, 1u );
+	std::vector<DeflatedChunk> chunks( chunkcount );
+
+	ParallelFor( chunkcount, [&]( uint i )
+	{
+		DeflatedChunk& chunk = chunks[i];
+		const uint offset	= i * ChunkSize;
+		const uint len		= std::min( size - offset, ChunkSize );
+		const bool last		= (i == chunkcount - 1);
+
+		z_stream zs;
+		memzero( zs );
+		chunk.ok = false;
+
+		if (deflateInit2( &zs, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK)
+			return;
+
+		// Room for the full flush marker on top of the worst case for a single Z_FINISH.
+		chunk.data.resize( deflateBound( &zs, len ) + 16 );
+
+		zs.next_in		= (Bytef*)(src + offset);
+		zs.avail_in		= len;
+		zs.next_out		= chunk.data.data();
+		zs.avail_out	= chunk.data.size();
+
+		// Full flush byte-aligns the output and resets the dictionary, so the next chunk can
+		// be inflated on its own.
+		const int ret = deflate( &zs, last ? Z_FINISH : Z_FULL_FLUSH );
+		chunk.ok = last ? (ret == Z_STREAM_END) : (ret == Z_OK && zs.avail_in == 0 && zs.avail_out != 0);
+
+		chunk.data.resize( zs.total_out );
+		chunk.crc = crc32( 0, src + offset, len );
+		deflateEnd( &zs );
+	});
+
+	CentralEntry entry;
+	entry.name		= name.ToUTF8().data();
+	entry.method	= Z_DEFLATED;
+	entry.crc		= 0;
+	entry.csize		= 0;
+	entry.usize		= size;
+
+	ZipChunkList list;
+	list.name		= name;
+	list.chunksize	= ChunkSize;
+	list.datasize	= size;
+
+	for (uint i=0; i<chunkcount; ++i)
+	{
+		if (!chunks[i].ok)
+			throw Exception::BadStream( m_out.GetStreamName() )
+				.SetDiagMsg(pxsFmt( L"Failed to deflate archive entry '%s'.", WX_STR(name) ));
+
+		const uint len = std::min( size - i * ChunkSize, ChunkSize );
+		entry.crc = crc32_combine( entry.crc, chunks[i].crc, len );
+		entry.csize += chunks[i].data.size();
+		list.sizes.push_back( chunks[i].data.size() );
+	}
+
+	WriteLocalHeader( entry );
+
+	for (const DeflatedChunk& chunk : chunks)
+		m_out.Write( chunk.data.data(), chunk.data.size() );
+
+	m_pos += entry.csize;
+	m_central.push_back( entry );
+	m_index.Add( list );
+}
+
+void ParallelZipWriter::Finish()
+{
+	if (!m_index.IsEmpty())
+	{
+		std::vector<u8> index;
+		m_index.Save( index );
+		PutStored( EntryFilename_ChunkIndex, index.data(), index.size() );
+	}
+
+	const u32 dirpos = m_pos;
+	std::vector<u8> dir;
+
+	for (const CentralEntry& entry : m_central)
+	{
+		AppendLE( dir, 0x02014b50, 4 );		// central file header signature
+		AppendLE( dir, 20, 2 );				// version made by
+		AppendLE( dir, 20, 2 );				// version needed to extract
+		AppendLE( dir, 0, 2 );				// flags
+		AppendLE( dir, entry.method, 2 );
+		AppendLE( dir, m_dostime, 2 );
+		AppendLE( dir, m_dosdate, 2 );
+		AppendLE( dir, entry.crc, 4 );
+		AppendLE( dir, entry.csize, 4 );
+		AppendLE( dir, entry.usize, 4 );
+		AppendLE( dir, entry.name.length(), 2 );
+		AppendLE( dir, 0, 2 );				// extra field length
+		AppendLE( dir, 0, 2 );				// comment length
+		AppendLE( dir, 0, 2 );				// disk number start
+		AppendLE( dir, 0, 2 );				// internal attributes
+		AppendLE( dir, 0, 4 );				// external attributes
+		AppendLE( dir, entry.offset, 4 );
+		dir.insert( dir.end(), entry.name.begin(), entry.name.end() );
+	}
+
+	const u32 dirsize = dir.size();
+
+	AppendLE( dir, 0x06054b50, 4 );			// end of central directory signature
+	AppendLE( dir, 0, 2 );					// number of this disk
+	AppendLE( dir, 0, 2 );					// disk with the central directory
+	AppendLE( dir, m_central.size(), 2 );
+	AppendLE( dir, m_central.size(), 2 );
+	AppendLE( dir, dirsize, 4 );
+	AppendLE( dir, dirpos, 4 );
+	AppendLE( dir, 0, 2 );					// comment length
+
+	m_out.Write( dir.data(), dir.size() );
+	m_pos += dir.size();
+}
+
+// --------------------------------------------------------------------------------------
+//  InflateZipEntryParallel
+// --------------------------------------------------------------------------------------
+bool InflateZipEntryParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks, void* dest, uint destsize )
+{
+	if (entry.GetMethod() != wxZIP_METHOD_DEFLATE || chunks.sizes.empty() || !chunks.chunksize) return false;
+	if (chunks.datasize != destsize || (u64)entry.GetSize() != destsize) return false;
+	if (!destsize || (destsize + chunks.chunksize - 1) / chunks.chunksize != chunks.sizes.size()) return false;
+
+	u64 csize = 0;
+	for (u32 size : chunks.sizes)
+		csize += size;
+
+	if (csize != (u64)entry.GetCompressedSize()) return false;
+
+	// The zip directory only knows where the local header starts; skip past it.
+	u8 header[30];
+	file.Seek( entry.GetOffset() );
+	file.Read( header );
+
+	if (header[0] != 0x50 || header[1] != 0x4b || header[2] != 0x03 || header[3] != 0x04) return false;
+
+	const uint namelen	= header[26] | (header[27] << 8);
+	const uint extralen	= header[28] | (header[29] << 8);
+	file.Seek( entry.GetOffset() + sizeof(header) + namelen + extralen );
+
+	std::vector<u8> compressed( csize );
+	file.Read( compressed.data(), compressed.size() );
+
+	const uint chunkcount = chunks.sizes.size();
+	std::vector<uptr> offsets( chunkcount );
+	std::vector<u32> crcs( chunkcount );
+	std::atomic<bool> failed( false );
+
+	for (uint i=1; i<chunkcount; ++i)
+		offsets[i] = offsets[i-1] + chunks.sizes[i-1];
+
+	ParallelFor( chunkcount, [&]( uint i )
+	{
+		u8* const out	= (u8*)dest + i * chunks.chunksize;
+		const uint len	= std::min( destsize - i * chunks.chunksize, chunks.chunksize );
+
+		z_stream zs;
+		memzero( zs );
+
+		if (inflateInit2( &zs, -MAX_WBITS ) != Z_OK)
+		{
+			failed = true;
+			return;
+		}
+
+		zs.next_in		= compressed.data() + offsets[i];
+		zs.avail_in		= chunks.sizes[i];
+		zs.next_out		= out;
+		zs.avail_out	= len;
+
+		// Only the last chunk carries the final block; the others just run out of input.
+		const int ret = inflate( &zs, Z_SYNC_FLUSH );
+		if ((ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) || zs.total_out != len)
+			failed = true;
+
+		inflateEnd( &zs );
+		crcs[i] = crc32( 0, out, len );
+	});
+
+	u32 crc = 0;
+	for (uint i=0; i<chunkcount; ++i)
+		crc = crc32_combine( crc, crcs[i], std::min( destsize - i * chunks.chunksize, chunks.chunksize ) );
+
+	if (failed || crc != entry.GetCrc())
+		throw Exception::SaveStateLoadError( file.GetStreamName() )
+			.SetDiagMsg(pxsFmt( L"Savestate entry '%s' is corrupted (inflate or crc check failed).", WX_STR(entry.GetName()) ))
+			.SetUserMsg(_("This savestate cannot be loaded because it is corrupted.  See the log file for details."));
+
+	return true;
+}
+
 
 BaseCompressThread::~BaseCompressThread()
 {
@@ -55,28 +427,21 @@ void BaseCompressThread::ExecuteTaskInThread()
 	
 	Yield( 3 );
 
+	// Entries are compressed straight out of the source buffer, in chunks spread across all
+	// host threads (see ParallelZipWriter).
+	ParallelZipWriter zip( *m_gzfp );
+
 	uint listlen = m_src_list->GetLength();
 	for( uint i=0; i<listlen; ++i )
 	{
 		const ArchiveEntry& entry = (*m_src_list)[i];
 		if (!entry.GetDataSize()) continue;
 
-		wxArchiveOutputStream& woot = *(wxArchiveOutputStream*)m_gzfp->GetWxStreamBase();
-		woot.PutNextEntry( entry.GetFilename() );
-
-		static const uint BlockSize = 0x64000;
-		uint curidx = 0;
-
-		do {
-			uint thisBlockSize = std::min( BlockSize, entry.GetDataSize() - curidx );
-			m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
-			curidx += thisBlockSize;
-			Yield( 2 );
-		} while( curidx < entry.GetDataSize() );
-		
-		woot.CloseEntry();
+		zip.PutDeflated( entry.GetFilename(), m_src_list->GetPtr( entry.GetDataIndex() ), entry.GetDataSize() );
+		Yield( 2 );
 	}
 
+	zip.Finish();
 	m_gzfp->Close();
 
 	if( !wxRenameFile( m_gzfp->GetStreamName(), m_final_filename, true ) )
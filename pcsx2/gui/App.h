@@ -325,6 +325,10 @@ public:
 
 	wxString		GameLaunchArgs;
 
+	// Folder of disc images to scan (and cache file to use) instead of starting the gui.
+	wxString		ScanLibrary;
+	wxString		ScanCache;
+
 	// Specifies the CDVD source type to use when AutoRunning
 	CDVD_SourceType CdvdSource;
 
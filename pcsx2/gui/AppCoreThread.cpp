@@ -534,6 +534,7 @@ void AppCoreThread::ApplySettings( const Pcsx2Config& src )
 void AppCoreThread::DoCpuReset()
 {
 	PostCoreStatus( CoreThread_Reset );
+	StateCopy_ClearMemorySnapshots();
 	_parent::DoCpuReset();
 }
 
@@ -584,6 +585,7 @@ void AppCoreThread::GameStartingInThread()
 	_reset_stuff_as_needed();
 	ClearMcdEjectTimeoutNow(); // probably safe to do this when a game boots, eliminates annoying prompts
 	m_ExecMode = ExecMode_Opened;
+	StateCopy_ClearMemorySnapshots();
 
 	_parent::GameStartingInThread();
 }
@@ -17,6 +17,8 @@
 #include "App.h"
 #include "AppGameDatabase.h"
 #include <wx/stdpaths.h>
+#include <wx/mstream.h>
+#include <algorithm>
 
 class DBLoaderHelper
 {
@@ -128,6 +130,192 @@ void DBLoaderHelper::ReadGames()
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  GameIndex.idx
+// --------------------------------------------------------------------------------------
+// Header, IndexEntry table, serial pool.  The index is only valid for the exact .dbf it was
+// built from, checked through its size, modification time and hash.
+
+namespace
+{
+	struct IndexFileHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 dbfSize;
+		s64 dbfTime;
+		u64 dbfHash;
+		u32 entryCount;
+		u32 serialsSize;
+	};
+
+	static const u32 IndexFileMagic		= 0x49444750;	// "PGDI"
+	static const u32 IndexFileVersion	= 1;
+
+	// Splits the raw file data into lines the same way pxReadLine does.
+	struct LineReader
+	{
+		const char* pos;
+		const char* end;
+
+		bool Next(const char*& start, const char*& stop)
+		{
+			if (pos >= end)
+				return false;
+
+			start = pos;
+			while (pos < end && *pos != '\n' && *pos != '\r' && *pos != 0)
+				pos++;
+			stop = pos;
+
+			if (pos < end)
+				pos += (pos[0] == '\r' && pos + 1 < end && pos[1] == '\n') ? 2 : 1;
+			return true;
+		}
+	};
+}
+
+static void TrimRange(const char*& start, const char*& stop)
+{
+	while (start < stop && isspace((u8)start[0])) start++;
+	while (stop > start && isspace((u8)stop[-1])) stop--;
+}
+
+static bool RangeEqualsNoCase(const char* start, const char* stop, const char* str)
+{
+	for (; start < stop; start++, str++)
+	{
+		if (*str == 0 || tolower((u8)*start) != tolower((u8)*str))
+			return false;
+	}
+	return *str == 0;
+}
+
+static u64 HashData(const std::vector<char>& data)
+{
+	// FNV-1a
+	u64 hash = 0xcbf29ce484222325ull;
+	for (char c : data)
+		hash = (hash ^ (u8)c) * 0x100000001b3ull;
+	return hash;
+}
+
+// Finds the Serial line of every entry, skipping the multiline sections as
+// DBLoaderHelper::extractMultiLine would.
+void AppGameDatabase::BuildIndex()
+{
+	m_index.clear();
+	m_serials.clear();
+
+	const char* base = m_data.data();
+	LineReader reader = { base, base + m_data.size() };
+	const char* start;
+	const char* stop;
+
+	while (reader.Next(start, stop))
+	{
+		const char* lineStart = start;
+		TrimRange(start, stop);
+		if (start == stop)
+			continue;
+
+		if (start[0] == '[')
+		{
+			// a malformed start tag is read as a normal key, which can't be the base key
+			if (stop[-1] != ']')
+				continue;
+
+			const char* name = start + 1;
+			const char* nameEnd = std::find(name, stop - 1, '=');
+			TrimRange(name, nameEnd);
+			const std::string endTag = "[/" + std::string(name, nameEnd) + "]";
+
+			while (reader.Next(start, stop))
+			{
+				if (std::string(start, stop) == "---------------------------------------------" || RangeEqualsNoCase(start, stop, endTag.c_str()))
+					break;
+			}
+			continue;
+		}
+
+		// comments, see pxParseAssignmentString
+		if (stop - start >= 2 && ((start[0] == '-' && start[1] == '-') || (start[0] == '/' && start[1] == '/')))
+			continue;
+		if (start[0] == ';')
+			continue;
+
+		const char* eq = std::find(start, stop, '=');
+		const char* key = start;
+		const char* keyEnd = eq;
+		TrimRange(key, keyEnd);
+		if (!RangeEqualsNoCase(key, keyEnd, "Serial"))
+			continue;
+
+		const char* value = (eq < stop) ? eq + 1 : stop;
+		const char* valueEnd = stop;
+		TrimRange(value, valueEnd);
+
+		if (!m_index.empty())
+			m_index.back().length = (u32)(lineStart - base) - m_index.back().offset;
+
+		IndexEntry entry = { (u32)m_serials.size(), (u32)(valueEnd - value), (u32)(lineStart - base), 0 };
+		m_index.push_back(entry);
+		m_serials.insert(m_serials.end(), value, valueEnd);
+	}
+
+	if (!m_index.empty())
+		m_index.back().length = (u32)m_data.size() - m_index.back().offset;
+
+	const char* serials = m_serials.data();
+	std::stable_sort(m_index.begin(), m_index.end(), [serials](const IndexEntry& a, const IndexEntry& b) {
+		return std::lexicographical_compare(serials + a.serial, serials + a.serial + a.serialLength,
+			serials + b.serial, serials + b.serial + b.serialLength);
+	});
+}
+
+bool AppGameDatabase::LoadIndex(const wxString& file, s64 mtime, u64 hash)
+{
+	if (!wxFileExists(file))
+		return false;
+
+	wxFFile index(file, L"rb");
+	IndexFileHeader header;
+	if (!index.IsOpened() || index.Read(&header, sizeof(header)) != sizeof(header))
+		return false;
+
+	if (header.magic != IndexFileMagic || header.version != IndexFileVersion
+		|| header.dbfSize != m_data.size() || header.dbfTime != mtime || header.dbfHash != hash)
+		return false;
+
+	m_index.resize(header.entryCount);
+	m_serials.resize(header.serialsSize);
+	if (index.Read(m_index.data(), m_index.size() * sizeof(IndexEntry)) != m_index.size() * sizeof(IndexEntry)
+		|| index.Read(m_serials.data(), m_serials.size()) != m_serials.size())
+		return false;
+
+	for (const IndexEntry& entry : m_index)
+	{
+		if ((u64)entry.serial + entry.serialLength > m_serials.size() || (u64)entry.offset + entry.length > m_data.size())
+			return false;
+	}
+	return true;
+}
+
+bool AppGameDatabase::SaveIndex(const wxString& file, s64 mtime, u64 hash) const
+{
+	if (!wxFileName::IsDirWritable(wxFileName(file).GetPath()))
+		return false;
+
+	wxFFile index(file, L"wb");
+	if (!index.IsOpened())
+		return false;
+
+	const IndexFileHeader header = { IndexFileMagic, IndexFileVersion, m_data.size(), mtime, hash, (u32)m_index.size(), (u32)m_serials.size() };
+	return index.Write(&header, sizeof(header)) == sizeof(header)
+		&& index.Write(m_index.data(), m_index.size() * sizeof(IndexEntry)) == m_index.size() * sizeof(IndexEntry)
+		&& index.Write(m_serials.data(), m_serials.size()) == m_serials.size();
+}
+
 // --------------------------------------------------------------------------------------
 //  AppGameDatabase  (implementations)
 // --------------------------------------------------------------------------------------
@@ -158,26 +346,75 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 		return *this;
 	}
 
-	wxFFileInputStream reader( file );
+	u64 qpc_Start = GetCPUTicks();
 
-	if (!reader.IsOk())
+	wxFFile reader( file, L"rb" );
+	m_data.resize( reader.IsOpened() ? reader.Length() : 0 );
+
+	if (!reader.IsOpened() || reader.Read(m_data.data(), m_data.size()) != m_data.size())
 	{
 		//throw Exception::FileNotFound( file );
 		Console.Error(L"(GameDB) Could not access file (permission denied?) [%s]", WX_STR(file));
+		m_data.clear();
+		return *this;
 	}
 
-	DBLoaderHelper loader( reader, *this );
+	const wxDateTime modified( wxFileName(file).GetModificationTime() );
+	const s64 mtime = modified.IsValid() ? modified.GetValue().GetValue() : 0;
+	const u64 hash = HashData(m_data);
+
+	// The index is kept next to the database, or in the settings folder if that's read-only.
+	wxFileName indexFile( file );
+	indexFile.SetExt( L"idx" );
+	const wxString userIndexFile( Path::Combine( GetSettingsFolder(), indexFile.GetFullName() ) );
+
+	if (!LoadIndex(indexFile.GetFullPath(), mtime, hash) && !LoadIndex(userIndexFile, mtime, hash))
+	{
+		BuildIndex();
+		if (!SaveIndex(indexFile.GetFullPath(), mtime, hash) && !SaveIndex(userIndexFile, mtime, hash))
+			Console.Warning(L"(GameDB) Could not save the database index.");
+	}
 
-	u64 qpc_Start = GetCPUTicks();
-	loader.ReadGames();
 	u64 qpc_end = GetCPUTicks();
 
 	Console.WriteLn( "(GameDB) %d games on record (loaded in %ums)",
-		gHash.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
+		m_index.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
 
 	return *this;
 }
 
+// Entries are parsed into gHash the first time they're looked up.
+bool AppGameDatabase::findGame(Game_Data& dest, const wxString& id)
+{
+	ScopedLock lock( m_mtx_Parse );
+
+	if (BaseGameDatabaseImpl::findGame(dest, id))
+		return true;
+
+	const wxCharBuffer serial( id.ToUTF8() );
+	const char* idStart = serial.data();
+	const char* idEnd = idStart + strlen(idStart);
+	const char* serials = m_serials.data();
+
+	auto it = std::lower_bound(m_index.begin(), m_index.end(), 0, [&](const IndexEntry& entry, int) {
+		return std::lexicographical_compare(serials + entry.serial, serials + entry.serial + entry.serialLength, idStart, idEnd);
+	});
+
+	// duplicated serials are merged into one game, as when the whole file was parsed
+	std::string text;
+	for (; it != m_index.end() && it->serialLength == (u32)(idEnd - idStart) && memcmp(serials + it->serial, idStart, it->serialLength) == 0; ++it)
+		text.append(&m_data[it->offset], it->length).append(1, '\n');
+
+	if (text.empty())
+		return false;
+
+	wxMemoryInputStream reader( text.data(), text.size() );
+	DBLoaderHelper loader( reader, *this );
+	loader.ReadGames();
+
+	return BaseGameDatabaseImpl::findGame(dest, id);
+}
+
 AppGameDatabase* Pcsx2App::GetGameDatabase()
 {
 	pxAppResources& res( GetResourceCache() );
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "GameDatabase.h"
+#include "Utilities/Threading.h"
 
 // --------------------------------------------------------------------------------------
 //  AppGameDatabase
@@ -38,6 +39,9 @@
 // After the constructor loads the game data, you can use the
 // GameDatabase class's methods to get the other key's values.
 // Such as dbLoader.getString("Region") returns "NTSC-U"
+//
+// Only the serials are indexed at startup: the index (a sorted serial table pointing into the
+// file) is cached in GameIndex.idx, and a game's entry is parsed the first time it's looked up.
 
 class AppGameDatabase : public BaseGameDatabaseImpl
 {
@@ -51,6 +55,26 @@ public:
 	}
 
 	AppGameDatabase& LoadFromFile(const wxString& file = Path::Combine( PathDefs::GetProgramDataDir(), wxFileName(L"GameIndex.dbf") ), const wxString& key = L"Serial" );
+
+	bool findGame(Game_Data& dest, const wxString& id);
+
+protected:
+	struct IndexEntry
+	{
+		u32 serial;			// offset of the serial in m_serials
+		u32 serialLength;
+		u32 offset;			// entry text in m_data, starting at its Serial line
+		u32 length;
+	};
+
+	Threading::Mutex			m_mtx_Parse;
+	std::vector<char>			m_data;			// contents of GameIndex.dbf
+	std::vector<IndexEntry>		m_index;		// sorted by serial, file order for duplicates
+	std::vector<char>			m_serials;		// UTF-8 serials, not terminated
+
+	void BuildIndex();
+	bool LoadIndex(const wxString& file, s64 mtime, u64 hash);
+	bool SaveIndex(const wxString& file, s64 mtime, u64 hash) const;
 };
 
 static wxString compatToStringWX(int compat) {
@@ -19,12 +19,14 @@
 #include "ConsoleLogger.h"
 #include "MSWstuff.h"
 #include "MTVU.h" // for thread cancellation on shutdown
+#include "IPU/IPU.h"
 
 #include "Utilities/IniInterface.h"
 #include "DebugTools/Debug.h"
 #include "Dialogs/ModalPopups.h"
 
 #include "Debugger/DisassemblyDialog.h"
+#include "CDVD/DiscScanner.h"
 
 #ifndef DISABLE_RECORDING
 #	include "Recording/VirtualPad.h"
@@ -243,6 +245,9 @@ void Pcsx2App::OnInitCmdLine( wxCmdLineParser& parser )
 
 	parser.AddSwitch( wxEmptyString,L"profiling",	_("update options to ease profiling (debug)") );
 
+	parser.AddOption( wxEmptyString,L"scanlib",		_("lists the serial, CRC and name of the disc images in the specified folder, then exits"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"scancache",	_("specifies the cache file used by scanlib"), wxCMD_LINE_VAL_STRING );
+
 	const PluginInfo* pi = tbl_PluginInfo; do {
 		parser.AddOption( wxEmptyString, pi->GetShortname().Lower(),
 			pxsFmt( _("specify the file to use as the %s plugin"), WX_STR(pi->GetShortname()) )
@@ -339,6 +344,9 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 	Startup.ForceWizard		= parser.Found(L"forcewiz");
 	Startup.PortableMode	= parser.Found(L"portable");
 
+	parser.Found(L"scanlib", &Startup.ScanLibrary);
+	parser.Found(L"scancache", &Startup.ScanCache);
+
 	if( parser.GetParamCount() >= 1 )
 	{
 		Startup.IsoFile		= parser.GetParam( 0 );
@@ -420,6 +428,48 @@ protected:
 	}
 };
 
+// --scanlib: indexes a folder of disc images without starting the gui or the emulator.
+// Results are printed to the console and kept in the cache file for the next run.
+static void ScanDiscLibrary( const wxString& folder, wxString cacheFile )
+{
+	if( cacheFile.IsEmpty() )
+		cacheFile = Path::Combine( GetSettingsFolder(), wxFileName(L"DiscScan.cache") );
+
+	std::vector<wxString> files;
+	DiscScanner::FindImages( folder, files );
+	Console.WriteLn( Color_StrongBlack, L"(DiscScanner) %d images in %s", (int)files.size(), WX_STR(folder) );
+
+	DiscScanner scanner;
+	scanner.LoadCache( cacheFile );
+
+	u64 start = GetCPUTicks();
+	int scanned = 0;
+	scanner.Scan( files, 0, [&]( const DiscScanResult& ) {
+		if( ++scanned % 100 == 0 )
+			Console.WriteLn( L"(DiscScanner) %d images scanned...", scanned );
+	} );
+
+	if( IGameDatabase* gameDB = wxGetApp().GetGameDatabase() )
+		scanner.LookupGameDatabase( *gameDB );
+
+	for( const auto& it : scanner.GetResults() )
+	{
+		const DiscScanResult& result = it.second;
+		if( !result.error.IsEmpty() )
+			Console.Warning( L"%s: %s", WX_STR(result.filename), WX_STR(result.error) );
+		else if( result.discType == 0 )
+			Console.WriteLn( L"%s: not a PS1/PS2 disc", WX_STR(result.filename) );
+		else
+			Console.WriteLn( L"%s\t%s\t%08X\t%s", WX_STR(result.filename), WX_STR(result.serial), result.crc, WX_STR(result.name) );
+	}
+
+	Console.WriteLn( Color_StrongBlack, L"(DiscScanner) %d images scanned in %.2f seconds",
+		scanned, (double)(GetCPUTicks() - start) / GetTickFrequency() );
+
+	if( !scanner.SaveCache( cacheFile ) )
+		Console.Error( L"(DiscScanner) Can't write the cache file: " + cacheFile );
+}
+
 bool Pcsx2App::OnInit()
 {
 	EnableAllLogging();
@@ -469,6 +519,13 @@ bool Pcsx2App::OnInit()
 		SysExecutorThread.Start();
 		DetectCpuAndUserMode();
 
+		if( !Startup.ScanLibrary.IsEmpty() )
+		{
+			ScanDiscLibrary( Startup.ScanLibrary, Startup.ScanCache );
+			CleanupOnExit();
+			return false;
+		}
+
 		//   Set Manual Exit Handling
 		// ----------------------------
 		// PCSX2 has a lot of event handling logistics, so we *cannot* depend on wxWidgets automatic event
@@ -747,6 +804,7 @@ Pcsx2App::~Pcsx2App()
 	pxDoAssert = pxAssertImpl_LogIt;	
 	try {
 		vu1Thread.Cancel();
+		ipuWorkerCancel();
 	}
 	DESTRUCTOR_CATCHALL
 }
@@ -759,6 +817,8 @@ void Pcsx2App::CleanUp()
 
 	DisableDiskLogging();
 
+	BinaryTrace::Shutdown();
+
 	if( emuLog != NULL )
 	{
 		fclose( emuLog );
@@ -61,3 +61,6 @@ extern void StateCopy_SaveToFile( const wxString& file );
 extern void StateCopy_LoadFromFile( const wxString& file );
 extern void StateCopy_SaveToSlot( uint num );
 extern void StateCopy_LoadFromSlot( uint slot, bool isFromBackup = false );
+extern void StateCopy_SaveToMemory();
+extern void StateCopy_LoadFromMemory( uint age = 0 );
+extern void StateCopy_ClearMemorySnapshots();
@@ -652,6 +652,20 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"States_SnapshotToMemory",
+		States_SnapshotToMemory,
+		pxL( "Save memory snapshot" ),
+		pxL( "Saves the virtual machine state to the in-memory snapshot ring." ),
+		false,
+	},
+
+	{	"States_RestoreFromMemory",
+		States_RestoreFromMemory,
+		pxL( "Restore memory snapshot" ),
+		pxL( "Restores the most recent in-memory snapshot." ),
+		false,
+	},
+
 	{	"Frameskip_Toggle",
 		Implementations::Frameskip_Toggle,
 		NULL,
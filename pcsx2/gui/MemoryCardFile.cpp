@@ -41,6 +41,13 @@ struct Component_FileMcd;
 #include <wx/ffile.h>
 #include <map>
 
+#ifdef _WIN32
+#	include "Utilities/RedtapeWindows.h"
+#	include <io.h>
+#else
+#	include <sys/mman.h>
+#endif
+
 static const int MCD_SIZE	= 1024 *  8  * 16;		// Legacy PSX card default size
 
 static const int MC2_MBSIZE	= 1024 * 528 * 2;		// Size of a single megabyte of card data
@@ -50,8 +57,16 @@ static const int MC2_MBSIZE	= 1024 * 528 * 2;		// Size of a single megabyte of c
 // --------------------------------------------------------------------------------------
 // Provides thread-safe direct file IO mapping.
 //
+// Cards are memory mapped when possible, so that SIO writes are plain memory stores.  Dirty
+// pages are handed to the OS for write back (without waiting for it) once the game hasn't
+// written for FramesAfterWriteUntilFlush frames.  If mapping fails the card falls back to
+// file reads and writes.
+//
 class FileMemoryCard
 {
+public:
+	static const int FramesAfterWriteUntilFlush = 2;
+
 protected:
 	wxFFile			m_file[8];
 	u8				m_effeffs[528*16];
@@ -60,6 +75,15 @@ protected:
 	bool			m_ispsx[8];
 	u32				m_chkaddr;
 
+	u8*				m_map[8];			// NULL when the card uses file IO
+	u32				m_mapsize[8];
+#ifdef _WIN32
+	HANDLE			m_mapping[8];
+#endif
+	u32				m_dirtyStart[8];	// byte range written since the last flush
+	u32				m_dirtyEnd[8];
+	int				m_framesUntilFlush[8];
+
 public:
 	FileMemoryCard();
 	virtual ~FileMemoryCard() = default;
@@ -77,11 +101,19 @@ public:
 	s32  Save		( uint slot, const u8 *src, u32 adr, int size );
 	s32  EraseBlock	( uint slot, u32 adr );
 	u64  GetCRC		( uint slot );
+	void NextFrame	( uint slot );
 
 protected:
 	bool Seek( wxFFile& f, u32 adr );
 	bool Create( const wxString& mcdFile, uint sizeInMB );
 
+	u32  GetOffset( u32 filesize ) const;
+	u8*  GetMapped( uint slot, u32 adr, int size );
+	bool Map( uint slot );
+	void Unmap( uint slot );
+	void Flush( uint slot, bool wait );
+	void SetDirty( uint slot, const u8* data, int size );
+
 	wxString GetDisabledMessage( uint slot ) const
 	{
 		return wxsFormat( pxE( L"The PS2-slot %d has been automatically disabled.  You can correct the problem\nand re-enable it at any time using Config:Memory cards from the main menu."
@@ -147,6 +179,17 @@ FileMemoryCard::FileMemoryCard()
 {
 	memset8<0xff>( m_effeffs );
 	m_chkaddr = 0;
+
+	for( int slot=0; slot<8; ++slot )
+	{
+		m_map[slot] = NULL;
+		m_mapsize[slot] = 0;
+#ifdef _WIN32
+		m_mapping[slot] = NULL;
+#endif
+		m_dirtyStart[slot] = m_dirtyEnd[slot] = 0;
+		m_framesUntilFlush[slot] = 0;
+	}
 }
 
 void FileMemoryCard::Open()
@@ -220,7 +263,14 @@ void FileMemoryCard::Open()
 			m_ispsx[slot] = m_file[slot].Length() == 0x20000;
 			m_chkaddr = 0x210;
 
-			if(!m_ispsx[slot] && !!m_file[slot].Seek( m_chkaddr ))
+			if( !Map( slot ) )
+				Console.Warning( L"(FileMcd) Could not map memory card, using file access: " + str );
+
+			if( m_ispsx[slot] ) continue;
+
+			if( m_map[slot] && m_chkaddr + 8 <= m_mapsize[slot] )
+				memcpy( &m_chksum[slot], m_map[slot] + m_chkaddr, 8 );
+			else if( !!m_file[slot].Seek( m_chkaddr ) )
 				m_file[slot].Read( &m_chksum[slot], 8 );
 		}
 	}
@@ -232,19 +282,137 @@ void FileMemoryCard::Close()
 	{
 		if (m_file[slot].IsOpened()) {
 			// Store checksum
-			if(!m_ispsx[slot] && !!m_file[slot].Seek(  m_chkaddr ))
-				m_file[slot].Write( &m_chksum[slot], 8 );
+			if( !m_ispsx[slot] )
+			{
+				if( m_map[slot] && m_chkaddr + 8 <= m_mapsize[slot] )
+				{
+					memcpy( m_map[slot] + m_chkaddr, &m_chksum[slot], 8 );
+					SetDirty( slot, m_map[slot] + m_chkaddr, 8 );
+				}
+				else if( !!m_file[slot].Seek( m_chkaddr ) )
+					m_file[slot].Write( &m_chksum[slot], 8 );
+			}
 
+			Unmap( slot );
 			m_file[slot].Close();
 		}
 	}
 }
 
-// Returns FALSE if the seek failed (is outside the bounds of the file).
-bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
+bool FileMemoryCard::Map( uint slot )
+{
+	const wxFileOffset size = m_file[slot].Length();
+	if( size <= 0 || size > 0x7fffffff ) return false;
+
+	// the mapping sees the file directly, nothing may linger in the stdio buffers
+	m_file[slot].Flush();
+	FILE* fp = m_file[slot].fp();
+
+#ifdef _WIN32
+	HANDLE file = (HANDLE)_get_osfhandle( _fileno( fp ) );
+	if( file == INVALID_HANDLE_VALUE ) return false;
+
+	m_mapping[slot] = CreateFileMapping( file, NULL, PAGE_READWRITE, 0, 0, NULL );
+	if( !m_mapping[slot] ) return false;
+
+	void* ptr = MapViewOfFile( m_mapping[slot], FILE_MAP_WRITE, 0, 0, 0 );
+	if( !ptr )
+	{
+		CloseHandle( m_mapping[slot] );
+		m_mapping[slot] = NULL;
+		return false;
+	}
+#else
+	void* ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno( fp ), 0 );
+	if( ptr == MAP_FAILED ) return false;
+#endif
+
+	m_map[slot] = (u8*)ptr;
+	m_mapsize[slot] = (u32)size;
+	m_dirtyStart[slot] = m_dirtyEnd[slot] = 0;
+	m_framesUntilFlush[slot] = 0;
+	return true;
+}
+
+void FileMemoryCard::Unmap( uint slot )
+{
+	if( !m_map[slot] ) return;
+
+	Flush( slot, true );
+
+#ifdef _WIN32
+	UnmapViewOfFile( m_map[slot] );
+	CloseHandle( m_mapping[slot] );
+	m_mapping[slot] = NULL;
+#else
+	munmap( m_map[slot], m_mapsize[slot] );
+#endif
+
+	m_map[slot] = NULL;
+	m_mapsize[slot] = 0;
+}
+
+// Hands the dirty range to the OS.  Unless wait is set this only queues the write back, so
+// it's cheap enough to call from the emulation thread.
+void FileMemoryCard::Flush( uint slot, bool wait )
+{
+	m_framesUntilFlush[slot] = 0;
+	if( !m_map[slot] || m_dirtyStart[slot] >= m_dirtyEnd[slot] ) return;
+
+	static const u32 PageMask = 0xfff;	// msync needs a page aligned start
+	const u32 start = m_dirtyStart[slot] & ~PageMask;
+	const u32 length = m_dirtyEnd[slot] - start;
+
+#ifdef _WIN32
+	FlushViewOfFile( m_map[slot] + start, length );
+	if( wait )
+		FlushFileBuffers( (HANDLE)_get_osfhandle( _fileno( m_file[slot].fp() ) ) );
+#else
+	msync( m_map[slot] + start, length, wait ? MS_SYNC : MS_ASYNC );
+#endif
+
+	m_dirtyStart[slot] = m_dirtyEnd[slot] = 0;
+}
+
+// Marks a range of the mapping for the next flush.
+void FileMemoryCard::SetDirty( uint slot, const u8* data, int size )
 {
-	const u32 size = f.Length();
+	const u32 start = data - m_map[slot];
+	const u32 end = start + size;
+
+	if( m_dirtyStart[slot] >= m_dirtyEnd[slot] )
+	{
+		m_dirtyStart[slot] = start;
+		m_dirtyEnd[slot] = end;
+	}
+	else
+	{
+		m_dirtyStart[slot] = std::min( m_dirtyStart[slot], start );
+		m_dirtyEnd[slot] = std::max( m_dirtyEnd[slot], end );
+	}
 
+	m_framesUntilFlush[slot] = FramesAfterWriteUntilFlush;
+}
+
+// Returns NULL if the card isn't mapped or the range is outside of the file.
+u8* FileMemoryCard::GetMapped( uint slot, u32 adr, int size )
+{
+	if( !m_map[slot] || size < 0 ) return NULL;
+
+	const u64 start = (u64)adr + GetOffset( m_mapsize[slot] );
+	if( start + size > m_mapsize[slot] ) return NULL;
+
+	return m_map[slot] + start;
+}
+
+void FileMemoryCard::NextFrame( uint slot )
+{
+	if( m_framesUntilFlush[slot] > 0 && --m_framesUntilFlush[slot] == 0 )
+		Flush( slot, false );
+}
+
+u32 FileMemoryCard::GetOffset( u32 size ) const
+{
 	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
 	// cards, perhaps hacked support for some special emulator-specific memcard formats that
 	// had header info?), then please replace this comment with something useful.  Thanks!  -- air
@@ -260,7 +428,13 @@ bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
 		// perform sanity checks here?
 	}
 
-	return f.Seek( adr + offset );
+	return offset;
+}
+
+// Returns FALSE if the seek failed (is outside the bounds of the file).
+bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
+{
+	return f.Seek( adr + GetOffset( f.Length() ) );
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -315,10 +489,61 @@ s32 FileMemoryCard::Read( uint slot, u8 *dest, u32 adr, int size )
 		memset(dest, 0, size);
 		return 1;
 	}
+
+	if( m_map[slot] )
+	{
+		const u8* data = GetMapped( slot, adr, size );
+		if( !data ) return 0;
+		memcpy( dest, data, size );
+		return 1;
+	}
+
 	if( !Seek(mcfp, adr) ) return 0;
 	return mcfp.Read( dest, size ) != 0;
 }
 
+// Flash can only clear bits: dest &= src.  Returns the XOR of the resulting 64 bit words
+// (for the checksum) and sets uncleared if src had bits set that dest didn't.
+static u64 ApplyWriteMask( u8* dest, const u8* src, int size, bool& uncleared )
+{
+	__m128i bad = _mm_setzero_si128();
+	__m128i sum = _mm_setzero_si128();
+
+	int i = 0;
+	for( ; i + 16 <= size; i += 16 )
+	{
+		const __m128i s = _mm_loadu_si128( (const __m128i*)(src + i) );
+		const __m128i d = _mm_and_si128( _mm_loadu_si128( (const __m128i*)(dest + i) ), s );
+
+		bad = _mm_or_si128( bad, _mm_xor_si128( d, s ) );
+		sum = _mm_xor_si128( sum, d );
+		_mm_storeu_si128( (__m128i*)(dest + i), d );
+	}
+
+	u64 lanes[2];
+	_mm_storeu_si128( (__m128i*)lanes, sum );
+	u64 chksum = lanes[0] ^ lanes[1];
+	_mm_storeu_si128( (__m128i*)lanes, bad );
+	u8 badtail = 0;
+
+	for( ; i < size; ++i )
+	{
+		badtail |= (dest[i] & src[i]) ^ src[i];
+		dest[i] &= src[i];
+	}
+
+	// the checksum only covers whole words, as it always did
+	for( int w = (size & ~15); w + 8 <= size; w += 8 )
+	{
+		u64 word;
+		memcpy( &word, dest + w, 8 );
+		chksum ^= word;
+	}
+
+	uncleared = (lanes[0] | lanes[1] | badtail) != 0;
+	return chksum;
+}
+
 s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 {
 	wxFFile& mcfp( m_file[slot] );
@@ -329,41 +554,51 @@ s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 		return 1;
 	}
 
-	if(m_ispsx[slot])
+	u8* data;
+	if( m_map[slot] )
 	{
-		m_currentdata.MakeRoomFor( size );
-		for (int i=0; i<size; i++) m_currentdata[i] = src[i];
+		data = GetMapped( slot, adr, size );
+		if( !data ) return 0;
 	}
 	else
 	{
-		if( !Seek(mcfp, adr) ) return 0;
 		m_currentdata.MakeRoomFor( size );
-		mcfp.Read( m_currentdata.GetPtr(), size);
-		
+		data = m_currentdata.GetPtr();
+	}
 
-		for (int i=0; i<size; i++)
+	if(m_ispsx[slot])
+	{
+		memcpy( data, src, size );
+	}
+	else
+	{
+		if( !m_map[slot] )
 		{
-			if ((m_currentdata[i] & src[i]) != src[i])
-				Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
-			m_currentdata[i] &= src[i];
+			if( !Seek(mcfp, adr) ) return 0;
+			mcfp.Read( data, size );
 		}
 
-		// Checksumness
-		{
-			if(adr == m_chkaddr) 
-				Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
+		bool uncleared;
+		m_chksum[slot] ^= ApplyWriteMask( data, src, size, uncleared );
 
-			u64 *pdata = (u64*)&m_currentdata[0];
-			u32 loops = size / 8;
+		if( uncleared )
+			Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
 
-			for(u32 i = 0; i < loops; i++)
-				m_chksum[slot] ^= pdata[i];
-		}
+		if(adr == m_chkaddr) 
+			Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
-
-	int status = mcfp.Write( m_currentdata.GetPtr(), size );
+	int status;
+	if( m_map[slot] )
+	{
+		SetDirty( slot, data, size );
+		status = 1;
+	}
+	else
+	{
+		if( !Seek(mcfp, adr) ) return 0;
+		status = mcfp.Write( data, size );
+	}
 
 	if( status ) {
 		static auto last = std::chrono::time_point<std::chrono::system_clock>();
@@ -391,6 +626,15 @@ s32 FileMemoryCard::EraseBlock( uint slot, u32 adr )
 		return 1;
 	}
 
+	if( m_map[slot] )
+	{
+		u8* data = GetMapped( slot, adr, sizeof(m_effeffs) );
+		if( !data ) return 0;
+		memcpy( data, m_effeffs, sizeof(m_effeffs) );
+		SetDirty( slot, data, sizeof(m_effeffs) );
+		return 1;
+	}
+
 	if( !Seek(mcfp, adr) ) return 0;
 	return mcfp.Write( m_effeffs, sizeof(m_effeffs) ) != 0;
 }
@@ -402,7 +646,15 @@ u64 FileMemoryCard::GetCRC( uint slot )
 
 	u64 retval = 0;
 
-	if(m_ispsx[slot])
+	if(m_ispsx[slot] && m_map[slot])
+	{
+		// same whole 528*8 word chunks as the file path below (PSX cards have no header offset)
+		const u64* data = (const u64*)m_map[slot];
+		const uint words = m_mapsize[slot] / (528*8*8) * (528*8);
+		for( uint t=0; t<words; ++t )
+			retval ^= data[t];
+	}
+	else if(m_ispsx[slot])
 	{
 		if( !Seek( mcfp, 0 ) ) return 0;
 
@@ -571,9 +823,9 @@ static u64 PS2E_CALLBACK FileMcd_GetCRC( PS2E_THISPTR thisptr, uint port, uint s
 static void PS2E_CALLBACK FileMcd_NextFrame( PS2E_THISPTR thisptr, uint port, uint slot ) {
 	const uint combinedSlot = FileMcd_ConvertToSlot( port, slot );
 	switch ( g_Conf->Mcd[combinedSlot].Type ) {
-	//case MemoryCardType::MemoryCard_File:
-	//	thisptr->impl.NextFrame( combinedSlot );
-	//	break;
+	case MemoryCardType::MemoryCard_File:
+		thisptr->impl.NextFrame( combinedSlot );
+		break;
 	case MemoryCardType::MemoryCard_Folder:
 		thisptr->implFolder.NextFrame( combinedSlot );
 		break;
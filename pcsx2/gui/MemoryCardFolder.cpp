@@ -34,16 +34,27 @@ FolderMemoryCard::FolderMemoryCard() {
 	m_timeLastWritten = 0;
 	m_filteringEnabled = false;
 	m_filteringString = L"";
+	m_dirtyPageCount = 0;
+	m_flushRunning = false;
+	m_flushOpsDone = false;
+	m_flush.timeStart = 0;
+	m_flush.timeEnd = 0;
+	m_flush.report = false;
+}
+
+FolderMemoryCard::~FolderMemoryCard() {
+	FinishFlush();
 }
 
 void FolderMemoryCard::InitializeInternalData() {
+	FinishFlush();
+
 	memset( &m_superBlock, 0xFF, sizeof( m_superBlock ) );
 	memset( &m_indirectFat, 0xFF, sizeof( m_indirectFat ) );
 	memset( &m_fat, 0xFF, sizeof( m_fat ) );
 	memset( &m_backupBlock1, 0xFF, sizeof( m_backupBlock1 ) );
 	memset( &m_backupBlock2, 0xFF, sizeof( m_backupBlock2 ) );
-	m_cache.clear();
-	m_oldDataCache.clear();
+	ClearCache();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 	m_timeLastWritten = 0;
@@ -109,12 +120,12 @@ void FolderMemoryCard::Open( const wxString& fullPath, const AppConfig::McdOptio
 void FolderMemoryCard::Close( bool flush ) {
 	if ( !m_isEnabled ) { return; }
 
+	FinishFlush();
 	if ( flush ) {
 		Flush();
 	}
 
-	m_cache.clear();
-	m_oldDataCache.clear();
+	ClearCache();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 }
@@ -145,7 +156,9 @@ void FolderMemoryCard::LoadMemoryCardData( const u32 sizeInClusters, const bool
 
 	if ( sizeInClusters > 0 && sizeInClusters != GetSizeInClusters() ) {
 		SetSizeInClusters( sizeInClusters );
+		BeginFlush();
 		FlushBlock( 0 );
+		FinishFlush();
 	}
 
 	// if superblock was valid, load folders and files
@@ -725,8 +738,17 @@ bool FolderMemoryCard::ReadFromFile( u8 *dest, u32 adr, u32 dataLength ) {
 	// figure out which file to read from
 	auto it = m_fileMetadataQuickAccess.find( fatCluster );
 	if ( it != m_fileMetadataQuickAccess.end() ) {
+		FileAccessHelper* files = &m_lastAccessedFile;
+		if ( m_flushThread.joinable() ) {
+			// the flush thread owns m_lastAccessedFile while it's writing, but the pages it writes are still cached,
+			// so this one isn't among them. once the renames and deletes are done it can be read through a second handle.
+			std::unique_lock<std::mutex> lock( m_flushOpsLock );
+			m_flushOpsDoneCond.wait( lock, [this]() { return m_flushOpsDone; } );
+			files = &m_flushReadFile;
+		}
+
 		const u32 clusterNumber = it->second.consecutiveCluster;
-		wxFFile* file = m_lastAccessedFile.ReOpen( m_folderName, &it->second );
+		wxFFile* file = files->ReOpen( m_folderName, &it->second );
 		if ( file->IsOpened() ) {
 			const u32 clusterOffset = ( page % 2 ) * PageSize + offset;
 			const u32 fileOffset = clusterNumber * ClusterSize + clusterOffset;
@@ -768,9 +790,9 @@ s32 FolderMemoryCard::Read( u8 *dest, u32 adr, int size ) {
 		const u32 dataLength = std::min( (u32)size, (u32)( PageSize - offset ) );
 
 		// if we have a cache for this page, just load from that
-		auto it = m_cache.find( page );
-		if ( it != m_cache.end() ) {
-			memcpy( dest, &it->second.raw[offset], dataLength );
+		const MemoryCardPage* cachePage = GetCachedPage( page );
+		if ( cachePage ) {
+			memcpy( dest, &cachePage->raw[offset], dataLength );
 		} else {
 			ReadDataWithoutCache( dest, adr, dataLength );
 		}
@@ -832,19 +854,16 @@ s32 FolderMemoryCard::Save( const u8 *src, u32 adr, int size ) {
 		const u32 dataLength = std::min( (u32)size, PageSize - offset );
 
 		// if cache page has not yet been touched, fill it with the data from our memory card
-		auto it = m_cache.find( page );
-		MemoryCardPage* cachePage;
-		if ( it == m_cache.end() ) {
-			cachePage = &m_cache[page];
-			const u32 adrLoad = page * PageSizeRaw;
-			ReadDataWithoutCache( &cachePage->raw[0], adrLoad, PageSize );
-			memcpy( &m_oldDataCache[page].raw[0], &cachePage->raw[0], PageSize );
-		} else {
-			cachePage = &it->second;
+		MemoryCardPage* cachePage = GetCachedPage( page );
+		if ( !cachePage ) {
+			u8 data[PageSize];
+			ReadDataWithoutCache( data, page * PageSizeRaw, PageSize );
+			cachePage = AddCachedPage( page, data );
 		}
 
 		// then just write to the cache
 		memcpy( &cachePage->raw[offset], src, dataLength );
+		SetPageDirty( page );
 
 		SetTimeLastWrittenToNow();
 	}
@@ -853,24 +872,137 @@ s32 FolderMemoryCard::Save( const u8 *src, u32 adr, int size ) {
 }
 
 void FolderMemoryCard::NextFrame() {
+	if ( m_flushThread.joinable() && !m_flushRunning ) {
+		FinishFlush();
+	}
+
 	if ( m_framesUntilFlush > 0 && --m_framesUntilFlush == 0 ) {
-		Flush();
+		if ( m_flushThread.joinable() ) {
+			// previous flush is still writing, try again next frame
+			m_framesUntilFlush = 1;
+		} else {
+			Flush( true );
+		}
+	}
+}
+
+MemoryCardPage* FolderMemoryCard::GetCachedPage( const u32 page ) {
+	if ( page >= m_cacheIndex.size() || m_cacheIndex[page] == InvalidCacheSlot ) {
+		return nullptr;
 	}
+	return &m_cachePages[m_cacheIndex[page]];
+}
+
+MemoryCardPage* FolderMemoryCard::AddCachedPage( const u32 page, const u8* data ) {
+	if ( page >= m_cacheIndex.size() ) {
+		const size_t pageCount = std::max( (size_t)page + 1, (size_t)GetSizeInClusters() * 2 );
+		m_cacheIndex.resize( pageCount, InvalidCacheSlot );
+		m_dirtyPages.resize( ( pageCount + 63 ) / 64, 0 );
+	}
+
+	u32 slot;
+	if ( !m_freeCacheSlots.empty() ) {
+		slot = m_freeCacheSlots.back();
+		m_freeCacheSlots.pop_back();
+	} else {
+		slot = m_cachePages.size();
+		m_cachePages.emplace_back();
+		m_oldDataPages.emplace_back();
+	}
+
+	memcpy( &m_cachePages[slot].raw[0], data, PageSize );
+	memcpy( &m_oldDataPages[slot].raw[0], data, PageSize );
+	m_cacheIndex[page] = slot;
+	return &m_cachePages[slot];
+}
+
+void FolderMemoryCard::RemoveCachedPage( const u32 page ) {
+	m_freeCacheSlots.push_back( m_cacheIndex[page] );
+	m_cacheIndex[page] = InvalidCacheSlot;
+}
+
+void FolderMemoryCard::ClearCache() {
+	m_cacheIndex.clear();
+	m_cachePages.clear();
+	m_oldDataPages.clear();
+	m_freeCacheSlots.clear();
+	m_dirtyPages.clear();
+	m_dirtyPageCount = 0;
+}
+
+bool FolderMemoryCard::IsPageDirty( const u32 page ) const {
+	return ( m_dirtyPages[page / 64] >> ( page % 64 ) ) & 1;
+}
+
+void FolderMemoryCard::SetPageDirty( const u32 page ) {
+	if ( !IsPageDirty( page ) ) {
+		m_dirtyPages[page / 64] |= 1ull << ( page % 64 );
+		++m_dirtyPageCount;
+	}
+}
+
+bool FolderMemoryCard::IsPageInFlush( const u32 page ) const {
+	return page < m_flush.index.size() && m_flush.index[page] != InvalidCacheSlot;
 }
 
-void FolderMemoryCard::Flush() {
-	if ( m_cache.empty() ) { return; }
+void FolderMemoryCard::Flush( bool async ) {
+	FinishFlush();
+	if ( m_dirtyPageCount == 0 ) { return; }
 
 	#ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 	WriteToFile( m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format( L"%Y-%m-%d-%H-%M-%S" ) + L"_pre-flush.ps2" );
 	#endif
 
 	Console.WriteLn( L"(FolderMcd) Writing data for slot %u to file system...", m_slot );
-	const u64 timeFlushStart = wxGetLocalTimeMillis().GetValue();
+	m_flush.timeStart = wxGetLocalTimeMillis().GetValue();
+	m_flush.report = true;
+
+	BeginFlush();
+	FlushInternalData();
+
+	if ( async && !( m_flush.fileOps.empty() && m_flush.fileWrites.empty() ) ) {
+		m_flushRunning = true;
+		m_flushOpsDone = false;
+		m_flushThread = std::thread( &FolderMemoryCard::FlushFiles, this );
+	} else {
+		FlushFiles();
+		FinishFlush();
+	}
+}
+
+void FolderMemoryCard::BeginFlush() {
+	m_flush.index.assign( m_cacheIndex.size(), InvalidCacheSlot );
+
+	for ( size_t i = 0; i < m_dirtyPages.size(); ++i ) {
+		const u64 bits = m_dirtyPages[i];
+		if ( bits == 0 ) { continue; }
+		m_dirtyPages[i] = 0;
+
+		for ( u32 bit = 0; bit < 64; ++bit ) {
+			if ( ( bits >> bit ) & 1 ) {
+				const u32 page = i * 64 + bit;
+				m_flush.index[page] = m_flush.pages.size();
+				m_flush.pages.push_back( page );
+				m_flush.data.push_back( m_cachePages[m_cacheIndex[page]] );
+			}
+		}
+	}
+
+	m_flush.flushed.assign( m_flush.pages.size(), false );
+	m_dirtyPageCount = 0;
+}
+
+void FolderMemoryCard::FlushInternalData() {
+	// Games mostly rewrite the data of existing files. If none of the snapshot is superblock, FAT or directory data
+	// the host file system layout is unchanged and we can skip walking the directory tree.
+	bool metadataChanged = false;
+	for ( size_t i = 0; i < m_flush.pages.size() && !metadataChanged; ++i ) {
+		metadataChanged = GetSystemBlockPointer( m_flush.pages[i] * PageSizeRaw ) != nullptr;
+	}
 
 	// Keep a copy of the old file entries so we can figure out which files and directories, if any, have been deleted from the memory card.
 	std::vector<MemoryCardFileEntryTreeNode> oldFileEntryTree;
-	if ( IsFormatted() ) {
+	if ( metadataChanged && IsFormatted() ) {
 		CopyEntryDictIntoTree( &oldFileEntryTree, m_superBlock.data.rootdir_cluster, m_fileEntryDict[m_superBlock.data.rootdir_cluster].entries[0].entry.data.length );
 	}
 
@@ -886,58 +1018,122 @@ void FolderMemoryCard::Flush() {
 		return;
 	}
 
-	const u32 clusterCount = GetSizeInClusters();
-	const u32 pageCount = clusterCount * 2;
-
-	// then write the indirect FAT
-	for ( int i = 0; i < IndirectFatClusterCount; ++i ) {
-		const u32 cluster = m_superBlock.data.ifc_list[i];
-		if ( cluster > 0 && cluster < clusterCount ) {
-			FlushCluster( cluster );
-		}
-	}
+	if ( metadataChanged ) {
+		const u32 clusterCount = GetSizeInClusters();
 
-	// and the FAT
-	for ( int i = 0; i < IndirectFatClusterCount; ++i ) {
-		for ( int j = 0; j < ClusterSize / 4; ++j ) {
-			const u32 cluster = m_indirectFat.data[i][j];
+		// then write the indirect FAT
+		for ( int i = 0; i < IndirectFatClusterCount; ++i ) {
+			const u32 cluster = m_superBlock.data.ifc_list[i];
 			if ( cluster > 0 && cluster < clusterCount ) {
 				FlushCluster( cluster );
 			}
 		}
-	}
 
-	// then all directory and file entries
-	FlushFileEntries();
+		// and the FAT
+		for ( int i = 0; i < IndirectFatClusterCount; ++i ) {
+			for ( int j = 0; j < ClusterSize / 4; ++j ) {
+				const u32 cluster = m_indirectFat.data[i][j];
+				if ( cluster > 0 && cluster < clusterCount ) {
+					FlushCluster( cluster );
+				}
+			}
+		}
 
-	// Now we have the new file system, compare it to the old one and "delete" any files that were in it before but aren't anymore.
-	FlushDeletedFilesAndRemoveUnchangedDataFromCache( oldFileEntryTree );
+		// then all directory and file entries
+		FlushFileEntries();
+
+		// Now we have the new file system, compare it to the old one and "delete" any files that were in it before but aren't anymore.
+		FlushDeletedFilesAndRemoveUnchangedDataFromCache( oldFileEntryTree );
+	} else {
+		// every page still belongs to the file it was read from, so pages that are back to their old contents can be skipped
+		for ( size_t i = 0; i < m_flush.pages.size(); ++i ) {
+			const u32 slot = m_cacheIndex[m_flush.pages[i]];
+			if ( memcmp( &m_flush.data[i].raw[0], &m_oldDataPages[slot].raw[0], PageSize ) == 0 ) {
+				m_flush.flushed[i] = true;
+			}
+		}
+	}
 
 	// and finally, flush everything that hasn't been flushed yet
-	for ( uint i = 0; i < pageCount; ++i ) {
-		FlushPage( i );
+	for ( size_t i = 0; i < m_flush.pages.size(); ++i ) {
+		FlushPage( m_flush.pages[i] );
+	}
+}
+
+void FolderMemoryCard::FlushFiles() {
+	for ( auto& op : m_flush.fileOps ) {
+		op();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_flushOpsLock );
+		m_flushOpsDone = true;
+	}
+	m_flushOpsDoneCond.notify_all();
+
+	for ( const u32 pos : m_flush.fileWrites ) {
+		WriteToFile( &m_flush.data[pos].raw[0], m_flush.pages[pos] * PageSizeRaw, PageSize );
 	}
 
 	m_lastAccessedFile.FlushAll();
 	m_lastAccessedFile.ClearMetadataWriteState();
-	m_oldDataCache.clear();
 
-	const u64 timeFlushEnd = wxGetLocalTimeMillis().GetValue();
-	Console.WriteLn( L"(FolderMcd) Done! Took %u ms.", timeFlushEnd - timeFlushStart );
+	m_flush.timeEnd = wxGetLocalTimeMillis().GetValue();
+	m_flushRunning = false;
+}
 
-	#ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
-	WriteToFile( m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format( L"%Y-%m-%d-%H-%M-%S" ) + L"_post-flush.ps2" );
-	#endif
+void FolderMemoryCard::FinishFlush() {
+	if ( m_flushThread.joinable() ) {
+		m_flushThread.join();
+		m_flushReadFile.CloseAll();
+	}
+
+	for ( size_t i = 0; i < m_flush.pages.size(); ++i ) {
+		const u32 page = m_flush.pages[i];
+		if ( IsPageDirty( page ) ) {
+			// written again during the flush, the flushed data is what the file system holds now
+			if ( m_flush.flushed[i] ) {
+				memcpy( &m_oldDataPages[m_cacheIndex[page]].raw[0], &m_flush.data[i].raw[0], PageSize );
+			}
+		} else if ( m_flush.flushed[i] ) {
+			RemoveCachedPage( page );
+		} else {
+			// flush was aborted, keep it for the next one
+			SetPageDirty( page );
+		}
+	}
+
+	if ( m_flush.report ) {
+		Console.WriteLn( L"(FolderMcd) Done! Took %u ms.", m_flush.timeEnd - m_flush.timeStart );
+
+		#ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
+		WriteToFile( m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format( L"%Y-%m-%d-%H-%M-%S" ) + L"_post-flush.ps2" );
+		#endif
+	}
+
+	m_flush.pages.clear();
+	m_flush.data.clear();
+	m_flush.index.clear();
+	m_flush.flushed.clear();
+	m_flush.fileOps.clear();
+	m_flush.fileWrites.clear();
+	m_flush.report = false;
 }
 
 bool FolderMemoryCard::FlushPage( const u32 page ) {
-	auto it = m_cache.find( page );
-	if ( it != m_cache.end() ) {
-		WriteWithoutCache( &it->second.raw[0], page * PageSizeRaw, PageSize );
-		m_cache.erase( it );
-		return true;
+	if ( !IsPageInFlush( page ) ) { return false; }
+
+	const u32 pos = m_flush.index[page];
+	if ( m_flush.flushed[pos] ) { return false; }
+	m_flush.flushed[pos] = true;
+
+	u8* dest = GetSystemBlockPointer( page * PageSizeRaw );
+	if ( dest != nullptr ) {
+		memcpy( dest, &m_flush.data[pos].raw[0], PageSize );
+	} else {
+		m_flush.fileWrites.push_back( pos );
 	}
-	return false;
+	return true;
 }
 
 bool FolderMemoryCard::FlushCluster( const u32 cluster ) {
@@ -959,11 +1155,14 @@ bool FolderMemoryCard::FlushBlock( const u32 block ) {
 
 void FolderMemoryCard::FlushSuperBlock() {
 	if ( FlushBlock( 0 ) && m_performFileWrites ) {
-		wxFileName superBlockFileName( m_folderName.GetPath(), L"_pcsx2_superblock" );
-		wxFFile superBlockFile( superBlockFileName.GetFullPath().c_str(), L"wb" );
-		if ( superBlockFile.IsOpened() ) {
-			superBlockFile.Write( &m_superBlock.raw, sizeof( m_superBlock.raw ) );
-		}
+		const wxFileName superBlockFileName( m_folderName.GetPath(), L"_pcsx2_superblock" );
+		const std::vector<u8> superBlock( m_superBlock.raw, m_superBlock.raw + sizeof( m_superBlock.raw ) );
+		m_flush.fileOps.push_back( [superBlockFileName, superBlock]() {
+			wxFFile superBlockFile( superBlockFileName.GetFullPath().c_str(), L"wb" );
+			if ( superBlockFile.IsOpened() ) {
+				superBlockFile.Write( superBlock.data(), superBlock.size() );
+			}
+		} );
 	}
 }
 
@@ -979,7 +1178,9 @@ void FolderMemoryCard::FlushFileEntries() {
 
 void FolderMemoryCard::FlushFileEntries( const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath, MemoryCardFileMetadataReference* parent ) {
 	// flush the current cluster
-	FlushCluster( dirCluster + m_superBlock.data.alloc_offset );
+	const u32 cardCluster = dirCluster + m_superBlock.data.alloc_offset;
+	const bool entriesChanged = IsPageInFlush( cardCluster * 2 ) || IsPageInFlush( cardCluster * 2 + 1 );
+	FlushCluster( cardCluster );
 
 	// if either of the current entries is a subdir, flush that too
 	MemoryCardFileEntryCluster* entries = &m_fileEntryDict[dirCluster];
@@ -994,23 +1195,29 @@ void FolderMemoryCard::FlushFileEntries( const u32 dirCluster, const u32 remaini
 				const wxString subDirName = wxString::FromAscii( (const char*)cleanName );
 				const wxString subDirPath = dirPath + L"/" + subDirName;
 
-				if ( m_performFileWrites ) {
+				if ( m_performFileWrites && entriesChanged ) {
 					// if this directory has nonstandard metadata, write that to the file system
-					wxFileName metaFileName( m_folderName.GetFullPath() + subDirPath + L"/_pcsx2_meta_directory" );
+					const wxFileName metaFileName( m_folderName.GetFullPath() + subDirPath + L"/_pcsx2_meta_directory" );
 					if ( filenameCleaned || entry->entry.data.mode != MemoryCardFileEntry::DefaultDirMode || entry->entry.data.attr != 0 ) {
-						if ( !metaFileName.DirExists() ) {
-							metaFileName.Mkdir();
-						}
-						wxFFile metaFile( metaFileName.GetFullPath(), L"wb" );
-						if ( metaFile.IsOpened() ) {
-							metaFile.Write( entry->entry.raw, sizeof( entry->entry.raw ) );
-							metaFile.Close();
-						}
+						const MemoryCardFileEntry metaEntry = *entry;
+						m_flush.fileOps.push_back( [metaFileName, metaEntry]() {
+							wxFileName dirName( metaFileName );
+							if ( !dirName.DirExists() ) {
+								dirName.Mkdir();
+							}
+							wxFFile metaFile( metaFileName.GetFullPath(), L"wb" );
+							if ( metaFile.IsOpened() ) {
+								metaFile.Write( metaEntry.entry.raw, sizeof( metaEntry.entry.raw ) );
+								metaFile.Close();
+							}
+						} );
 					} else {
 						// if metadata is standard make sure to remove a possibly existing metadata file
-						if ( metaFileName.FileExists() ) {
-							wxRemoveFile( metaFileName.GetFullPath() );
-						}
+						m_flush.fileOps.push_back( [metaFileName]() {
+							if ( metaFileName.FileExists() ) {
+								wxRemoveFile( metaFileName.GetFullPath() );
+							}
+						} );
 					}
 				}
 
@@ -1027,15 +1234,18 @@ void FolderMemoryCard::FlushFileEntries( const u32 dirCluster, const u32 remaini
 				FileAccessHelper::CleanMemcardFilename( cleanName );
 				const wxString filePath = dirPath + L"/" + wxString::FromAscii( (const char*)cleanName );
 
-				if ( m_performFileWrites ) {
-					wxFileName fn( m_folderName.GetFullPath() + filePath );
-					if ( !fn.FileExists() ) {
-						if ( !fn.DirExists() ) {
-							fn.Mkdir( 0777, wxPATH_MKDIR_FULL );
+				if ( m_performFileWrites && entriesChanged ) {
+					const wxFileName emptyFileName( m_folderName.GetFullPath() + filePath );
+					m_flush.fileOps.push_back( [emptyFileName]() {
+						wxFileName fn( emptyFileName );
+						if ( !fn.FileExists() ) {
+							if ( !fn.DirExists() ) {
+								fn.Mkdir( 0777, wxPATH_MKDIR_FULL );
+							}
+							wxFFile createEmptyFile( fn.GetFullPath(), L"wb" );
+							createEmptyFile.Close();
 						}
-						wxFFile createEmptyFile( fn.GetFullPath(), L"wb" );
-						createEmptyFile.Close();
-					}
+					} );
 				}
 			}
 		}
@@ -1069,13 +1279,15 @@ void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache( const s
 				FileAccessHelper::CleanMemcardFilename( cleanName );
 				const wxString fileName = wxString::FromAscii( cleanName );
 				const wxString filePath = m_folderName.GetFullPath() + dirPath + L"/" + fileName;
-				m_lastAccessedFile.CloseMatching( filePath );
 				const wxString newFilePath = m_folderName.GetFullPath() + dirPath + L"/_pcsx2_deleted_" + fileName;
-				if ( wxFileName::DirExists( newFilePath ) ) {
-					// wxRenameFile doesn't overwrite directories, so we have to remove the old one first
-					RemoveDirectory( newFilePath );
-				}
-				wxRenameFile( filePath, newFilePath );
+				m_flush.fileOps.push_back( [this, filePath, newFilePath]() {
+					m_lastAccessedFile.CloseMatching( filePath );
+					if ( wxFileName::DirExists( newFilePath ) ) {
+						// wxRenameFile doesn't overwrite directories, so we have to remove the old one first
+						RemoveDirectory( newFilePath );
+					}
+					wxRenameFile( filePath, newFilePath );
+				} );
 			} else if ( entry->IsDir() ) {
 				// still exists and is a directory, recursive call for subdir
 				char cleanName[sizeof( entry->entry.data.name )];
@@ -1085,7 +1297,7 @@ void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache( const s
 				const wxString subDirPath = dirPath + L"/" + subDirName;
 				FlushDeletedFilesAndRemoveUnchangedDataFromCache( it->subdir, newEntry->entry.data.cluster, newEntry->entry.data.length, subDirPath );
 			} else if ( entry->IsFile() ) {
-				// still exists and is a file, see if we can remove unchanged data from m_cache
+				// still exists and is a file, see if we can remove unchanged data from m_flush
 				RemoveUnchangedDataFromCache( entry, newEntry );
 			}
 		}
@@ -1108,13 +1320,11 @@ void FolderMemoryCard::RemoveUnchangedDataFromCache( const MemoryCardFileEntry*
 	while ( cluster != LastDataCluster ) {
 		for ( int i = 0; i < 2; ++i ) {
 			const u32 page = ( cluster + alloc_offset ) * 2 + i;
-			auto newIt = m_cache.find( page );
-			if ( newIt == m_cache.end() ) { continue; }
-			auto oldIt = m_oldDataCache.find( page );
-			if ( oldIt == m_oldDataCache.end() ) { continue; }
+			if ( !IsPageInFlush( page ) ) { continue; }
 
-			if ( memcmp( &oldIt->second.raw[0], &newIt->second.raw[0], PageSize ) == 0 ) {
-				m_cache.erase( newIt );
+			const u32 pos = m_flush.index[page];
+			if ( memcmp( &m_oldDataPages[m_cacheIndex[page]].raw[0], &m_flush.data[pos].raw[0], PageSize ) == 0 ) {
+				m_flush.flushed[pos] = true;
 			}
 		}
 
@@ -1122,42 +1332,6 @@ void FolderMemoryCard::RemoveUnchangedDataFromCache( const MemoryCardFileEntry*
 	}
 }
 
-s32 FolderMemoryCard::WriteWithoutCache( const u8 *src, u32 adr, int size ) {
-	//const u32 block = adr / BlockSizeRaw;
-	//const u32 cluster = adr / ClusterSizeRaw;
-	//const u32 page = adr / PageSizeRaw;
-	const u32 offset = adr % PageSizeRaw;
-	const u32 end = offset + size;
-
-	if ( end > PageSizeRaw ) {
-		// is trying to store more than one page at a time
-		// do this recursively so that each function call only has to care about one page
-		const u32 toNextPage = PageSizeRaw - offset;
-		Save( src + toNextPage, adr + toNextPage, size - toNextPage );
-		size = toNextPage;
-	}
-
-	if ( offset < PageSize ) {
-		// is trying to store (part of) an actual data block
-		const u32 dataLength = std::min( (u32)size, PageSize - offset );
-
-		u8* dest = GetSystemBlockPointer( adr );
-		if ( dest != nullptr ) {
-			memcpy( dest, src, dataLength );
-		} else {
-			WriteToFile( src, adr, dataLength );
-		}
-	}
-
-	if ( end > PageSize ) {
-		// is trying to store ECC
-		// simply ignore this, is automatically generated when reading
-	}
-
-	// return 0 on fail, 1 on success?
-	return 1;
-}
-
 bool FolderMemoryCard::WriteToFile( const u8* src, u32 adr, u32 dataLength ) {
 	const u32 cluster = adr / ClusterSizeRaw;
 	const u32 page = adr / PageSizeRaw;
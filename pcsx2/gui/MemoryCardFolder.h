@@ -18,7 +18,12 @@
 #include <wx/file.h>
 #include <wx/dir.h>
 #include <wx/ffile.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "PluginCallbacks.h"
@@ -301,12 +306,42 @@ protected:
 	// quick-access map of related file entry metadata for each memory card FAT cluster that contains file data
 	std::map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
 
+	static const u32 InvalidCacheSlot = 0xFFFFFFFFu;
+
 	// holds a copy of modified pages of the memory card before they're flushed to the file system
-	std::map<u32, MemoryCardPage> m_cache;
-	// contains the state of how the data looked before the first write to it
+	// m_cacheIndex maps a page to its slot in m_cachePages, or InvalidCacheSlot
+	std::vector<u32> m_cacheIndex;
+	std::vector<MemoryCardPage> m_cachePages;
+	// contains the state of how the data looked before the first write to it, same slots as m_cachePages
 	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
 	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
-	std::map<u32, MemoryCardPage> m_oldDataCache;
+	std::vector<MemoryCardPage> m_oldDataPages;
+	std::vector<u32> m_freeCacheSlots;
+	// one bit per page, set by Save() and cleared when the page is handed to a flush
+	std::vector<u64> m_dirtyPages;
+	u32 m_dirtyPageCount;
+
+	// A flush works on a snapshot of the dirty pages. Internal data (superblock, FAT, file entries) is updated
+	// right away, the host file system writes are queued and done by m_flushThread. The snapshotted pages stay
+	// in the cache until FinishFlush(), so reads never see the host files half written.
+	struct FlushJob {
+		std::vector<u32> pages;                      // page numbers, ascending
+		std::vector<MemoryCardPage> data;            // their contents at the time of the snapshot
+		std::vector<u32> index;                      // page -> position in pages, or InvalidCacheSlot
+		std::vector<bool> flushed;                   // written to the internal data or queued for the host
+		std::vector<std::function<void()>> fileOps;  // host file system changes other than file data, in order
+		std::vector<u32> fileWrites;                 // positions in pages to write to host files
+		u64 timeStart;
+		u64 timeEnd;
+		bool report;
+	} m_flush;
+
+	std::thread m_flushThread;
+	std::atomic<bool> m_flushRunning;
+	// set by m_flushThread once m_flush.fileOps are done and the host file layout matches the internal data
+	bool m_flushOpsDone;
+	std::mutex m_flushOpsLock;
+	std::condition_variable m_flushOpsDoneCond;
 	// if > 0, the amount of frames until data is flushed to the file system
 	// reset to FramesAfterWriteUntilFlush on each write
 	int m_framesUntilFlush;
@@ -315,6 +350,8 @@ protected:
 
 	// remembers and keeps the last accessed file open for further access
 	FileAccessHelper m_lastAccessedFile;
+	// files opened for reads while m_flushThread owns m_lastAccessedFile, closed again by FinishFlush()
+	FileAccessHelper m_flushReadFile;
 
 	// path to the folder that contains the files of this memory card
 	wxFileName m_folderName;
@@ -333,7 +370,7 @@ protected:
 
 public:
 	FolderMemoryCard();
-	virtual ~FolderMemoryCard() = default;
+	virtual ~FolderMemoryCard();
 
 	void Lock();
 	void Unlock();
@@ -482,10 +519,34 @@ protected:
 	bool WriteToFile( const u8* src, u32 adr, u32 dataLength );
 
 
+	// page cache helpers, see m_cacheIndex
+	MemoryCardPage* GetCachedPage( const u32 page );
+	MemoryCardPage* AddCachedPage( const u32 page, const u8* data );
+	void RemoveCachedPage( const u32 page );
+	void ClearCache();
+	bool IsPageDirty( const u32 page ) const;
+	void SetPageDirty( const u32 page );
+
 	// flush the whole cache to the internal data and/or host file system
-	void Flush();
+	// with async set, the host file system is written by m_flushThread
+	void Flush( bool async = false );
+
+	// moves the dirty pages into m_flush
+	void BeginFlush();
+
+	// updates the internal data from m_flush and queues the host file system changes
+	void FlushInternalData();
 
-	// flush a single page of the cache to the internal data and/or host file system
+	// performs the queued host file system changes of m_flush, runs on m_flushThread for async flushes
+	void FlushFiles();
+
+	// waits for m_flushThread and drops the flushed pages from the cache
+	void FinishFlush();
+
+	// returns true if page is part of the current flush
+	bool IsPageInFlush( const u32 page ) const;
+
+	// flush a single page of m_flush to the internal data, or queue it for the host file system
 	bool FlushPage( const u32 page );
 
 	// flush a memory card cluster of the cache to the internal data and/or host file system
@@ -501,10 +562,12 @@ protected:
 	void FlushFileEntries();
 
 	// flush a directory's file entries and all its subdirectories to the internal data
+	// host metadata of entries is only rewritten for directory clusters that are part of m_flush
 	void FlushFileEntries( const u32 dirCluster, const u32 remainingFiles, const wxString& dirPath = L"", MemoryCardFileMetadataReference* parent = nullptr );
 
 	// "delete" (prepend '_pcsx2_deleted_' to) any files that exist in oldFileEntries but no longer exist in m_fileEntryDict
 	// also calls RemoveUnchangedDataFromCache() since both operate on comparing with the old file entires
+	// the renames are queued in m_flush
 	void FlushDeletedFilesAndRemoveUnchangedDataFromCache( const std::vector<MemoryCardFileEntryTreeNode>& oldFileEntries );
 
 	// recursive worker method of the above
@@ -513,13 +576,10 @@ protected:
 	// - dirPath: Path to the current directory relative to the root of the memcard. Must be identical for both entries.
 	void FlushDeletedFilesAndRemoveUnchangedDataFromCache( const std::vector<MemoryCardFileEntryTreeNode>& oldFileEntries, const u32 newCluster, const u32 newFileCount, const wxString& dirPath );
 
-	// try and remove unchanged data from m_cache
+	// try and remove unchanged data from m_flush
 	// oldEntry and newEntry should be equivalent entries found by FindEquivalent()
 	void RemoveUnchangedDataFromCache( const MemoryCardFileEntry* const oldEntry, const MemoryCardFileEntry* const newEntry );
 
-	// write data as Save() normally would, but ignore the cache; used for flushing
-	s32 WriteWithoutCache( const u8 *src, u32 adr, int size );
-
 	// copies the contents of m_fileEntryDict into the tree structure fileEntryTree
 	void CopyEntryDictIntoTree( std::vector<MemoryCardFileEntryTreeNode>* fileEntryTree, const u32 cluster, const u32 fileCount );
 
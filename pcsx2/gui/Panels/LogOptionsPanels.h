@@ -79,6 +79,7 @@ namespace Panels
 		wxStaticBoxSizer*	m_miscSection;
 
 		pxCheckBox*			m_masterEnabler;
+		pxCheckBox*			m_binaryTrace;
 
 		std::unique_ptr<pxCheckBox*[]> m_checks;
 
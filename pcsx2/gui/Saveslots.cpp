@@ -117,6 +117,28 @@ void States_DefrostCurrentSlotBackup()
 	_States_DefrostCurrentSlot(true);
 }
 
+void States_SnapshotToMemory()
+{
+	if (!SysHasValidState())
+	{
+		Console.WriteLn("Memory snapshot: Aborting (VM is not active).");
+		return;
+	}
+
+	StateCopy_SaveToMemory();
+}
+
+void States_RestoreFromMemory()
+{
+	if (!SysHasValidState())
+	{
+		Console.WriteLn("Memory snapshot restore: Aborting (VM is not active).");
+		return;
+	}
+
+	StateCopy_LoadFromMemory();
+}
+
 // I'd keep an eye on this function, as it may still be problematic.
 void Sstates_updateLoadBackupMenuItem(bool isBeforeSave)
 {
@@ -130,6 +130,8 @@ extern std::array<Saveslot,10> saveslot_cache;
 extern void States_DefrostCurrentSlotBackup();
 extern void States_DefrostCurrentSlot();
 extern void States_FreezeCurrentSlot();
+extern void States_SnapshotToMemory();
+extern void States_RestoreFromMemory();
 extern void States_CycleSlotForward();
 extern void States_CycleSlotBackward();
 extern void States_SetCurrentSlot(int slot);
@@ -35,7 +35,6 @@
 //static VmStateBuffer state_buffer( L"Public Savestate Buffer" );
 
 static const wxChar* EntryFilename_StateVersion			= L"PCSX2 Savestate Version.id";
-static const wxChar* EntryFilename_Screenshot			= L"Screenshot.jpg";
 static const wxChar* EntryFilename_InternalStructures	= L"PCSX2 Internal Structures.dat";
 
 
@@ -54,6 +53,10 @@ public:
 	virtual void FreezeIn( pxInputStream& reader ) const=0;
 	virtual void FreezeOut( SaveStateBase& writer ) const=0;
 	virtual bool IsRequired() const=0;
+
+	// Loads the entry by inflating its chunks in parallel (see ZipChunkIndex).  Returns false
+	// if the entry can't be loaded that way, in which case FreezeIn should be used instead.
+	virtual bool FreezeInParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks ) const { return false; }
 };
 
 class MemorySavestateEntry : public BaseSavestateEntry
@@ -65,6 +68,7 @@ protected:
 public:
 	virtual void FreezeIn( pxInputStream& reader ) const;
 	virtual void FreezeOut( SaveStateBase& writer ) const;
+	virtual bool FreezeInParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks ) const;
 	virtual bool IsRequired() const { return true; }
 
 protected:
@@ -115,6 +119,11 @@ void MemorySavestateEntry::FreezeOut( SaveStateBase& writer ) const
 	writer.FreezeMem( GetDataPtr(), GetDataSize() );
 }
 
+bool MemorySavestateEntry::FreezeInParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks ) const
+{
+	return InflateZipEntryParallel( file, entry, chunks, GetDataPtr(), GetDataSize() );
+}
+
 wxString PluginSavestateEntry::GetFilename() const
 {
 	return pxsFmt( "Plugin %s.dat", tbl_PluginInfo[m_pid].shortname );
@@ -158,6 +167,12 @@ public:
 		SysClearExecutionCache();
 		MemorySavestateEntry::FreezeIn( reader );
 	}
+
+	virtual bool FreezeInParallel( pxInputStream& file, const wxZipEntry& entry, const ZipChunkList& chunks ) const
+	{
+		SysClearExecutionCache();
+		return MemorySavestateEntry::FreezeInParallel( file, entry, chunks );
+	}
 };
 
 class SavestateEntry_IopMemory : public MemorySavestateEntry
@@ -334,6 +349,14 @@ protected:
 				.SetUserMsg(_("There is no active virtual machine state to download or save." ));
 
 		memSavingState saveme( m_dest_list->GetBuffer() );
+
+		u32 version = g_SaveVersion;
+		m_dest_list->Add( ArchiveEntry( EntryFilename_StateVersion )
+			.SetDataIndex( saveme.GetCurrentPos() )
+			.SetDataSize( sizeof(version) )
+		);
+		saveme.Freeze( version );
+
 		ArchiveEntry internals( EntryFilename_InternalStructures );
 		internals.SetDataIndex( saveme.GetCurrentPos() );
 
@@ -440,28 +463,9 @@ protected:
 
 		pxYield(4);
 
-		// Write the version and screenshot:
-		std::unique_ptr<pxOutputStream> out(new pxOutputStream(tempfile, new wxZipOutputStream(woot)));
-		wxZipOutputStream* gzfp = (wxZipOutputStream*)out->GetWxStreamBase();
-
-		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_StateVersion);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			out->Write(g_SaveVersion);
-			gzfp->CloseEntry();
-		}
-
-		std::unique_ptr<wxImage> m_screenshot;
-
-		if (m_screenshot)
-		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_Screenshot);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			m_screenshot->SaveFile( *gzfp, wxBITMAP_TYPE_JPEG );
-			gzfp->CloseEntry();
-		}
+		// The compress thread writes the zip archive itself (version entry included), so the
+		// file stream is handed over as-is.
+		std::unique_ptr<pxOutputStream> out(new pxOutputStream(tempfile, woot));
 
 		(*new VmStateCompressThread())
 			.SetSource(elist.get())
@@ -534,6 +538,7 @@ protected:
 
 		std::unique_ptr<wxZipEntry> foundInternal;
 		std::unique_ptr<wxZipEntry> foundEntry[ArraySize(SavestateEntries)];
+		ZipChunkIndex chunkIndex;
 
 		while(true)
 		{
@@ -550,6 +555,16 @@ protected:
 				continue;
 			}
 
+			if (entry->GetName().CmpNoCase(EntryFilename_ChunkIndex) == 0)
+			{
+				std::vector<u8> index( entry->GetSize() );
+				if (!index.empty()) reader->Read( index.data(), index.size() );
+
+				if (!chunkIndex.Load( index.data(), index.size() ))
+					Console.WriteLn( Color_Yellow, L" ... ignoring malformed '%s'", EntryFilename_ChunkIndex );
+				continue;
+			}
+
 			if (entry->GetName().CmpNoCase(EntryFilename_InternalStructures) == 0)
 			{
 				DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_InternalStructures);
@@ -609,12 +624,22 @@ protected:
 		GetCoreThread().Pause();
 		SysClearExecutionCache();
 
+		// States written by ParallelZipWriter can have their big entries inflated on all host
+		// threads; those are read through a second handle to the file.
+		std::unique_ptr<pxInputStream> rawfile;
+		if (!chunkIndex.IsEmpty())
+			rawfile.reset(new pxInputStream(m_filename, new wxFFileInputStream(m_filename)));
+
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
 			if (!foundEntry[i]) continue;
 
 			Threading::pxTestCancel();
 
+			const ZipChunkList* chunks = chunkIndex.Find( foundEntry[i]->GetName() );
+			if (chunks && SavestateEntries[i]->FreezeInParallel( *rawfile, *foundEntry[i], *chunks ))
+				continue;
+
 			gzreader->OpenEntry( *foundEntry[i] );
 			SavestateEntries[i]->FreezeIn( *reader );
 		}
@@ -631,6 +656,94 @@ protected:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  SysExecEvent_SnapshotToMemory / SysExecEvent_RestoreFromMemory
+// --------------------------------------------------------------------------------------
+// Fast path for frequent saves: snapshots stay uncompressed in memory (see memSnapshotRing)
+// and never touch the disk or the compression thread.
+//
+static memSnapshotRing s_SnapshotRing;
+
+class SysExecEvent_SnapshotToMemory : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_SnapshotToMemory"; }
+
+	virtual ~SysExecEvent_SnapshotToMemory() = default;
+	SysExecEvent_SnapshotToMemory* Clone() const { return new SysExecEvent_SnapshotToMemory( *this ); }
+
+	bool IsCriticalEvent() const { return true; }
+	bool AllowCancelOnExit() const { return false; }
+
+protected:
+	void InvokeEvent()
+	{
+		ScopedCoreThreadPause paused_core;
+
+		if( !SysHasValidState() )
+			throw Exception::RuntimeError()
+				.SetDiagMsg(L"SysExecEvent_SnapshotToMemory: Cannot snapshot an invalid VM state!")
+				.SetUserMsg(_("There is no active virtual machine state to download or save." ));
+
+		s_SnapshotRing.Capture();
+
+		DevCon.WriteLn( Color_Green, "Memory snapshot %u/%u captured (%u dirty pages).",
+			s_SnapshotRing.GetCount(), s_SnapshotRing.GetCapacity(), s_SnapshotRing.GetDirtyPageCount() );
+
+		paused_core.AllowResume();
+	}
+};
+
+class SysExecEvent_RestoreFromMemory : public SysExecEvent
+{
+protected:
+	uint	m_age;
+
+public:
+	wxString GetEventName() const { return L"VM_RestoreFromMemory"; }
+
+	virtual ~SysExecEvent_RestoreFromMemory() = default;
+	SysExecEvent_RestoreFromMemory* Clone() const { return new SysExecEvent_RestoreFromMemory( *this ); }
+	SysExecEvent_RestoreFromMemory( uint age=0 )
+	{
+		m_age = age;
+	}
+
+protected:
+	void InvokeEvent()
+	{
+		if (m_age >= s_SnapshotRing.GetCount())
+		{
+			Console.WriteLn( Color_Yellow, "Memory snapshot %u is not available (%u stored).", m_age, s_SnapshotRing.GetCount() );
+			return;
+		}
+
+		PatchesVerboseReset();
+
+		GetCoreThread().Pause();
+		s_SnapshotRing.Restore( m_age );
+		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
+	}
+};
+
+class SysExecEvent_ClearMemorySnapshots : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_ClearMemorySnapshots"; }
+
+	virtual ~SysExecEvent_ClearMemorySnapshots() = default;
+	SysExecEvent_ClearMemorySnapshots* Clone() const { return new SysExecEvent_ClearMemorySnapshots( *this ); }
+
+protected:
+	void InvokeEvent()
+	{
+		if (s_SnapshotRing.GetCount())
+			DevCon.WriteLn( "Discarding %u memory snapshot(s).", s_SnapshotRing.GetCount() );
+
+		s_SnapshotRing.Clear();
+	}
+};
+
 // =====================================================================================================
 //  StateCopy Public Interface
 // =====================================================================================================
@@ -697,3 +810,21 @@ void StateCopy_LoadFromSlot( uint slot, bool isFromBackup )
 	UI_UpdateSysControls();
 #endif
 }
+
+void StateCopy_SaveToMemory()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_SnapshotToMemory());
+}
+
+// age 0 restores the most recent snapshot, 1 the one before it, and so on.
+void StateCopy_LoadFromMemory( uint age )
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_RestoreFromMemory( age ));
+}
+
+// Snapshots only make sense for the boot they were taken in; called on reset and when a
+// game starts.  Posted to the executor like the captures themselves, so it can't overlap one.
+void StateCopy_ClearMemorySnapshots()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_ClearMemorySnapshots());
+}
@@ -335,6 +335,7 @@ __fi bool dmacWrite32( u32 mem, mem32_t& value )
 		icase(D3_CHCR) // dma3 - fromIPU
 		{
 			DMA_LOG("IPU0dma EXECUTE, value=0x%x\n", value);
+			ipuWorkerSync();
 			DmaExec(dmaIPU0, mem, value);
 			return false;
 		}
@@ -342,6 +343,7 @@ __fi bool dmacWrite32( u32 mem, mem32_t& value )
 		icase(D4_CHCR) // dma4 - toIPU
 		{
 			DMA_LOG("IPU1dma EXECUTE, value=0x%x\n", value);
+			ipuWorkerSync();
 			DmaExec(dmaIPU1, mem, value);
 			return false;
 		}
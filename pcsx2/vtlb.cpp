@@ -35,9 +35,12 @@
 #include "COP0.h"
 #include "Cache.h"
 #include "R5900Exceptions.h"
+#include "DebugTools/Breakpoints.h"
 
 #include "Utilities/MemsetFast.inl"
 
+#include <unordered_map>
+
 using namespace R5900;
 using namespace vtlb_private;
 
@@ -55,6 +58,11 @@ static vtlbHandler UnmappedVirtHandler0;
 static vtlbHandler UnmappedVirtHandler1;
 static vtlbHandler UnmappedPhyHandler0;
 static vtlbHandler UnmappedPhyHandler1;
+static vtlbHandler WatchHandler0;
+static vtlbHandler WatchHandler1;
+
+// Real vmap entries of the pages routed through the watch handlers, by virtual page.
+static std::unordered_map<u32, sptr> vtlbWatched;
 
 __inline int CheckCache(u32 addr)
 {
@@ -357,7 +365,7 @@ void __fastcall GoemonPreloadTlb()
 			u32 vaddr = tlb[i].low_add;
 			u32 paddr = tlb[i].physical_add;
 
-			if ((uptr)vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] == POINTER_SIGN_BIT) {
+			if ((uptr)vtlb_GetVMapEntry(vaddr) == POINTER_SIGN_BIT) {
 				DevCon.WriteLn("GoemonPreloadTlb: Entry %d. Key %x. From V:0x%8.8x to P:0x%8.8x (%d pages)", i, tlb[i].key, vaddr, paddr, size >> VTLB_PAGE_BITS);
 				vtlb_VMap(           vaddr , paddr, size);
 				vtlb_VMap(0x20000000|vaddr , paddr, size);
@@ -461,6 +469,162 @@ void __fastcall vtlbUnmappedPWriteSm(u32 addr,OperandType data)			{ vtlb_BusErro
 template<typename OperandType, u32 saddr>
 void __fastcall vtlbUnmappedPWriteLg(u32 addr,const OperandType* data)	{ vtlb_BusError(addr|saddr,1); }
 
+// --------------------------------------------------------------------------------------
+//  VTLB Watched Pages
+// --------------------------------------------------------------------------------------
+// Pages covered by a debugger memcheck have their vmap entry replaced by one of these
+// handlers, so only accesses to those pages pay for the check; every other page keeps
+// the direct path.  Like the unmapped virtual handlers, the entry encodes the virtual
+// address instead of a physical one (the top bit is lost in translation, hence the two
+// handlers), and the real entry is kept in vtlbWatched to forward the access.
+//
+
+static __fi sptr vtlb_WatchEntry(u32 vaddr)
+{
+	sptr pme = (vaddr & 0x80000000) ? WatchHandler1 : WatchHandler0;
+	pme |= POINTER_SIGN_BIT;
+	pme |= vaddr & ~VTLB_PAGE_MASK;
+	return pme - (vaddr & ~VTLB_PAGE_MASK);
+}
+
+// Every vmap update goes through here, so that a TLB remap of a watched page changes
+// the entry the watch handler forwards to instead of dropping the watch.
+static __fi void vtlb_SetVMap(u32 vaddr, sptr value)
+{
+	if (!vtlbWatched.empty())
+	{
+		auto it = vtlbWatched.find(vaddr >> VTLB_PAGE_BITS);
+		if (it != vtlbWatched.end())
+		{
+			it->second = value;
+			value = vtlb_WatchEntry(vaddr);
+		}
+	}
+
+	vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = value;
+}
+
+template<typename OperandType>
+static __fi int vtlb_SizeIndex()
+{
+	switch (sizeof(OperandType))
+	{
+		case 1: return 0;
+		case 2: return 1;
+		case 4: return 2;
+		case 8: return 3;
+	}
+	return 4;
+}
+
+template<typename OperandType, u32 saddr>
+static __fi sptr vtlb_WatchAccess(u32& addr, bool write)
+{
+	addr = (addr & 0x7FFFFFFF) | saddr;
+	if (CHECK_EEREC)
+		CBreakPoints::ExecMemCheck(addr, write, sizeof(OperandType), eeMemCheckPC);
+	else
+		intMemcheck(addr, write, sizeof(OperandType));
+	return vtlbWatched[addr >> VTLB_PAGE_BITS];
+}
+
+// Direct accesses forwarded by the watch handlers go through the data cache the same
+// way vtlb_memRead and vtlb_memWrite would send them.
+static __fi bool vtlb_WatchCached(u32 addr)
+{
+	return !CHECK_EEREC && CHECK_CACHE && CheckCache(addr);
+}
+
+static __fi mem8_t vtlb_ReadCached(u32 addr, mem8_t*)	{ return readCache8(addr); }
+static __fi mem16_t vtlb_ReadCached(u32 addr, mem16_t*)	{ return readCache16(addr); }
+static __fi mem32_t vtlb_ReadCached(u32 addr, mem32_t*)	{ return readCache32(addr); }
+static __fi void vtlb_ReadCached(u32 addr, mem64_t* data)	{ *data = readCache64(addr); }
+static __fi void vtlb_ReadCached(u32 addr, mem128_t* data)
+{
+	data->lo = readCache64(addr);
+	data->hi = readCache64(addr+8);
+}
+
+static __fi void vtlb_WriteCached(u32 addr, mem8_t data)				{ writeCache8(addr, data); }
+static __fi void vtlb_WriteCached(u32 addr, mem16_t data)				{ writeCache16(addr, data); }
+static __fi void vtlb_WriteCached(u32 addr, mem32_t data)				{ writeCache32(addr, data); }
+static __fi void vtlb_WriteCached(u32 addr, const mem64_t* data)		{ writeCache64(addr, *data); }
+static __fi void vtlb_WriteCached(u32 addr, const mem128_t* data)		{ writeCache128(addr, data); }
+
+template<typename OperandType, u32 saddr>
+OperandType __fastcall vtlbWatchReadSm(u32 addr)
+{
+	sptr vmv = vtlb_WatchAccess<OperandType, saddr>(addr, false);
+	sptr ppf = addr + vmv;
+	if (ppf >= 0)
+	{
+		if (vtlb_WatchCached(addr))
+			return vtlb_ReadCached(addr, (OperandType*)NULL);
+		return *reinterpret_cast<OperandType*>(ppf);
+	}
+
+	u32 hand = (u8)vmv;
+	typedef OperandType __fastcall HandlerType(u32 addr);
+	return ((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex<OperandType>()][0][hand])(ppf - hand + 0x80000000);
+}
+
+template<typename OperandType, u32 saddr>
+void __fastcall vtlbWatchReadLg(u32 addr, OperandType* data)
+{
+	sptr vmv = vtlb_WatchAccess<OperandType, saddr>(addr, false);
+	sptr ppf = addr + vmv;
+	if (ppf >= 0)
+	{
+		if (vtlb_WatchCached(addr))
+			vtlb_ReadCached(addr, data);
+		else
+			*data = *reinterpret_cast<OperandType*>(ppf);
+		return;
+	}
+
+	u32 hand = (u8)vmv;
+	typedef void __fastcall HandlerType(u32 addr, OperandType* data);
+	((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex<OperandType>()][0][hand])(ppf - hand + 0x80000000, data);
+}
+
+template<typename OperandType, u32 saddr>
+void __fastcall vtlbWatchWriteSm(u32 addr, OperandType data)
+{
+	sptr vmv = vtlb_WatchAccess<OperandType, saddr>(addr, true);
+	sptr ppf = addr + vmv;
+	if (ppf >= 0)
+	{
+		if (vtlb_WatchCached(addr))
+			vtlb_WriteCached(addr, data);
+		else
+			*reinterpret_cast<OperandType*>(ppf) = data;
+		return;
+	}
+
+	u32 hand = (u8)vmv;
+	typedef void __fastcall HandlerType(u32 addr, OperandType data);
+	((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex<OperandType>()][1][hand])(ppf - hand + 0x80000000, data);
+}
+
+template<typename OperandType, u32 saddr>
+void __fastcall vtlbWatchWriteLg(u32 addr, const OperandType* data)
+{
+	sptr vmv = vtlb_WatchAccess<OperandType, saddr>(addr, true);
+	sptr ppf = addr + vmv;
+	if (ppf >= 0)
+	{
+		if (vtlb_WatchCached(addr))
+			vtlb_WriteCached(addr, data);
+		else
+			*reinterpret_cast<OperandType*>(ppf) = *data;
+		return;
+	}
+
+	u32 hand = (u8)vmv;
+	typedef void __fastcall HandlerType(u32 addr, const OperandType* data);
+	((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex<OperandType>()][1][hand])(ppf - hand + 0x80000000, data);
+}
+
 // --------------------------------------------------------------------------------------
 //  VTLB mapping errors
 // --------------------------------------------------------------------------------------
@@ -687,7 +851,7 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 				pme |= paddr;// top bit is set anyway ...
 		}
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = pme-vaddr;
+		vtlb_SetVMap(vaddr, pme-vaddr);
 		if (vtlbdata.ppmap)
 			if (!(vaddr & 0x80000000)) // those address are already physical don't change them
 				vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS] = paddr & ~VTLB_PAGE_MASK;
@@ -706,7 +870,7 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	uptr bu8 = (uptr)buffer;
 	while (size > 0)
 	{
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = bu8-vaddr;
+		vtlb_SetVMap(vaddr, bu8-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		bu8 += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
@@ -729,12 +893,73 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 		handl |= vaddr; // top bit is set anyway ...
 		handl |= 0x80000000;
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = handl-vaddr;
+		vtlb_SetVMap(vaddr, handl-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
 }
 
+// Routes accesses to the given virtual pages through the memcheck handlers.  Recompiled
+// code that resolved a constant address on these pages has to be cleared by the caller.
+void vtlb_VMapWatch(u32 vaddr,u32 size)
+{
+	verify(0==(vaddr&VTLB_PAGE_MASK));
+	verify(0==(size&VTLB_PAGE_MASK) && size>0);
+
+	while (size > 0)
+	{
+		u32 vpage = vaddr >> VTLB_PAGE_BITS;
+		if (vtlbWatched.find(vpage) == vtlbWatched.end())
+		{
+			vtlbWatched[vpage] = vtlbdata.vmap ? vtlbdata.vmap[vpage] : 0;
+			if (vtlbdata.vmap)
+				vtlbdata.vmap[vpage] = vtlb_WatchEntry(vaddr);
+		}
+
+		vaddr += VTLB_PAGE_SIZE;
+		size -= VTLB_PAGE_SIZE;
+	}
+}
+
+void vtlb_VMapUnwatch(u32 vaddr,u32 size)
+{
+	verify(0==(vaddr&VTLB_PAGE_MASK));
+	verify(0==(size&VTLB_PAGE_MASK) && size>0);
+
+	while (size > 0)
+	{
+		auto it = vtlbWatched.find(vaddr >> VTLB_PAGE_BITS);
+		if (it != vtlbWatched.end())
+		{
+			if (vtlbdata.vmap)
+				vtlbdata.vmap[it->first] = it->second;
+			vtlbWatched.erase(it);
+		}
+
+		vaddr += VTLB_PAGE_SIZE;
+		size -= VTLB_PAGE_SIZE;
+	}
+}
+
+bool vtlb_IsWatched(u32 vaddr)
+{
+	return vtlbWatched.find(vaddr >> VTLB_PAGE_BITS) != vtlbWatched.end();
+}
+
+// Returns the vmap entry of vaddr, looking through the watch handlers to the page's real
+// mapping.  For code that decodes the entry itself instead of calling through it.
+sptr vtlb_GetVMapEntry(u32 vaddr)
+{
+	if (!vtlbWatched.empty())
+	{
+		auto it = vtlbWatched.find(vaddr >> VTLB_PAGE_BITS);
+		if (it != vtlbWatched.end())
+			return it->second;
+	}
+
+	return vtlbdata.vmap[vaddr >> VTLB_PAGE_BITS];
+}
+
 // vtlb_Init -- Clears vtlb handlers and memory mappings.
 void vtlb_Init()
 {
@@ -759,6 +984,17 @@ void vtlb_Init()
 	UnmappedPhyHandler0 = vtlb_RegisterHandler( VTLB_BuildUnmappedHandler(vtlbUnmappedP, 0) );
 	UnmappedPhyHandler1 = vtlb_RegisterHandler( VTLB_BuildUnmappedHandler(vtlbUnmappedP, 0x80000000) );
 
+	WatchHandler0 = vtlb_RegisterHandler(
+		vtlbWatchReadSm<mem8_t,0>,		vtlbWatchReadSm<mem16_t,0>,		vtlbWatchReadSm<mem32_t,0>,
+		vtlbWatchReadLg<mem64_t,0>,		vtlbWatchReadLg<mem128_t,0>,
+		vtlbWatchWriteSm<mem8_t,0>,		vtlbWatchWriteSm<mem16_t,0>,	vtlbWatchWriteSm<mem32_t,0>,
+		vtlbWatchWriteLg<mem64_t,0>,	vtlbWatchWriteLg<mem128_t,0> );
+	WatchHandler1 = vtlb_RegisterHandler(
+		vtlbWatchReadSm<mem8_t,0x80000000>,		vtlbWatchReadSm<mem16_t,0x80000000>,	vtlbWatchReadSm<mem32_t,0x80000000>,
+		vtlbWatchReadLg<mem64_t,0x80000000>,	vtlbWatchReadLg<mem128_t,0x80000000>,
+		vtlbWatchWriteSm<mem8_t,0x80000000>,	vtlbWatchWriteSm<mem16_t,0x80000000>,	vtlbWatchWriteSm<mem32_t,0x80000000>,
+		vtlbWatchWriteLg<mem64_t,0x80000000>,	vtlbWatchWriteLg<mem128_t,0x80000000> );
+
 	DefaultPhyHandler = vtlb_RegisterHandler(0,0,0,0,0,0,0,0,0,0);
 
 	//done !
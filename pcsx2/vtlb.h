@@ -69,6 +69,10 @@ extern void vtlb_DynV2P();
 extern void vtlb_VMap(u32 vaddr,u32 paddr,u32 sz);
 extern void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 sz);
 extern void vtlb_VMapUnmap(u32 vaddr,u32 sz);
+extern void vtlb_VMapWatch(u32 vaddr,u32 sz);
+extern void vtlb_VMapUnwatch(u32 vaddr,u32 sz);
+extern bool vtlb_IsWatched(u32 vaddr);
+extern sptr vtlb_GetVMapEntry(u32 vaddr);
 
 //Memory functions
 
@@ -95,6 +95,7 @@ static BASEBLOCKEX* s_pCurBlockEx = NULL;
 u32 s_nEndBlock = 0; // what pc the current block ends
 u32 s_branchTo;
 static bool s_nBlockFF;
+static u32 s_nBlockFFpc; // where the block goes when it stays in its wait loop
 
 // save states for branches
 GPR_reg64 s_saveConstRegs[32];
@@ -1028,7 +1029,7 @@ static void iBranchTest(u32 newpc)
 	//    cpuRegs.cycle += blockcycles;
 	//    if( cpuRegs.cycle > g_nextEventCycle ) { DoEvents(); }
 
-	if (EmuConfig.Speedhacks.WaitLoop && s_nBlockFF && newpc == s_branchTo)
+	if (EmuConfig.Speedhacks.WaitLoop && s_nBlockFF && newpc == s_nBlockFFpc)
 	{
 		xMOV(eax, ptr32[&g_nextEventCycle]);
 		xADD(ptr32[&cpuRegs.cycle], scaleblockcycles());
@@ -1152,78 +1153,6 @@ void dynarecCheckBreakpoint()
 	recExitExecution();
 }
 
-void dynarecMemcheck()
-{
-	u32 pc = cpuRegs.pc;
- 	if (CBreakPoints::CheckSkipFirst(pc) != 0)
-		return;
-
-	CBreakPoints::SetBreakpointTriggered(true);
-	GetCoreThread().PauseSelfDebug();
-	recExitExecution();
-}
-
-void __fastcall dynarecMemLogcheck(u32 start, bool store)
-{
-	if (store)
-		DevCon.WriteLn("Hit store breakpoint @0x%x", start);
-	else
-		DevCon.WriteLn("Hit load breakpoint @0x%x", start);
-}
-
-void recMemcheck(u32 op, u32 bits, bool store)
-{
-	iFlushCall(FLUSH_EVERYTHING|FLUSH_PC);
-
-	// compute accessed address
-	_eeMoveGPRtoR(ecx, (op >> 21) & 0x1F);
-	if ((s16)op != 0)
-		xADD(ecx, (s16)op);
-	if (bits == 128)
-		xAND(ecx, ~0x0F);
-
-	xFastCall((void*)standardizeBreakpointAddress, ecx);
-	xMOV(ecx,eax);
-	xMOV(edx,eax);
-	xADD(edx,bits/8);
-
-	// ecx = access address
-	// edx = access address+size
-
-	auto checks = CBreakPoints::GetMemChecks();
-	for (size_t i = 0; i < checks.size(); i++)
-	{
-		if (checks[i].result == 0)
-			continue;
-		if ((checks[i].cond & MEMCHECK_WRITE) == 0 && store)
-			continue;
-		if ((checks[i].cond & MEMCHECK_READ) == 0 && !store)
-			continue;
-
-		// logic: memAddress < bpEnd && bpStart < memAddress+memSize
-
-		xMOV(eax,standardizeBreakpointAddress(checks[i].end));
-		xCMP(ecx,eax);				// address < end
-		xForwardJGE8 next1;			// if address >= end then goto next1
-
-		xMOV(eax,standardizeBreakpointAddress(checks[i].start));
-		xCMP(eax,edx);				// start < address+size
-		xForwardJGE8 next2;			// if start >= address+size then goto next2
-
-		// hit the breakpoint
-		if (checks[i].result & MEMCHECK_LOG) {
-			xMOV(edx, store);
-			xFastCall((void*)dynarecMemLogcheck, ecx, edx);
-		}
-		if (checks[i].result & MEMCHECK_BREAK) {
-			xFastCall((void*)dynarecMemcheck);
-		}
-
-		next1.SetTarget();
-		next2.SetTarget();
-	}
-}
-
 void encodeBreakpoint()
 {
 	if (isBreakpointNeeded(pc) != 0)
@@ -1233,36 +1162,6 @@ void encodeBreakpoint()
 	}
 }
 
-void encodeMemcheck()
-{
-	int needed = isMemcheckNeeded(pc);
-	if (needed == 0)
-		return;
-
-	u32 op = memRead32(needed == 2 ? pc+4 : pc);
-	const OPCODE& opcode = GetInstruction(op);
-
-	bool store = (opcode.flags & IS_STORE) != 0;
-	switch (opcode.flags & MEMTYPE_MASK)
-	{
-	case MEMTYPE_BYTE:
-		recMemcheck(op,8,store);
-		break;
-	case MEMTYPE_HALF:
-		recMemcheck(op,16,store);
-		break;
-	case MEMTYPE_WORD:
-		recMemcheck(op,32,store);
-		break;
-	case MEMTYPE_DWORD:
-		recMemcheck(op,64,store);
-		break;
-	case MEMTYPE_QWORD:
-		recMemcheck(op,128,store);
-		break;
-	}
-}
-
 void recompileNextInstruction(int delayslot)
 {
 	u32 i;
@@ -1272,7 +1171,6 @@ void recompileNextInstruction(int delayslot)
 	if (!delayslot)
 	{
 		encodeBreakpoint();
-		encodeMemcheck();
 	}
 
 	s_pCode = (int *)PSM( pc );
@@ -1348,6 +1246,13 @@ void recompileNextInstruction(int delayslot)
 	else {
 		//If the COP0 DIE bit is disabled, cycles should be doubled.
 		s_nBlockCycles += opcode.cycles * (2 - ((cpuRegs.CP0.n.Config >> 18) & 0x1));
+
+		// Tell the watch handlers which instruction accesses memory, cpuRegs.pc is only
+		// flushed at the end of the block.  Watching new pages resets the rec, so every
+		// block that can reach them has this.
+		if ((opcode.flags & IS_MEMORY) && CBreakPoints::GetNumMemchecks() != 0)
+			xMOV(ptr32[&eeMemCheckPC], delayslot ? pc : pc - 4);
+
 		try {
 			opcode.recompile();
 		} catch (Exception::FailedToAllocateRegister&) {
@@ -1600,6 +1505,169 @@ bool skipMPEG_By_Pattern(u32 sPC) {
 	return 0;
 }
 
+// The idea here is that as long as a loop doesn't write to a register it's already read
+// (excepting registers initialised with constants or memory loads) or use any instructions
+// which alter the machine state apart from registers, it will do the same thing on every
+// iteration.
+// TODO: special handling for counting loops.  God of war wastes time in a loop which just
+// counts to some large number and does nothing else, many other games use a counter as a
+// timeout on a register read.  AFAICS the only way to optimise this for non-const cases
+// without a significant loss in cycle accuracy is with a division, but games would probably
+// be happy with time wasting loops completing in 0 cycles and timeouts waiting forever.
+// Registers in keep must not be written at all.
+static bool recWaitLoopInst(u32& reads, u32& loads, u32 keep = 0)
+{
+	u32 src, dst;
+
+	// nop
+	if (cpuRegs.code == 0)
+		return true;
+	// cache, sync
+	else if (_Opcode_ == 057 || _Opcode_ == 0 && _Funct_ == 017)
+		return true;
+	// imm arithmetic, loads
+	else if ((_Opcode_ & 070) == 010 || (_Opcode_ & 076) == 030 || (_Opcode_ & 070) == 040 || (_Opcode_ & 076) == 032 || _Opcode_ == 067)
+	{
+		src = 1 << _Rs_;
+		dst = 1 << _Rt_;
+	}
+	// common register arithmetic instructions
+	else if (_Opcode_ == 0 && (_Funct_ & 060) == 040 && (_Funct_ & 076) != 050)
+	{
+		src = 1 << _Rs_ | 1 << _Rt_;
+		dst = 1 << _Rd_;
+	}
+	// mfc*, cfc*
+	else if ((_Opcode_ & 074) == 020 && _Rs_ < 4)
+	{
+		src = 0;
+		dst = 1 << _Rt_;
+	}
+	else
+		return false;
+
+	// A register written earlier in the iteration holds the same value every time, so it
+	// can be read and overwritten freely, the rest must not change once they have been read.
+	reads |= src & ~loads;
+	if ((reads | keep) & dst)
+		return false;
+	loads |= dst;
+	return true;
+}
+
+// Follows the path a loop starting at startpc takes until it comes back: through the
+// block's own branch, unconditional jumps, calls to leaf functions, and conditional
+// branches, which are assumed to exit the loop unless they go back to startpc.  Loops
+// polling a flag are often split over several blocks (a branch out when the flag is set
+// followed by a jump back, or a call to a small getter), this covers them as well as the
+// block branching to itself.  The path is kept within startpc's page, so that anything
+// it depends on is cleared along with the block.
+// Returns the pc the block ending at endpc continues at when it stays in the loop, or
+// 0xffffffff if the path does anything besides loading and comparing.
+static u32 recWaitLoopNext(u32 startpc, u32 endpc)
+{
+	const u32 page = startpc & ~0xfff;
+	u32 reads = 0, loads = 1;
+	u32 next = 0xffffffff;
+	u32 ret = 0;
+	u32 i = startpc;
+
+	for (int count = 0; count < 64; count++)
+	{
+		if ((i & ~0xfff) != page || !PSM(i))
+			return 0xffffffff;
+
+		cpuRegs.code = *(u32*)PSM(i);
+
+		u32 target = 0;
+		bool likely = false;
+
+		switch (_Opcode_)
+		{
+			case 0: // special
+				if (_Funct_ == 8 && _Rs_ == 31 && ret != 0) // JR RA from a call on the path
+					target = ret;
+				else if (_Funct_ == 8 || _Funct_ == 9)
+					return 0xffffffff;
+				break;
+
+			case 1: // regimm
+				if (_Rt_ >= 16)
+					return 0xffffffff; // and link, or traps
+				if (_Rt_ < 4) {
+					target = _Imm_ * 4 + i + 4;
+					likely = _Rt_ >= 2;
+				}
+				break;
+
+			case 3: // JAL
+				if (ret != 0)
+					return 0xffffffff;
+				ret = i + 8;
+				loads |= 1 << 31;
+				// Fall through!
+
+			case 2: // J
+				target = _Target_ << 2 | (i + 4) & 0xf0000000;
+				break;
+
+			case 4: case 5: case 6: case 7:
+				target = _Imm_ * 4 + i + 4;
+				break;
+
+			case 20: case 21: case 22: case 23:
+				target = _Imm_ * 4 + i + 4;
+				likely = true;
+				break;
+
+			case 16: case 17: case 18: // BCzF, BCzT, BCzFL, BCzTL
+				if (_Rs_ == 8) {
+					target = _Imm_ * 4 + i + 4;
+					likely = _Rt_ >= 2;
+				}
+				break;
+		}
+
+		// the return address of a call on the path has to survive until the JR RA
+		const u32 keep = ret != 0 ? 1u << 31 : 0;
+
+		if (target == 0)
+		{
+			if (!recWaitLoopInst(reads, loads, keep))
+				return 0xffffffff;
+			i += 4;
+			continue;
+		}
+
+		// the block has to end with the first branch on the path
+		if (next == 0xffffffff && i != endpc - 8)
+			return 0xffffffff;
+
+		// J, JAL, JR, and B (BEQ $0,$0) always go to their target, the other branches
+		// stay in the loop only when they go back to startpc.
+		bool always = _Opcode_ == 2 || _Opcode_ == 3 || _Opcode_ == 0 || _Opcode_ == 4 && _Rs_ == 0 && _Rt_ == 0;
+		bool taken = always || target == startpc;
+		u32 to = taken ? target : i + 8;
+		if (_Opcode_ == 0 && target == ret)
+			ret = 0;
+
+		if (taken || !likely)
+		{
+			cpuRegs.code = *(u32*)PSM(i + 4);
+			if ((i + 4 & ~0xfff) != page || !recWaitLoopInst(reads, loads, ret != 0 ? 1u << 31 : 0))
+				return 0xffffffff;
+		}
+
+		if (next == 0xffffffff)
+			next = to;
+		if (to == startpc)
+			return next;
+		i = to;
+	}
+
+	return 0xffffffff;
+}
+
 // defined at AppCoreThread.cpp but unclean and should not be public. We're the only
 // consumers of it, so it's declared only here.
 void LoadAllPatchesAndStuff(const Pcsx2Config&);
@@ -1738,9 +1806,7 @@ static void __fastcall recRecompile( const u32 startpc )
 	s_branchTo = -1;
 
 	// compile breakpoints as individual blocks
-	int n1 = isBreakpointNeeded(i);
-	int n2 = isMemcheckNeeded(i);
-	int n = std::max<int>(n1,n2);
+	int n = isBreakpointNeeded(i);
 	if (n != 0)
 	{
 		s_nEndBlock = i + n*4;
@@ -1751,7 +1817,7 @@ static void __fastcall recRecompile( const u32 startpc )
 		BASEBLOCK* pblock = PC_GETBLOCK(i);
 
 		// stop before breakpoints
-		if (isBreakpointNeeded(i) != 0 || isMemcheckNeeded(i) != 0)
+		if (isBreakpointNeeded(i) != 0)
 		{
 			s_nEndBlock = i;
 			break;
@@ -1843,84 +1909,11 @@ static void __fastcall recRecompile( const u32 startpc )
 
 StartRecomp:
 
-	// The idea here is that as long as a loop doesn't write to a register it's already read
-	// (excepting registers initialised with constants or memory loads) or use any instructions
-	// which alter the machine state apart from registers, it will do the same thing on every
-	// iteration.
-	// TODO: special handling for counting loops.  God of war wastes time in a loop which just
-	// counts to some large number and does nothing else, many other games use a counter as a
-	// timeout on a register read.  AFAICS the only way to optimise this for non-const cases
-	// without a significant loss in cycle accuracy is with a division, but games would probably
-	// be happy with time wasting loops completing in 0 cycles and timeouts waiting forever.
 	s_nBlockFF = false;
-	if (s_branchTo == startpc) {
-		s_nBlockFF = true;
-
-		u32 reads = 0, loads = 1;
-
-		for (i = startpc; i < s_nEndBlock; i += 4) {
-			if (i == s_nEndBlock - 8)
-				continue;
-			cpuRegs.code = *(u32*)PSM(i);
-			// nop
-			if (cpuRegs.code == 0)
-				continue;
-			// cache, sync
-			else if (_Opcode_ == 057 || _Opcode_ == 0 && _Funct_ == 017)
-				continue;
-			// imm arithmetic
-			else if ((_Opcode_ & 070) == 010 || (_Opcode_ & 076) == 030)
-			{
-				if (loads & 1 << _Rs_) {
-					loads |= 1 << _Rt_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_;
-				if (reads & 1 << _Rt_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// common register arithmetic instructions
-			else if (_Opcode_ == 0 && (_Funct_ & 060) == 040 && (_Funct_ & 076) != 050)
-			{
-				if (loads & 1 << _Rs_ && loads & 1 << _Rt_) {
-					loads |= 1 << _Rd_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_ | 1 << _Rt_;
-				if (reads & 1 << _Rd_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// loads
-			else if ((_Opcode_ & 070) == 040 || (_Opcode_ & 076) == 032 || _Opcode_ == 067)
-			{
-				if (loads & 1 << _Rs_) {
-					loads |= 1 << _Rt_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_;
-				if (reads & 1 << _Rt_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// mfc*, cfc*
-			else if ((_Opcode_ & 074) == 020 && _Rs_ < 4)
-			{
-				loads |= 1 << _Rt_;
-			}
-			else
-			{
-				s_nBlockFF = false;
-				break;
-			}
-		}
+	if (EmuConfig.Speedhacks.WaitLoop)
+	{
+		s_nBlockFFpc = recWaitLoopNext(startpc, s_nEndBlock);
+		s_nBlockFF = s_nBlockFFpc != 0xffffffff;
 	}
 
 	// rec info //
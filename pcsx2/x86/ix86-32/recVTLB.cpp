@@ -21,6 +21,7 @@
 
 #include "iCore.h"
 #include "iR5900.h"
+#include "IPU/IPU.h"
 #include "Utilities/Perf.h"
 
 using namespace vtlb_private;
@@ -464,6 +465,13 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 		// Shortcut for the INTC_STAT register, which many games like to spin on heavily.
 		if( (bits == 32) && !EmuConfig.Speedhacks.IntcStat && (paddr == INTC_STAT) )
 		{
+			// INTC_IPU may still be pending on the IPU thread.
+			iFlushCall(FLUSH_FULLVTLB);
+			xCMP( ptr8[&ipuWorkerPending], 0 );
+			xForwardJZ8 skip;
+			xFastCall( (void*)(uptr)ipuWorkerSync );
+			skip.SetTarget();
+
 			xMOV( eax, ptr[&psHu32( INTC_STAT )] );
 		}
 		else
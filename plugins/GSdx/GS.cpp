@@ -933,6 +933,113 @@ EXPORT_C GSsetExclusive(int enabled)
 	}
 }
 
+// Replays an indexed dump from the keyframe at or before start_frame, the frames before start_frame
+// are only fast-forwarded. Returns the number of frames shown.
+
+static long ReplayIndexed(GSDumpIndexedFile& file, uint8* regs, int start_frame)
+{
+	static std::vector<uint8> buff;
+
+	int frame = file.Seek(start_frame);
+	long shown = 0;
+	bool keyframe = true;
+
+	GSDumpPacket p;
+
+	while(file.Read(p))
+	{
+		switch(p.type)
+		{
+			case 0:
+
+				switch(p.param)
+				{
+					case 0:
+						if(p.size <= 0x4000)
+						{
+							if(buff.size() < 0x4000) buff.resize(0x4000);
+							memcpy(&buff[0x4000 - p.size], p.data, p.size);
+							GSgifTransfer1(&buff[0], 0x4000 - p.size);
+						}
+						break;
+					case 1: GSgifTransfer2(const_cast<uint8*>(p.data), p.size / 16); break;
+					case 2: GSgifTransfer3(const_cast<uint8*>(p.data), p.size / 16); break;
+					case 3: GSgifTransfer(p.data, p.size / 16); break;
+				}
+
+				break;
+
+			case 1:
+
+				if(frame >= start_frame)
+				{
+					GSvsync(p.param);
+					shown++;
+				}
+
+				frame++;
+
+				break;
+
+			case 2:
+
+				if(buff.size() < p.size) buff.resize(p.size);
+
+				GSreadFIFO2(&buff[0], p.size / 16);
+
+				break;
+
+			case 3:
+
+				memcpy(regs, p.data, 0x2000);
+
+				break;
+
+			case 4:
+
+				// only the keyframe Seek moved to is restored, the state matches the others already
+
+				if(keyframe)
+				{
+					GSFreezeData fd = {(int)p.size, const_cast<uint8*>(p.data)};
+					GSfreeze(FREEZE_LOAD, &fd);
+					memcpy(regs, p.data + p.size, 0x2000);
+				}
+
+				break;
+		}
+
+		keyframe = false;
+	}
+
+	return shown;
+}
+
+// Returns the indexed dump to replay, converting the stream format dump f first when "dump_convert" is set
+
+static std::string GetIndexedDump(const std::string& f)
+{
+	if(f.size() >= 4 && f.compare(f.size() - 4, 4, ".gsi") == 0)
+		return f;
+
+	if(theApp.GetConfigB("dump_convert"))
+	{
+		std::string base = f;
+		bool is_xz = base.size() >= 4 && base.compare(base.size() - 3, 3, ".xz") == 0;
+		if(is_xz) base.erase(base.size() - 3);
+		if(base.size() >= 3 && base.compare(base.size() - 3, 3, ".gs") == 0) base.erase(base.size() - 3);
+
+		fprintf(stderr, "Converting %s to %s.gsi\n", f.c_str(), base.c_str());
+
+		if(GSDumpIndexed::Convert(f.c_str(), base))
+			return base + ".gsi";
+
+		fprintf(stderr, "Failed to convert %s\n", f.c_str());
+	}
+
+	return std::string();
+}
+
 #ifdef _WIN32
 
 #include <io.h>
@@ -1027,6 +1134,43 @@ EXPORT_C GSReplay(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow)
 
 	const std::string f{lpszCmdLine};
 	const bool is_xz = f.size() >= 4 && f.compare(f.size() - 3, 3, ".xz") == 0;
+	const std::string indexed = GetIndexedDump(f);
+
+	if(!indexed.empty())
+	{
+		GSDumpIndexedFile file(indexed.c_str());
+
+		GSinit();
+
+		std::array<uint8, 0x2000> regs;
+		GSsetBaseMem(regs.data());
+
+		s_vsync = theApp.GetConfigI("vsync");
+
+		HWND hWnd = nullptr;
+
+		_GSopen((void**)&hWnd, "", renderer);
+
+		GSsetGameCRC(file.GetCRC(), 0);
+
+		int start_frame = theApp.GetConfigI("replay_start_frame");
+
+		GSvsync(1);
+
+		Sleep(100);
+
+		while(IsWindowVisible(hWnd))
+		{
+			ReplayIndexed(file, regs.data(), start_frame);
+		}
+
+		Sleep(100);
+
+		GSclose();
+		GSshutdown();
+
+		return;
+	}
 
 	auto file = is_xz
 		? std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpLzma>(lpszCmdLine, nullptr)}
@@ -1402,6 +1546,15 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 	}
 	if (s_gs->m_wnd == NULL) return;
 
+	std::string indexed = GetIndexedDump(lpszCmdLine);
+	GSDumpIndexedFile* indexed_file = NULL;
+	int start_frame = theApp.GetConfigI("replay_start_frame");
+
+	if (!indexed.empty()) {
+		indexed_file = new GSDumpIndexedFile(indexed.c_str());
+		GSsetGameCRC(indexed_file->GetCRC(), 0);
+	}
+	else
 	{ // Read .gs content
 		std::string f(lpszCmdLine);
 		bool is_xz = (f.size() >= 4) && (f.compare(f.size()-3, 3, ".xz") == 0);
@@ -1496,6 +1649,9 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 
 	while(finished > 0)
 	{
+		if (indexed_file)
+			frame_number += ReplayIndexed(*indexed_file, regs, start_frame);
+
 		for(auto i = packets.begin(); i != packets.end(); i++)
 		{
 			Packet* p = *i;
@@ -1564,6 +1720,8 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 
 	packets.clear();
 
+	delete indexed_file;
+
 	sleep(2);
 
 	GSclose();
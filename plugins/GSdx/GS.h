@@ -1122,8 +1122,9 @@ struct alignas(32) GIFPath
 	uint32 reg;
 	uint32 type;
 	GSVector4i regs;
+	uint64 jit; // TYPE_JIT: REGS | NREG << 48, see GSGIFPackedSelector
 
-	enum {TYPE_UNKNOWN, TYPE_ADONLY, TYPE_STQRGBAXYZF2, TYPE_STQRGBAXYZ2};
+	enum {TYPE_UNKNOWN, TYPE_ADONLY, TYPE_STQRGBAXYZF2, TYPE_STQRGBAXYZ2, TYPE_JIT};
 
 	__forceinline void SetTag(const void* mem)
 	{
@@ -1186,6 +1187,28 @@ struct alignas(32) GIFPath
 				default:
 					__assume(0);
 				}
+
+				if(type == TYPE_UNKNOWN && nreg <= 12)
+				{
+					// only registers that cannot change the drawing state (PRIM, A+D and the TEX0/CLAMP group can)
+
+					uint32 used = 0;
+
+					for(uint32 i = 0; i < nreg; i++)
+					{
+						used |= 1 << regs.u8[i];
+					}
+
+					const uint32 allowed =
+						(1 << GIF_REG_RGBA) | (1 << GIF_REG_STQ) | (1 << GIF_REG_UV) | (1 << GIF_REG_FOG) | (1 << GIF_REG_NOP) |
+						(1 << GIF_REG_XYZF2) | (1 << GIF_REG_XYZ2) | (1 << GIF_REG_XYZF3) | (1 << GIF_REG_XYZ3);
+
+					if((used & ~allowed) == 0)
+					{
+						type = TYPE_JIT;
+						jit = (src->REGS & ((1ull << (nreg << 2)) - 1)) | ((uint64)nreg << 48);
+					}
+				}
 			}
 		}
 	}
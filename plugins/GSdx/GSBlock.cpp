@@ -30,6 +30,11 @@ GSVector4i GSBlock::m_r16mask;
 GSVector4i GSBlock::m_r8mask;
 GSVector4i GSBlock::m_r4mask;
 
+#if _M_SSE >= 0x501
+GSVector8i GSBlock::m_r8perm[2];
+GSVector8i GSBlock::m_r4wmask[2];
+#endif
+
 #if _M_SSE >= 0x501
 GSVector8i GSBlock::m_xxxa;
 GSVector8i GSBlock::m_xxbx;
@@ -57,6 +62,13 @@ void GSBlock::InitVectors()
 	m_r8mask = GSVector4i(0, 4, 2, 6, 8, 12, 10, 14, 1, 5, 3, 7, 9, 13, 11, 15);
 	m_r4mask = GSVector4i(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
 
+#if _M_SSE >= 0x501
+	m_r8perm[0] = GSVector8i(0, 4, 1, 5, 2, 6, 3, 7);
+	m_r8perm[1] = GSVector8i(4, 0, 5, 1, 6, 2, 7, 3);
+	m_r4wmask[0] = GSVector8i(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15, 8, 9, 0, 1, 10, 11, 2, 3, 12, 13, 4, 5, 14, 15, 6, 7);
+	m_r4wmask[1] = GSVector8i(8, 9, 0, 1, 10, 11, 2, 3, 12, 13, 4, 5, 14, 15, 6, 7, 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+#endif
+
 #if _M_SSE >= 0x501
 	m_xxxa = GSVector8i(0x00008000);
 	m_xxbx = GSVector8i(0x00007c00);
@@ -35,6 +35,11 @@ class GSBlock
 	static GSVector4i m_r8mask;
 	static GSVector4i m_r4mask;
 
+	#if _M_SSE >= 0x501
+	static GSVector8i m_r8perm[2];
+	static GSVector8i m_r4wmask[2];
+	#endif
+
 	#if _M_SSE >= 0x501
 	static GSVector8i m_xxxa;
 	static GSVector8i m_xxbx;
@@ -332,6 +337,39 @@ public:
 
 		// TODO: pshufb
 
+		#if _M_SSE >= 0x501
+
+		// same steps as below, rows 0-1 and 2-3 share a register, every pair of the swaps is in the same lane
+
+		GSVector4i v4 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
+		GSVector4i v5 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
+		GSVector4i v6 = GSVector4i::load<alignment != 0>(&src[srcpitch * 2]);
+		GSVector4i v7 = GSVector4i::load<alignment != 0>(&src[srcpitch * 3]);
+
+		GSVector8i v0(v4, v5);
+		GSVector8i v1(v6, v7);
+
+		if((i & 1) == 0)
+		{
+			v1 = v1.yxwzlh();
+		}
+		else
+		{
+			v0 = v0.yxwzlh();
+		}
+
+		GSVector8i::sw4(v0, v1);
+		GSVector8i::sw8(v0, v1);
+		GSVector8i::sw8(v0, v1);
+
+		v0 = v0.acbd();
+		v1 = v1.acbd();
+
+		((GSVector8i*)dst)[i * 2 + 0] = v0;
+		((GSVector8i*)dst)[i * 2 + 1] = v1;
+
+		#else
+
 		GSVector4i v0 = GSVector4i::load<alignment != 0>(&src[srcpitch * 0]);
 		GSVector4i v1 = GSVector4i::load<alignment != 0>(&src[srcpitch * 1]);
 		GSVector4i v2 = GSVector4i::load<alignment != 0>(&src[srcpitch * 2]);
@@ -357,6 +395,8 @@ public:
 		((GSVector4i*)dst)[i * 4 + 1] = v1;
 		((GSVector4i*)dst)[i * 4 + 2] = v2;
 		((GSVector4i*)dst)[i * 4 + 3] = v3;
+
+		#endif
 	}
 
 	template<int alignment, uint32 mask> static void WriteColumn32(int y, uint8* RESTRICT dst, const uint8* RESTRICT src, int srcpitch)
@@ -556,29 +596,37 @@ public:
 	{
 		//for(int j = 0; j < 64; j++) ((uint8*)src)[j] = (uint8)j;
 
-		#if 0//_M_SSE >= 0x501
+		#if _M_SSE >= 0x501
+
+		// the ssse3 steps below, rows 0-2 and 1-3 share a register, the last swap is a dword permute
 
-		const GSVector8i* s = (const GSVector8i*)src;
-		
-		GSVector8i v0 = s[i * 2 + 0];
-		GSVector8i v1 = s[i * 2 + 1];
+		const GSVector4i* s = (const GSVector4i*)src;
 
-		GSVector8i::sw8(v0, v1);
-		GSVector8i::sw16(v0, v1);
-		GSVector8i::sw8(v0, v1);
-		GSVector8i::sw128(v0, v1);
-		GSVector8i::sw16(v0, v1);
+		GSVector8i v0, v1;
 
-		v0 = v0.acbd();
-		v1 = v1.acbd();
-		v1 = v1.yxwz();
+		if((i & 1) == 0)
+		{
+			v0 = GSVector8i::cast(s[i * 4 + 0]).insert<1>(s[i * 4 + 2]);
+			v1 = GSVector8i::cast(s[i * 4 + 1]).insert<1>(s[i * 4 + 3]);
+		}
+		else
+		{
+			v0 = GSVector8i::cast(s[i * 4 + 2]).insert<1>(s[i * 4 + 0]);
+			v1 = GSVector8i::cast(s[i * 4 + 3]).insert<1>(s[i * 4 + 1]);
+		}
+
+		GSVector8i mask = GSVector8i::broadcast128(m_r8mask);
+
+		v0 = v0.shuffle8(mask);
+		v1 = v1.shuffle8(mask);
+
+		GSVector8i::sw16(v0, v1);
 
-		GSVector8i::storel(&dst[dstpitch * 0], v0);
-		GSVector8i::storeh(&dst[dstpitch * 1], v0);
-		GSVector8i::storel(&dst[dstpitch * 2], v1);
-		GSVector8i::storeh(&dst[dstpitch * 3], v1);
+		v0 = v0.permute32(m_r8perm[0]);
+		v1 = v1.permute32(m_r8perm[1]);
 
-		// TODO: not sure if this is worth it, not in this form, there should be a shorter path
+		GSVector8i::store(&dst[dstpitch * 0], &dst[dstpitch * 1], v0);
+		GSVector8i::store(&dst[dstpitch * 2], &dst[dstpitch * 3], v1);
 
 		#elif _M_SSE >= 0x301
 
@@ -651,7 +699,28 @@ public:
 	{
 		//printf("ReadColumn4\n");
 
-		#if _M_SSE >= 0x301
+		#if _M_SSE >= 0x501
+
+		// the ssse3 steps below, the last swap interleaves the words of the qwords moved next to each other
+
+		const GSVector4i* s = (const GSVector4i*)src;
+
+		GSVector8i v0 = GSVector8i::cast(s[i * 4 + 0]).insert<1>(s[i * 4 + 2]).xzyw();
+		GSVector8i v1 = GSVector8i::cast(s[i * 4 + 1]).insert<1>(s[i * 4 + 3]).xzyw();
+
+		GSVector8i::sw64(v0, v1);
+		GSVector8i::sw4(v0, v1);
+		GSVector8i::sw8(v0, v1);
+
+		GSVector8i mask = GSVector8i::broadcast128(m_r4mask);
+
+		v0 = v0.shuffle8(mask).acbd().shuffle8(m_r4wmask[i & 1]);
+		v1 = v1.shuffle8(mask).acbd().shuffle8(m_r4wmask[i & 1]);
+
+		GSVector8i::store(&dst[dstpitch * 0], &dst[dstpitch * 2], v0);
+		GSVector8i::store(&dst[dstpitch * 1], &dst[dstpitch * 3], v1);
+
+		#elif _M_SSE >= 0x301
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
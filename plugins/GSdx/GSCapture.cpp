@@ -384,6 +384,147 @@ static IPin* GetFirstPin(IBaseFilter* pBF, PIN_DIRECTION dir)
 
 #endif
 
+#if defined(__unix__)
+
+static void ConvertYUV420(const uint8* RESTRICT src, int w, int h, bool rb_swapped, uint8* RESTRICT dst)
+{
+	// full range bt.601 with 7-bit weights, the chroma of each 2x2 quad is taken from its average colour
+	// w is a multiple of 16, h of 2, the channels stay in 32-bit lanes until the final packs
+
+	uint8* RESTRICT py = dst;
+	uint8* RESTRICT pu = py + w * h;
+	uint8* RESTRICT pv = pu + w * h / 4;
+
+	int pitch = w * 4;
+
+#if defined(__AVX2__)
+
+	// the same steps as the GSVector4i loop below on 16 pixels, in plain intrinsics because gcc x64
+	// builds keep _M_SSE at 0x500 (no GSVector8i) even when compiled with -mavx2
+
+	const __m256i mask = _mm256_set1_epi32(0x000000ff);
+	const __m256i mask16 = _mm256_set1_epi32(0x0000ffff);
+	const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	#define MUL(a, c) _mm256_mullo_epi16(a, _mm256_set1_epi32(c))
+
+	for(int y = 0; y < h; y += 2, py += w * 2, pu += w / 2, pv += w / 2)
+	{
+		const __m256i* s0 = (const __m256i*)&src[pitch * (y + 0)];
+		const __m256i* s1 = (const __m256i*)&src[pitch * (y + 1)];
+
+		for(int x = 0, i = 0; x < w; x += 16, i += 2)
+		{
+			__m256i r[4], g[4], b[4];
+
+			const __m256i p[4] = {s0[i + 0], s0[i + 1], s1[i + 0], s1[i + 1]};
+
+			for(int j = 0; j < 4; j++)
+			{
+				r[j] = _mm256_and_si256(p[j], mask);
+				g[j] = _mm256_and_si256(_mm256_srli_epi32(p[j], 8), mask);
+				b[j] = _mm256_and_si256(_mm256_srli_epi32(p[j], 16), mask);
+
+				if(rb_swapped) std::swap(r[j], b[j]);
+			}
+
+			for(int j = 0; j < 4; j += 2)
+			{
+				__m256i y0 = _mm256_add_epi32(_mm256_add_epi32(MUL(r[j + 0], 38), MUL(g[j + 0], 75)), _mm256_add_epi32(MUL(b[j + 0], 15), _mm256_set1_epi32(64)));
+				__m256i y1 = _mm256_add_epi32(_mm256_add_epi32(MUL(r[j + 1], 38), MUL(g[j + 1], 75)), _mm256_add_epi32(MUL(b[j + 1], 15), _mm256_set1_epi32(64)));
+
+				__m256i yy = _mm256_packs_epi32(_mm256_srli_epi32(y0, 7), _mm256_srli_epi32(y1, 7));
+
+				yy = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(yy, yy), perm);
+
+				GSVector4i::store<false>(&py[w * (j >> 1) + x], GSVector4i(_mm256_castsi256_si128(yy)));
+			}
+
+			__m256i rs = _mm256_packs_epi32(_mm256_add_epi32(r[0], r[2]), _mm256_add_epi32(r[1], r[3]));
+			__m256i gs = _mm256_packs_epi32(_mm256_add_epi32(g[0], g[2]), _mm256_add_epi32(g[1], g[3]));
+			__m256i bs = _mm256_packs_epi32(_mm256_add_epi32(b[0], b[2]), _mm256_add_epi32(b[1], b[3]));
+
+			rs = _mm256_srli_epi16(_mm256_add_epi16(_mm256_and_si256(_mm256_add_epi16(rs, _mm256_srli_epi32(rs, 16)), mask16), _mm256_set1_epi32(2)), 2);
+			gs = _mm256_srli_epi16(_mm256_add_epi16(_mm256_and_si256(_mm256_add_epi16(gs, _mm256_srli_epi32(gs, 16)), mask16), _mm256_set1_epi32(2)), 2);
+			bs = _mm256_srli_epi16(_mm256_add_epi16(_mm256_and_si256(_mm256_add_epi16(bs, _mm256_srli_epi32(bs, 16)), mask16), _mm256_set1_epi32(2)), 2);
+
+			__m256i u = _mm256_sub_epi16(_mm256_sub_epi16(MUL(bs, 64), MUL(rs, 22)), MUL(gs, 42));
+			__m256i v = _mm256_sub_epi16(_mm256_sub_epi16(MUL(rs, 64), MUL(gs, 54)), MUL(bs, 10));
+
+			u = _mm256_and_si256(_mm256_add_epi16(_mm256_srai_epi16(_mm256_add_epi16(u, _mm256_set1_epi32(64)), 7), _mm256_set1_epi32(128)), mask16);
+			v = _mm256_and_si256(_mm256_add_epi16(_mm256_srai_epi16(_mm256_add_epi16(v, _mm256_set1_epi32(64)), 7), _mm256_set1_epi32(128)), mask16);
+
+			__m256i uv = _mm256_packs_epi32(_mm256_permute4x64_epi64(u, _MM_SHUFFLE(3, 1, 2, 0)), _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)));
+
+			uv = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(uv, uv), perm);
+
+			GSVector4i uv4(_mm256_castsi256_si128(uv));
+
+			GSVector4i::storel(&pu[x >> 1], uv4);
+			GSVector4i::storeh(&pv[x >> 1], uv4);
+		}
+	}
+
+	#undef MUL
+
+#else
+
+	const GSVector4i mask = GSVector4i::x000000ff();
+
+	for(int y = 0; y < h; y += 2, py += w * 2, pu += w / 2, pv += w / 2)
+	{
+		const GSVector4i* s0 = (const GSVector4i*)&src[pitch * (y + 0)];
+		const GSVector4i* s1 = (const GSVector4i*)&src[pitch * (y + 1)];
+
+		for(int x = 0, i = 0; x < w; x += 8, i += 2)
+		{
+			GSVector4i r[4], g[4], b[4];
+
+			const GSVector4i p[4] = {s0[i + 0], s0[i + 1], s1[i + 0], s1[i + 1]};
+
+			for(int j = 0; j < 4; j++)
+			{
+				r[j] = p[j] & mask;
+				g[j] = p[j].srl32(8) & mask;
+				b[j] = p[j].srl32(16) & mask;
+
+				if(rb_swapped) std::swap(r[j], b[j]);
+			}
+
+			for(int j = 0; j < 4; j += 2)
+			{
+				GSVector4i y0 = (r[j + 0].mul16l(GSVector4i(38)) + g[j + 0].mul16l(GSVector4i(75)) + b[j + 0].mul16l(GSVector4i(15)) + GSVector4i(64)).srl32(7);
+				GSVector4i y1 = (r[j + 1].mul16l(GSVector4i(38)) + g[j + 1].mul16l(GSVector4i(75)) + b[j + 1].mul16l(GSVector4i(15)) + GSVector4i(64)).srl32(7);
+
+				GSVector4i::storel(&py[w * (j >> 1) + x], y0.ps32(y1).pu16());
+			}
+
+			GSVector4i rs = (r[0] + r[2]).ps32(r[1] + r[3]);
+			GSVector4i gs = (g[0] + g[2]).ps32(g[1] + g[3]);
+			GSVector4i bs = (b[0] + b[2]).ps32(b[1] + b[3]);
+
+			rs = (rs.add16(rs.srl32(16)) & GSVector4i::x0000ffff()).add16(GSVector4i(2)).srl16(2);
+			gs = (gs.add16(gs.srl32(16)) & GSVector4i::x0000ffff()).add16(GSVector4i(2)).srl16(2);
+			bs = (bs.add16(bs.srl32(16)) & GSVector4i::x0000ffff()).add16(GSVector4i(2)).srl16(2);
+
+			GSVector4i u = bs.mul16l(GSVector4i(64)).sub16(rs.mul16l(GSVector4i(22))).sub16(gs.mul16l(GSVector4i(42)));
+			GSVector4i v = rs.mul16l(GSVector4i(64)).sub16(gs.mul16l(GSVector4i(54))).sub16(bs.mul16l(GSVector4i(10)));
+
+			u = u.add16(GSVector4i(64)).sra16(7).add16(GSVector4i(128)) & GSVector4i::x0000ffff();
+			v = v.add16(GSVector4i(64)).sra16(7).add16(GSVector4i(128)) & GSVector4i::x0000ffff();
+
+			GSVector4i uv = u.ps32(v).pu16();
+
+			*(uint32*)&pu[x >> 1] = uv.extract32<0>();
+			*(uint32*)&pv[x >> 1] = uv.extract32<1>();
+		}
+	}
+
+#endif
+}
+
+#endif
+
 //
 // GSCapture
 //
@@ -396,6 +537,7 @@ GSCapture::GSCapture()
 	m_threads = theApp.GetConfigI("capture_threads");
 #if defined(__unix__)
 	m_compression_level = theApp.GetConfigI("png_compression_level");
+	m_y4m = NULL;
 #endif
 }
 
@@ -498,8 +640,15 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 	m_size.x = theApp.GetConfigI("CaptureWidth");
 	m_size.y = theApp.GetConfigI("CaptureHeight");
 
-	for(int i = 0; i < m_threads; i++) {
-		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+	if(theApp.GetConfigB("capture_y4m"))
+	{
+		if(!BeginY4M(fps, aspect)) return false;
+	}
+	else
+	{
+		for(int i = 0; i < m_threads; i++) {
+			m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+		}
 	}
 #endif
 
@@ -530,6 +679,36 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 
 #elif defined(__unix__)
 
+	if(m_y4m)
+	{
+		int i = (int)(m_y4m_queued % countof(m_y4m_frames));
+
+		Frame& f = m_y4m_frames[i];
+
+		if(f.queued)
+		{
+			m_y4m_dropped++;
+
+			return false;
+		}
+
+		for(int y = 0; y < m_size.y; y++)
+		{
+			memcpy(&f.rgba[m_size.x * 4 * y], (const uint8*)bits + pitch * y, m_size.x * 4);
+		}
+
+		f.rb_swapped = !rgba;
+		f.converted = false;
+		f.queued = true;
+
+		m_converters[m_y4m_queued % m_converters.size()]->Push(i);
+		m_writer->Push(i);
+
+		m_y4m_queued++;
+
+		return false;
+	}
+
 	std::string out_file = m_out_dir + format("/frame.%010d.png", m_frame);
 	//GSPng::Save(GSPng::RGB_PNG, out_file, (uint8*)bits, m_size.x, m_size.y, pitch, m_compression_level);
 	m_workers[m_frame%m_threads]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level));
@@ -564,6 +743,11 @@ bool GSCapture::EndCapture()
 #elif defined(__unix__)
 	m_workers.clear();
 
+	if(m_y4m)
+	{
+		EndY4M();
+	}
+
 	m_frame = 0;
 
 #endif
@@ -572,3 +756,104 @@ bool GSCapture::EndCapture()
 
 	return true;
 }
+
+#if defined(__unix__)
+
+bool GSCapture::BeginY4M(float fps, float aspect)
+{
+	m_size.x = (m_size.x + 15) & ~15;
+	m_size.y = (m_size.y + 1) & ~1;
+
+	char local_time[16];
+	time_t cur_time = time(nullptr);
+	strftime(local_time, sizeof(local_time), "%Y%m%d%H%M%S", localtime(&cur_time));
+
+	std::string fn = m_out_dir + format("/capture_%s.y4m", local_time);
+
+	m_y4m = px_fopen(fn, "wb");
+
+	if(m_y4m == NULL)
+	{
+		fprintf(stderr, "GSCapture: cannot create %s\n", fn.c_str());
+
+		return false;
+	}
+
+	// the pixel aspect ratio of the capture size that gives the display aspect ratio
+
+	int par = (int)(aspect * m_size.y * 1000 / m_size.x + 0.5f);
+
+	fprintf(m_y4m, "YUV4MPEG2 W%d H%d F%d:1000 Ip A%d:1000 C420jpeg XCOLORRANGE=FULL\n", m_size.x, m_size.y, (int)(fps * 1000 + 0.5f), par);
+
+	for(Frame& f : m_y4m_frames)
+	{
+		f.rgba = (uint8*)_aligned_malloc(m_size.x * m_size.y * 4, 32);
+		f.yuv = (uint8*)_aligned_malloc((m_size.x * m_size.y * 3 / 2 + 31) & ~31, 32);
+		f.queued = false;
+	}
+
+	m_y4m_queued = 0;
+	m_y4m_dropped = 0;
+
+	for(int i = 0; i < m_threads; i++)
+	{
+		m_converters.push_back(std::unique_ptr<GSJobQueue<int, 16>>(new GSJobQueue<int, 16>([this](int& i) {Convert(i);})));
+	}
+
+	m_writer = std::unique_ptr<GSJobQueue<int, 16>>(new GSJobQueue<int, 16>([this](int& i) {Write(i);}));
+
+	return true;
+}
+
+void GSCapture::EndY4M()
+{
+	// the writer waits for the conversions, drain them first
+
+	m_converters.clear();
+	m_writer.reset();
+
+	fclose(m_y4m);
+
+	m_y4m = NULL;
+
+	for(Frame& f : m_y4m_frames)
+	{
+		_aligned_free(f.rgba);
+		_aligned_free(f.yuv);
+	}
+
+	fprintf(stderr, "GSCapture: %llu frames written, %llu dropped\n", (unsigned long long)(m_y4m_queued), (unsigned long long)m_y4m_dropped);
+}
+
+void GSCapture::Convert(int& i)
+{
+	Frame& f = m_y4m_frames[i];
+
+	ConvertYUV420(f.rgba, m_size.x, m_size.y, f.rb_swapped, f.yuv);
+
+	{
+		std::lock_guard<std::mutex> lock(m_y4m_lock);
+
+		f.converted = true;
+	}
+
+	m_y4m_converted.notify_all();
+}
+
+void GSCapture::Write(int& i)
+{
+	Frame& f = m_y4m_frames[i];
+
+	{
+		std::unique_lock<std::mutex> lock(m_y4m_lock);
+
+		m_y4m_converted.wait(lock, [&f]() {return f.converted;});
+	}
+
+	fwrite("FRAME\n", 6, 1, m_y4m);
+	fwrite(f.yuv, m_size.x * m_size.y * 3 / 2, 1, m_y4m);
+
+	f.queued = false;
+}
+
+#endif
@@ -47,6 +47,32 @@ class GSCapture
 	std::vector<std::unique_ptr<GSPng::Worker>> m_workers;
 	int m_compression_level;
 
+	// y4m video: m_converters turn the frames into yuv420, m_writer appends them in order,
+	// a frame arriving while its slot is still queued is dropped
+
+	struct Frame
+	{
+		uint8* rgba;
+		uint8* yuv;
+		bool rb_swapped;
+		bool converted;
+		std::atomic<bool> queued;
+	};
+
+	FILE* m_y4m;
+	Frame m_y4m_frames[8];
+	uint64 m_y4m_queued;
+	uint64 m_y4m_dropped;
+	std::mutex m_y4m_lock;
+	std::condition_variable m_y4m_converted;
+	std::vector<std::unique_ptr<GSJobQueue<int, 16>>> m_converters;
+	std::unique_ptr<GSJobQueue<int, 16>> m_writer;
+
+	bool BeginY4M(float fps, float aspect);
+	void EndY4M();
+	void Convert(int& i);
+	void Write(int& i);
+
 	#endif
 
 public:
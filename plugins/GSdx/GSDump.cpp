@@ -21,10 +21,16 @@
 
 #include "stdafx.h"
 #include "GSDump.h"
+#include "GSdx.h"
+#include "GSLzma.h"
 
 GSDumpBase::GSDumpBase(const std::string& fn)
 	: m_frames(0)
 	, m_extra_frames(2)
+	, m_dropped(0)
+	, m_job(0)
+	, m_stalls(0)
+	, m_stall_time(0)
 {
 	m_gs = px_fopen(fn, "wb");
 	if (!m_gs)
@@ -33,10 +39,63 @@ GSDumpBase::GSDumpBase(const std::string& fn)
 
 GSDumpBase::~GSDumpBase()
 {
+	StopWorker();
+
+	if (m_stalls > 0)
+		fprintf(stderr, "GSDump: GS thread waited %d times for the compressor (%.1f ms)\n", m_stalls,
+			std::chrono::duration<double, std::milli>(m_stall_time).count());
+
+	if (m_dropped > 0)
+		fprintf(stderr, "GSDump: Error %llu bytes were dropped\n", (unsigned long long)m_dropped);
+
 	if(m_gs)
 		fclose(m_gs);
 }
 
+void GSDumpBase::StartWorker()
+{
+	for (auto& job : m_jobs)
+		job = std::make_shared<Job>();
+
+	m_worker = std::make_unique<GSJobQueue<std::shared_ptr<Job>, 4>>([this](std::shared_ptr<Job>& job) {Process(*job);});
+}
+
+void GSDumpBase::StopWorker()
+{
+	if (!m_worker)
+		return;
+
+	m_worker->Wait();
+	m_worker.reset();
+}
+
+void GSDumpBase::Submit(std::vector<uint8>& data, uint64 start)
+{
+	if (!m_worker) {
+		Job job = {std::move(data), start};
+		Process(job);
+		data = std::move(job.data);
+		data.clear();
+		return;
+	}
+
+	// Three jobs at most are queued, the fourth one is done and its buffer becomes the new staging buffer
+	std::shared_ptr<Job>& job = m_jobs[m_job++ % countof(m_jobs)];
+
+	job->data.swap(data);
+	job->start = start;
+	data.clear();
+
+	if (!m_worker->TryPush(job)) {
+		auto begin = std::chrono::steady_clock::now();
+
+		m_worker->Push(job);
+
+		m_stall_time += std::chrono::steady_clock::now() - begin;
+		m_stalls++;
+	}
+}
+
 void GSDumpBase::AddHeader(uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs)
 {
 	AppendRawData(&crc, 4);
@@ -77,6 +136,8 @@ bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
 	AppendRawData(1);
 	AppendRawData(static_cast<uint8>(field));
 
+	EndFrame();
+
 	if (last)
 		m_extra_frames--;
 
@@ -89,8 +150,11 @@ void GSDumpBase::Write(const void *data, size_t size)
 		return;
 
 	size_t written = fwrite(data, 1, size, m_gs);
-	if (written != size)
-		fprintf(stderr, "GSDump: Error failed to write data\n");
+	if (written != size) {
+		if (m_dropped == 0)
+			fprintf(stderr, "GSDump: Error failed to write data\n");
+		m_dropped += size - written;
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -121,18 +185,34 @@ GSDumpXz::GSDumpXz(const std::string& fn, uint32 crc, const GSFreezeData& fd, co
 	: GSDumpBase(fn + ".gs.xz")
 {
 	m_strm = LZMA_STREAM_INIT;
+	m_out_buff.resize(1024*1024);
+
+#if LZMA_VERSION >= 50020002
+	lzma_mt mt = {};
+	mt.threads = std::max<uint32_t>(std::min<uint32_t>(lzma_cputhreads() / 2, 4), 1);
+	mt.preset = 6 /*level*/;
+	mt.check = LZMA_CHECK_CRC64;
+
+	lzma_ret ret = lzma_stream_encoder_mt(&m_strm, &mt);
+#else
 	lzma_ret ret = lzma_easy_encoder(&m_strm, 6 /*level*/, LZMA_CHECK_CRC64);
+#endif
 	if (ret != LZMA_OK) {
 		fprintf(stderr, "GSDumpXz: Error initializing LZMA encoder ! (error code %u)\n", ret);
 		return;
 	}
 
+	StartWorker();
+
 	AddHeader(crc, fd, regs);
 }
 
 GSDumpXz::~GSDumpXz()
 {
-	Flush();
+	if (!m_in_buff.empty())
+		Submit(m_in_buff);
+
+	StopWorker();
 
 	// Finish the stream
 	m_strm.avail_in = 0;
@@ -147,12 +227,8 @@ void GSDumpXz::AppendRawData(const void *data, size_t size)
 	m_in_buff.resize(old_size + size);
 	memcpy(&m_in_buff[old_size], data, size);
 
-	// Enough data was accumulated, time to write/compress it.  If compression
-	// is enabled, it will freeze PCSX2. 1GB should be enough for long dump.
-	//
-	// Note: long dumps are currently not supported so this path won't be executed
-	if (m_in_buff.size() > 1024*1024*1024)
-		Flush();
+	if (m_in_buff.size() >= 8 * 1024 * 1024)
+		Submit(m_in_buff);
 }
 
 void GSDumpXz::AppendRawData(uint8 c)
@@ -160,35 +236,247 @@ void GSDumpXz::AppendRawData(uint8 c)
 	m_in_buff.push_back(c);
 }
 
-void GSDumpXz::Flush()
+void GSDumpXz::Process(Job& job)
 {
-	if (m_in_buff.empty())
-		return;
-
-	m_strm.next_in = m_in_buff.data();
-	m_strm.avail_in = m_in_buff.size();
+	m_strm.next_in = job.data.data();
+	m_strm.avail_in = job.data.size();
 
 	Compress(LZMA_RUN, LZMA_OK);
-
-	m_in_buff.clear();
 }
 
 void GSDumpXz::Compress(lzma_action action, lzma_ret expected_status)
 {
-	std::vector<uint8> out_buff(1024*1024);
 	do {
-		m_strm.next_out = out_buff.data();
-		m_strm.avail_out = out_buff.size();
+		m_strm.next_out = m_out_buff.data();
+		m_strm.avail_out = m_out_buff.size();
 
 		lzma_ret ret = lzma_code(&m_strm, action);
 
-		if (ret != expected_status) {
+		if (ret != expected_status && ret != LZMA_OK) {
 			fprintf (stderr, "GSDumpXz: Error %d\n", (int) ret);
 			return;
 		}
 
-		size_t write_size = out_buff.size() - m_strm.avail_out;
-		Write(out_buff.data(), write_size);
+		size_t write_size = m_out_buff.size() - m_strm.avail_out;
+		Write(m_out_buff.data(), write_size);
+
+		if (ret == expected_status && action == LZMA_FINISH)
+			break;
+
+		// The threaded encoder may return before it consumed the whole input
+	} while (action == LZMA_FINISH || m_strm.avail_out == 0 || m_strm.avail_in > 0);
+}
+
+//////////////////////////////////////////////////////////////////////
+// GSDumpIndexed implementation
+//////////////////////////////////////////////////////////////////////
+
+GSDumpIndexed::GSDumpIndexed(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs, bool compress)
+	: GSDumpBase(fn + ".gsi")
+	, m_compress(compress)
+	, m_keyframe_interval(theApp.GetConfigI("dump_keyframe_interval"))
+	, m_keyframe_last(0)
+	, m_start(0)
+{
+	GSDumpIndexedHeader header = {GSDUMP_INDEXED_MAGIC, GSDUMP_INDEXED_VERSION, crc, 0};
+
+	Write(&header, sizeof(header));
+
+	m_offset = sizeof(header);
+
+	m_frames.push_back(0);
+
+	StartWorker();
+
+	KeyFrame(fd, regs);
+}
+
+GSDumpIndexed::~GSDumpIndexed()
+{
+	FlushBlock();
+
+	StopWorker();
+
+	Align();
+
+	GSDumpIndexedTrailer trailer = {m_offset, (uint32)m_blocks.size(), (uint32)m_frames.size(), (uint32)m_keyframes.size(), 0, GSDUMP_INDEXED_MAGIC, GSDUMP_INDEXED_VERSION};
+
+	Write(m_blocks.data(), m_blocks.size() * sizeof(m_blocks[0]));
+	Write(m_frames.data(), m_frames.size() * sizeof(m_frames[0]));
+	Write(m_keyframes.data(), m_keyframes.size() * sizeof(m_keyframes[0]));
+	Write(&trailer, sizeof(trailer));
+}
+
+void GSDumpIndexed::Align()
+{
+	static const uint8 pad[16] = {0};
+
+	size_t size = (size_t)(0 - m_offset) & 15;
+
+	Write(pad, size);
+
+	m_offset += size;
+}
+
+void GSDumpIndexed::FlushBlock()
+{
+	if (m_block.empty())
+		return;
+
+	uint64 start = m_start;
+
+	m_start += m_block.size();
+
+	Submit(m_block, start);
+}
+
+void GSDumpIndexed::Process(Job& job)
+{
+	Align();
+
+	GSDumpIndexedBlock block = {m_offset, job.start, (uint32)job.data.size(), 0};
+
+	if (m_compress) {
+		m_packed.resize(lzma_stream_buffer_bound(job.data.size()));
+		size_t out_pos = 0;
+
+		lzma_ret ret = lzma_easy_buffer_encode(1 /*level*/, LZMA_CHECK_NONE, nullptr, job.data.data(), job.data.size(), m_packed.data(), &out_pos, m_packed.size());
+
+		// Keep the block stored when it does not compress
+		if (ret == LZMA_OK && out_pos < job.data.size()) {
+			block.packed_size = (uint32)out_pos;
+			Write(m_packed.data(), out_pos);
+		} else if (ret != LZMA_OK) {
+			fprintf(stderr, "GSDumpIndexed: Error %d\n", (int) ret);
+		}
+	}
+
+	if (block.packed_size == 0)
+		Write(job.data.data(), job.data.size());
+
+	m_offset += block.packed_size ? block.packed_size : block.size;
+
+	m_blocks.push_back(block);
+}
+
+void GSDumpIndexed::AppendRawData(const void *data, size_t size)
+{
+	size_t old_size = m_block.size();
+	m_block.resize(old_size + size);
+	memcpy(&m_block[old_size], data, size);
+}
+
+void GSDumpIndexed::AppendRawData(uint8 c)
+{
+	m_block.push_back(c);
+}
+
+void GSDumpIndexed::Transfer(int index, const uint8* mem, size_t size)
+{
+	if (size == 0)
+		return;
+
+	AppendRawData(0);
+	AppendRawData(static_cast<uint8>(index));
+	AppendRawData(&size, 4);
+	m_block.resize((m_block.size() + 15) & ~15);
+	AppendRawData(mem, size);
+}
+
+void GSDumpIndexed::EndFrame()
+{
+	m_frames.push_back(m_start + m_block.size());
+
+	// Blocks end on frame boundaries, a seek never unpacks more than the frames it needs
+	if (m_block.size() >= 4 * 1024 * 1024)
+		FlushBlock();
+}
+
+bool GSDumpIndexed::NeedKeyFrame() const
+{
+	return m_keyframe_interval > 0 && (int)m_frames.size() - 1 - m_keyframe_last >= m_keyframe_interval;
+}
+
+void GSDumpIndexed::KeyFrame(const GSFreezeData& fd, const GSPrivRegSet* regs)
+{
+	FlushBlock();
+
+	m_keyframe_last = (int)m_frames.size() - 1;
+
+	GSDumpIndexedKeyFrame kf = {m_start, (uint32)m_keyframe_last, 0};
+
+	m_keyframes.push_back(kf);
+
+	AppendRawData(4);
+	AppendRawData(&fd.size, 4);
+	AppendRawData(fd.data, fd.size);
+	AppendRawData(regs, sizeof(*regs));
+}
+
+bool GSDumpIndexed::Convert(const char* src, const std::string& dst)
+{
+	std::string f(src);
+	bool is_xz = f.size() >= 4 && f.compare(f.size() - 3, 3, ".xz") == 0;
+
+	std::unique_ptr<GSDumpFile> file;
+
+	try {
+		file = is_xz
+			? std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpLzma>(const_cast<char*>(src), nullptr)}
+			: std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpRaw>(const_cast<char*>(src), nullptr)};
+	} catch (...) {
+		return false;
+	}
+
+	uint32 crc;
+	GSFreezeData fd;
+	std::vector<uint8> state;
+	GSPrivRegSet* regs = (GSPrivRegSet*)_aligned_malloc(sizeof(GSPrivRegSet), 32);
+
+	file->Read(&crc, 4);
+	file->Read(&fd.size, 4);
+	state.resize(fd.size);
+	fd.data = state.data();
+	file->Read(fd.data, fd.size);
+	file->Read(regs, sizeof(*regs));
+
+	// The header state is the only keyframe a stream format dump can provide
+	GSDumpIndexed out(dst, crc, fd, regs, true);
+
+	std::vector<uint8> buff;
+	uint8 type;
+
+	while (file->Read(&type, 1)) {
+		uint8 param = 0;
+		uint32 size = 0;
+
+		switch (type) {
+		case 0:
+			file->Read(&param, 1);
+			file->Read(&size, 4);
+			buff.resize(size);
+			file->Read(buff.data(), size);
+			out.Transfer(param, buff.data(), size);
+			break;
+		case 1:
+			file->Read(&param, 1);
+			out.VSync(param, false, regs);
+			break;
+		case 2:
+			file->Read(&size, 4);
+			out.ReadFIFO(size);
+			break;
+		case 3:
+			file->Read(regs, sizeof(*regs));
+			break;
+		default:
+			fprintf(stderr, "GSDumpIndexed: Unknown packet type %d\n", type);
+			_aligned_free(regs);
+			return false;
+		}
+	}
+
+	_aligned_free(regs);
 
-	} while (m_strm.avail_out == 0);
+	return true;
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "GS.h"
+#include "GSThread_CXX11.h"
 #include "Renderers/SW/GSVertexSW.h"
 #include <lzma.h>
 
@@ -42,28 +43,76 @@ ReadFIFO2 data (id == 2)
 Regs data (id == 3)
 - [PMODE/0x2000]
 
+Indexed dump file format (.gsi), see GSDumpIndexed:
+- [header/16] [block] .. [block] [block table] [frame table] [keyframe table] [trailer/32]
+
+Blocks hold the records above cut at frame boundaries, either stored or xz compressed. Stored blocks
+start on a 16 bytes boundary of the file, and transfer data is padded to 16 bytes from the start of
+its block, so that a memory mapped file can be replayed without copying.
+
+Transfer data (id == 0)
+- [0/1] [path index/1] [size/4] [pad/?] [data/size]
+
+KeyFrame data (id == 4), always the first record of a block
+- [4/1] [state size/4] [state data/size] [PMODE/0x2000]
+
 */
 
+#define GSDUMP_INDEXED_MAGIC 0x49445347 // "GSDI"
+#define GSDUMP_INDEXED_VERSION 1
+
+struct GSDumpIndexedHeader {uint32 magic, version, crc, reserved;};
+struct GSDumpIndexedBlock {uint64 offset, start; uint32 size, packed_size;}; // offset: in the file, start: in the unpacked records, packed_size == 0: stored
+struct GSDumpIndexedKeyFrame {uint64 start; uint32 frame, reserved;};
+struct GSDumpIndexedTrailer {uint64 index; uint32 blocks, frames, keyframes, reserved, magic, version;};
+
 class GSDumpBase
 {
 	int m_frames;
 	int m_extra_frames;
 	FILE* m_gs;
 
+	uint64 m_dropped;
+
 protected:
+	// Staged data is compressed and written by a worker thread. The GS thread fills one buffer while the
+	// worker drains the others, it only waits when three are still pending, and the buffers are recycled.
+
+	struct Job
+	{
+		std::vector<uint8> data;
+		uint64 start;
+	};
+
+	std::unique_ptr<GSJobQueue<std::shared_ptr<Job>, 4>> m_worker;
+	std::shared_ptr<Job> m_jobs[4];
+	uint32 m_job;
+
+	int m_stalls;
+	std::chrono::steady_clock::duration m_stall_time;
+
+	void StartWorker();
+	void StopWorker();
+	void Submit(std::vector<uint8>& data, uint64 start = 0);
+	virtual void Process(Job& job) {}
+
 	void AddHeader(uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
 	void Write(const void *data, size_t size);
 
 	virtual void AppendRawData(const void *data, size_t size) = 0;
 	virtual void AppendRawData(uint8 c) = 0;
+	virtual void EndFrame() {}
 
 public:
 	GSDumpBase(const std::string& fn);
 	virtual ~GSDumpBase();
 
 	void ReadFIFO(uint32 size);
-	void Transfer(int index, const uint8* mem, size_t size);
+	virtual void Transfer(int index, const uint8* mem, size_t size);
 	bool VSync(int field, bool last, const GSPrivRegSet* regs);
+
+	virtual bool NeedKeyFrame() const {return false;}
+	virtual void KeyFrame(const GSFreezeData& fd, const GSPrivRegSet* regs) {}
 };
 
 class GSDump final : public GSDumpBase
@@ -81,9 +130,10 @@ class GSDumpXz final : public GSDumpBase
 	lzma_stream m_strm;
 
 	std::vector<uint8> m_in_buff;
+	std::vector<uint8> m_out_buff;
 
-	void Flush();
 	void Compress(lzma_action action, lzma_ret expected_status);
+	void Process(Job& job) final;
 	void AppendRawData(const void *data, size_t size);
 	void AppendRawData(uint8 c);
 
@@ -91,3 +141,38 @@ public:
 	GSDumpXz(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
 	virtual ~GSDumpXz();
 };
+
+class GSDumpIndexed final : public GSDumpBase
+{
+	bool m_compress;
+	int m_keyframe_interval;
+	int m_keyframe_last;
+
+	std::vector<uint8> m_block;
+	uint64 m_start; // unpacked offset of m_block
+
+	// owned by the worker while it runs
+	uint64 m_offset; // file offset of the next block
+	std::vector<uint8> m_packed;
+	std::vector<GSDumpIndexedBlock> m_blocks;
+
+	std::vector<uint64> m_frames;
+	std::vector<GSDumpIndexedKeyFrame> m_keyframes;
+
+	void Align();
+	void FlushBlock();
+	void Process(Job& job) final;
+	void AppendRawData(const void *data, size_t size) final;
+	void AppendRawData(uint8 c) final;
+	void EndFrame() final;
+
+public:
+	GSDumpIndexed(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs, bool compress);
+	virtual ~GSDumpIndexed();
+
+	void Transfer(int index, const uint8* mem, size_t size) final;
+	bool NeedKeyFrame() const final;
+	void KeyFrame(const GSFreezeData& fd, const GSPrivRegSet* regs) final;
+
+	static bool Convert(const char* src, const std::string& dst);
+};
@@ -0,0 +1,219 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSGIFPackedCodeGenerator.h"
+#include "GSState.h"
+
+using namespace Xbyak;
+
+// void (*)(GSState* s, const GIFPackedReg* r, uint32 loops)
+//
+// s and r live in callee-saved registers, the vertex kicks are the only calls made
+
+#if defined(_M_AMD64) || defined(_WIN64)
+#define _s rbx
+#define _r r12
+#define _loops r13
+#else
+#define _s ebx
+#define _r esi
+#define _loops edi
+#endif
+
+GSGIFPackedCodeGenerator::GSGIFPackedCodeGenerator(void* param, uint64 key, void* code, size_t maxsize)
+	: GSCodeGenerator(code, maxsize)
+	, m_state((GSState*)param)
+{
+	m_sel.key = key;
+
+	m_v = (size_t)((uint8*)&m_state->m_v - (uint8*)m_state);
+	m_q = (size_t)((uint8*)&m_state->m_q - (uint8*)m_state);
+
+	try {
+		Generate();
+	} catch (std::exception& e) {
+		fprintf(stderr, "ERR:GSGIFPackedCodeGenerator %s\n", e.what());
+	}
+}
+
+void GSGIFPackedCodeGenerator::Generate()
+{
+#if defined(_M_AMD64) || defined(_WIN64)
+	push(rbx);
+	push(r12);
+	push(r13);
+#ifdef _WIN64
+	sub(rsp, 32); // shadow space of the callees
+#endif
+
+	mov(_s, a0);
+	mov(_r, a1);
+	mov(_loops.cvt32(), a2.cvt32());
+#else
+	push(ebx);
+	push(esi);
+	push(edi);
+	sub(esp, 16); // outgoing arguments, also keeps esp aligned at the calls
+
+	mov(_s, ptr[esp + 16 + 12 + 4]);
+	mov(_r, ptr[esp + 16 + 12 + 8]);
+	mov(_loops, ptr[esp + 16 + 12 + 12]);
+#endif
+
+	align(16);
+
+L("loop");
+
+	for(uint32 i = 0; i < m_sel.nreg; i++)
+	{
+		Reg(m_sel.GetReg(i), i * sizeof(GIFPackedReg));
+	}
+
+	add(_r, m_sel.nreg * sizeof(GIFPackedReg));
+	dec(_loops.cvt32());
+	jnz("loop", T_NEAR);
+
+#if defined(_M_AMD64) || defined(_WIN64)
+#ifdef _WIN64
+	add(rsp, 32);
+#endif
+	pop(r13);
+	pop(r12);
+	pop(rbx);
+#else
+	add(esp, 16);
+	pop(edi);
+	pop(esi);
+	pop(ebx);
+#endif
+
+	ret();
+}
+
+void GSGIFPackedCodeGenerator::Reg(uint32 reg, int offset)
+{
+	switch(reg)
+	{
+	case GIF_REG_RGBA:
+
+		// see GSState::GIFPackedRegHandlerRGBA
+
+		movdqu(xmm0, ptr[_r + offset]);
+		pcmpeqd(xmm1, xmm1);
+		psrld(xmm1, 24);
+		pand(xmm0, xmm1);
+		packssdw(xmm0, xmm0);
+		packuswb(xmm0, xmm0);
+		movd(ptr[_s + m_v + offsetof(GSVertex, RGBAQ)], xmm0);
+
+		mov(eax, ptr[_s + m_q]);
+		mov(ptr[_s + m_v + offsetof(GSVertex, RGBAQ) + 4], eax);
+
+		break;
+
+	case GIF_REG_STQ:
+
+		// see GSState::GIFPackedRegHandlerSTQ, q = 0 => 1.0f, q = nan => FLT_MAX
+
+		movq(xmm0, ptr[_r + offset]);
+		movq(ptr[_s + m_v + offsetof(GSVertex, ST)], xmm0);
+
+		mov(eax, ptr[_r + offset + 8]);
+		mov(edx, 0x3f800000);
+		test(eax, eax);
+		cmovz(eax, edx);
+		mov(edx, eax);
+		and_(edx, 0x7fffffff);
+		cmp(edx, 0x7f800000);
+		mov(edx, 0x7f7fffff);
+		cmova(eax, edx);
+		mov(ptr[_s + m_q], eax);
+
+		break;
+
+	case GIF_REG_UV:
+
+		// see GSState::GIFPackedRegHandlerUV
+
+		mov(eax, ptr[_r + offset]);
+		and_(eax, 0x3fff);
+		mov(edx, ptr[_r + offset + 4]);
+		and_(edx, 0x3fff);
+		shl(edx, 16);
+		or_(eax, edx);
+		mov(ptr[_s + m_v + offsetof(GSVertex, UV)], eax);
+
+		// GIFPackedRegHandlerUV_Hack sets the flag, read the setting at run time so it isn't part of the key
+
+		movzx(edx, byte[_s + ((uint8*)&m_state->m_userhacks_wildhack - (uint8*)m_state)]);
+		or_(byte[_s + ((uint8*)&m_state->m_isPackedUV_HackFlag - (uint8*)m_state)], dl);
+
+		break;
+
+	case GIF_REG_FOG:
+
+		mov(eax, ptr[_r + offset + 12]);
+		shr(eax, 4);
+		and_(eax, 0xff);
+		mov(ptr[_s + m_v + offsetof(GSVertex, FOG)], eax);
+
+		break;
+
+	case GIF_REG_XYZF2:
+	case GIF_REG_XYZF3:
+	case GIF_REG_XYZ2:
+	case GIF_REG_XYZ3:
+
+		{
+			// the vertex kick itself stays in GSState::VertexKick (tail, index and auto flush handling)
+			//
+			// the handler is loaded from the table at run time, ResetHandlers picks it by auto flush
+
+			int i = reg == GIF_REG_XYZF2 ? 0 : reg == GIF_REG_XYZF3 ? 1 : reg == GIF_REG_XYZ2 ? 2 : 3;
+
+			size_t f = (size_t)((uint8*)&m_state->m_fpGIFPackedRegHandlerXYZJIT[m_sel.prim][i] - (uint8*)m_state);
+
+#if defined(_M_AMD64) || defined(_WIN64)
+			mov(a0, _s);
+			lea(a1, ptr[_r + offset]);
+			call(ptr[_s + f]);
+#else
+			lea(eax, ptr[_r + offset]);
+			mov(ptr[esp + 0], _s);
+			mov(ptr[esp + 4], eax);
+			call(ptr[_s + f]);
+#endif
+		}
+
+		break;
+
+	case GIF_REG_NOP:
+
+		break;
+
+	default:
+
+		ASSERT(0); // GIFPath::SetTag only selects TYPE_JIT for the registers above
+
+		break;
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "Renderers/Common/GSFunctionMap.h"
+
+class GSState;
+
+union GSGIFPackedSelector
+{
+	struct
+	{
+		uint64 regs:48; // 4 bits per register, as in GIFTag.REGS
+		uint64 nreg:4; // 1-12
+		uint64 prim:3; // PRIM->PRIM, selects the vertex kick
+	};
+
+	uint64 key;
+
+	operator uint64() const {return key;}
+
+	__forceinline uint32 GetReg(uint32 i) const {return (uint32)(regs >> (i << 2)) & 15;}
+};
+
+class GSGIFPackedCodeGenerator : public GSCodeGenerator
+{
+	void operator = (const GSGIFPackedCodeGenerator&);
+
+	GSState* m_state;
+	GSGIFPackedSelector m_sel;
+
+	size_t m_v;
+	size_t m_q;
+
+	void Generate();
+	void Reg(uint32 reg, int offset);
+
+public:
+	GSGIFPackedCodeGenerator(void* param, uint64 key, void* code, size_t maxsize);
+};
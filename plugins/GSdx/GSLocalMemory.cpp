@@ -775,27 +775,83 @@ void GSLocalMemory::WriteImageBlock(int l, int r, int y, int h, const uint8* src
 template<int psm, int bsx, int bsy>
 void GSLocalMemory::WriteImageLeftRight(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
 {
+	// [l, r) is inside one block, merge it into the columns instead of writing pixel by pixel
+
+	alignas(32) uint8 buff[64]; // merge buffer for one column
+
 	uint32 bp = BITBLTBUF.DBP;
 	uint32 bw = BITBLTBUF.DBW;
 
-	for(; h > 0; y++, h--, src += srcpitch)
+	const int csy = bsy / 4;
+	const int bx = l & ~(bsx - 1);
+
+	while(h > 0)
 	{
-		for(int x = l; x < r; x++)
+		int y2 = y & (csy - 1);
+		int h2 = std::min(h, csy - y2);
+
+		uint8* dst = NULL;
+
+		switch(psm)
 		{
-			switch(psm)
+		case PSM_PSMCT32: dst = BlockPtr32(l, y, bp, bw); break;
+		case PSM_PSMCT16: dst = BlockPtr16(l, y, bp, bw); break;
+		case PSM_PSMCT16S: dst = BlockPtr16S(l, y, bp, bw); break;
+		case PSM_PSMT8: dst = BlockPtr8(l, y, bp, bw); break;
+		case PSM_PSMT4: dst = BlockPtr4(l, y, bp, bw); break;
+		case PSM_PSMZ32: dst = BlockPtr32Z(l, y, bp, bw); break;
+		case PSM_PSMZ16: dst = BlockPtr16Z(l, y, bp, bw); break;
+		case PSM_PSMZ16S: dst = BlockPtr16SZ(l, y, bp, bw); break;
+		// TODO
+		default: __assume(0);
+		}
+
+		switch(psm)
+		{
+		case PSM_PSMCT32:
+		case PSM_PSMZ32:
+			GSBlock::ReadColumn32(y, dst, buff, 32);
+			for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 32 + (l - bx) * 4], &src[i * srcpitch + l * 4], (r - l) * 4);
+			GSBlock::WriteColumn32<32, 0xffffffff>(y, dst, buff, 32);
+			break;
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+			GSBlock::ReadColumn16(y, dst, buff, 32);
+			for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 32 + (l - bx) * 2], &src[i * srcpitch + l * 2], (r - l) * 2);
+			GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+			break;
+		case PSM_PSMT8:
+			GSBlock::ReadColumn8(y, dst, buff, 16);
+			for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16 + (l - bx)], &src[i * srcpitch + l], r - l);
+			GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+			break;
+		case PSM_PSMT4:
+			GSBlock::ReadColumn4(y, dst, buff, 16);
+			for(int i = 0, j = y2; i < h2; i++, j++)
 			{
-			case PSM_PSMCT32: WritePixel32(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMCT16: WritePixel16(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMCT16S: WritePixel16S(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMT8: WritePixel8(x, y, src[x], bp, bw); break;
-			case PSM_PSMT4: WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
-			case PSM_PSMZ32: WritePixel32Z(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMZ16: WritePixel16Z(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMZ16S: WritePixel16SZ(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			// TODO
-			default: __assume(0);
+				uint8* RESTRICT d = &buff[j * 16];
+				const uint8* RESTRICT s = &src[i * srcpitch];
+
+				int xl = l;
+				int xr = r;
+
+				if(xl & 1) {d[(xl - bx) >> 1] = (d[(xl - bx) >> 1] & 0x0f) | (s[xl >> 1] & 0xf0); xl++;}
+				if(xr & 1) {xr--; d[(xr - bx) >> 1] = (d[(xr - bx) >> 1] & 0xf0) | (s[xr >> 1] & 0x0f);}
+
+				memcpy(&d[(xl - bx) >> 1], &s[xl >> 1], (xr - xl) >> 1);
 			}
+			GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+			break;
+		// TODO
+		default:
+			__assume(0);
 		}
+
+		src += srcpitch * h2;
+		y += h2;
+		h -= h2;
 	}
 }
 
@@ -1086,15 +1142,11 @@ void GSLocalMemory::WriteImage24(int& tx, int& ty, const uint8* src, int len, GI
 
 	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
 
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
+	// whole block rows, the partial rows of a streamed transfer are left to WriteImageX
 
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
+	if(aligned && (tw & 7) == 0 && th >= 8)
 	{
-		th += ty;
+		th = ty + (th & ~7);
 
 		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
 		{
@@ -1104,8 +1156,13 @@ void GSLocalMemory::WriteImage24(int& tx, int& ty, const uint8* src, int len, GI
 			}
 		}
 
+		len -= srcpitch * (th - ty);
 		ty = th;
 	}
+
+	// TODO
+
+	WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 }
 
 void GSLocalMemory::WriteImage8H(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
@@ -1120,15 +1177,11 @@ void GSLocalMemory::WriteImage8H(int& tx, int& ty, const uint8* src, int len, GI
 
 	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
 
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
+	// whole block rows, the partial rows of a streamed transfer are left to WriteImageX
 
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
+	if(aligned && (tw & 7) == 0 && th >= 8)
 	{
-		th += ty;
+		th = ty + (th & ~7);
 
 		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
 		{
@@ -1138,8 +1191,13 @@ void GSLocalMemory::WriteImage8H(int& tx, int& ty, const uint8* src, int len, GI
 			}
 		}
 
+		len -= srcpitch * (th - ty);
 		ty = th;
 	}
+
+	// TODO
+
+	WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 }
 
 void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
@@ -1154,15 +1212,11 @@ void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const uint8* src, int len, G
 
 	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
 
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
+	// whole block rows, the partial rows of a streamed transfer are left to WriteImageX
 
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
+	if(aligned && (tw & 7) == 0 && th >= 8)
 	{
-		th += ty;
+		th = ty + (th & ~7);
 
 		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
 		{
@@ -1172,8 +1226,13 @@ void GSLocalMemory::WriteImage4HL(int& tx, int& ty, const uint8* src, int len, G
 			}
 		}
 
+		len -= srcpitch * (th - ty);
 		ty = th;
 	}
+
+	// TODO
+
+	WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 }
 
 void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
@@ -1188,15 +1247,11 @@ void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const uint8* src, int len, G
 
 	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
 
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
+	// whole block rows, the partial rows of a streamed transfer are left to WriteImageX
 
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
+	if(aligned && (tw & 7) == 0 && th >= 8)
 	{
-		th += ty;
+		th = ty + (th & ~7);
 
 		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
 		{
@@ -1206,8 +1261,13 @@ void GSLocalMemory::WriteImage4HH(int& tx, int& ty, const uint8* src, int len, G
 			}
 		}
 
+		len -= srcpitch * (th - ty);
 		ty = th;
 	}
+
+	// TODO
+
+	WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 }
 
 void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
@@ -1222,15 +1282,11 @@ void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const uint8* src, int len, G
 
 	bool aligned = IsTopLeftAligned(TRXPOS.DSAX, tx, ty, 8, 8);
 
-	if(!aligned || (tw & 7) || (th & 7) || (len % srcpitch))
-	{
-		// TODO
+	// whole block rows, the partial rows of a streamed transfer are left to WriteImageX
 
-		WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
-	}
-	else
+	if(aligned && (tw & 7) == 0 && th >= 8)
 	{
-		th += ty;
+		th = ty + (th & ~7);
 
 		for(int y = ty; y < th; y += 8, src += srcpitch * 8)
 		{
@@ -1240,8 +1296,13 @@ void GSLocalMemory::WriteImage24Z(int& tx, int& ty, const uint8* src, int len, G
 			}
 		}
 
+		len -= srcpitch * (th - ty);
 		ty = th;
 	}
+
+	// TODO
+
+	WriteImageX(tx, ty, src, len, BITBLTBUF, TRXPOS, TRXREG);
 }
 
 void GSLocalMemory::WriteImageX(int& tx, int& ty, const uint8* src, int len, GIFRegBITBLTBUF& BITBLTBUF, GIFRegTRXPOS& TRXPOS, GIFRegTRXREG& TRXREG)
@@ -1424,10 +1485,6 @@ void GSLocalMemory::ReadImageX(int& tx, int& ty, uint8* dst, int len, GIFRegBITB
 {
 	if(len <= 0) return;
 
-	uint8* RESTRICT pb = (uint8*)dst;
-	uint16* RESTRICT pw = (uint16*)dst;
-	uint32* RESTRICT pd = (uint32*)dst;
-
 	uint32 bp = BITBLTBUF.SBP;
 	uint32 bw = BITBLTBUF.SBW;
 	psm_t* RESTRICT psm = &m_psm[BITBLTBUF.SPSM];
@@ -1437,6 +1494,58 @@ void GSLocalMemory::ReadImageX(int& tx, int& ty, uint8* dst, int len, GIFRegBITB
 	int sx = (int)TRXPOS.SSAX;
 	int ex = sx + (int)TRXREG.RRW;
 
+	// whole block rows first, render target readbacks are usually block aligned
+
+	int bsx = psm->bs.x;
+	int bsy = psm->bs.y;
+
+	if(x == sx && (y & (bsy - 1)) == 0 && ((sx | ex) & (bsx - 1)) == 0 && ((size_t)dst & ((bsx * psm->trbpp >> 3) - 1)) == 0)
+	{
+		int dstpitch = (ex - sx) * psm->trbpp >> 3;
+		int h = (len / dstpitch) & ~(bsy - 1);
+
+		switch(BITBLTBUF.SPSM)
+		{
+		case PSM_PSMCT32:
+		case PSM_PSMZ32:
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+		case PSM_PSMT8:
+		case PSM_PSMT4:
+			break;
+		default:
+			h = 0;
+			break;
+		}
+
+		for(int ey = y + h; y < ey; y += bsy, dst += dstpitch * bsy, len -= dstpitch * bsy)
+		{
+			for(int bx = sx; bx < ex; bx += bsx)
+			{
+				uint8* RESTRICT d = &dst[(bx - sx) * psm->trbpp >> 3];
+
+				switch(BITBLTBUF.SPSM)
+				{
+				case PSM_PSMCT32: GSBlock::ReadBlock32(BlockPtr32(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMZ32: GSBlock::ReadBlock32(BlockPtr32Z(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMCT16: GSBlock::ReadBlock16(BlockPtr16(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMCT16S: GSBlock::ReadBlock16(BlockPtr16S(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMZ16: GSBlock::ReadBlock16(BlockPtr16Z(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMZ16S: GSBlock::ReadBlock16(BlockPtr16SZ(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMT8: GSBlock::ReadBlock8(BlockPtr8(bx, y, bp, bw), d, dstpitch); break;
+				case PSM_PSMT4: GSBlock::ReadBlock4(BlockPtr4(bx, y, bp, bw), d, dstpitch); break;
+				default: __assume(0);
+				}
+			}
+		}
+	}
+
+	uint8* RESTRICT pb = (uint8*)dst;
+	uint16* RESTRICT pw = (uint16*)dst;
+	uint32* RESTRICT pd = (uint32*)dst;
+
 	// printf("spsm=%d x=%d ex=%d y=%d len=%d\n", BITBLTBUF.SPSM, x, ex, y, len);
 
 	switch(BITBLTBUF.SPSM)
@@ -21,6 +21,13 @@
 #include "stdafx.h"
 #include "GSLzma.h"
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 GSDumpFile::GSDumpFile(char* filename, const char* repack_filename) {
 	m_fp = fopen(filename, "rb");
 	if (m_fp == nullptr) {
@@ -176,3 +183,239 @@ bool GSDumpRaw::Read(void* ptr, size_t size) {
 
 	return false;
 }
+
+/******************************************************************/
+
+GSDumpIndexedFile::GSDumpIndexedFile(const char* filename) {
+	m_map       = nullptr;
+	m_map_size  = 0;
+	m_unpacked  = nullptr;
+	m_unpacked_size = 0;
+
+#ifdef _WIN32
+	m_mapping = NULL;
+	m_file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_file == INVALID_HANDLE_VALUE) {
+		fprintf(stderr, "failed to open %s\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(m_file, &size))
+		m_map_size = (size_t)size.QuadPart;
+
+	m_mapping = CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping != NULL)
+		m_map = (const uint8*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	m_fd = open(filename, O_RDONLY);
+	if (m_fd < 0) {
+		fprintf(stderr, "failed to open %s\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	struct stat st;
+	if (fstat(m_fd, &st) == 0)
+		m_map_size = (size_t)st.st_size;
+
+	void* map = m_map_size ? mmap(nullptr, m_map_size, PROT_READ, MAP_PRIVATE, m_fd, 0) : MAP_FAILED;
+	if (map != MAP_FAILED) {
+		m_map = (const uint8*)map;
+		madvise(map, m_map_size, MADV_SEQUENTIAL);
+	}
+#endif
+
+	if (m_map == nullptr) {
+		fprintf(stderr, "failed to map %s\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	GSDumpIndexedHeader header;
+	GSDumpIndexedTrailer trailer;
+
+	if (m_map_size < sizeof(header) + sizeof(trailer)) {
+		fprintf(stderr, "%s is not an indexed dump\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	memcpy(&header, m_map, sizeof(header));
+	memcpy(&trailer, m_map + m_map_size - sizeof(trailer), sizeof(trailer));
+
+	size_t index_size = trailer.blocks * sizeof(GSDumpIndexedBlock) + trailer.frames * sizeof(uint64) + trailer.keyframes * sizeof(GSDumpIndexedKeyFrame);
+
+	if (header.magic != GSDUMP_INDEXED_MAGIC || trailer.magic != GSDUMP_INDEXED_MAGIC
+		|| header.version != GSDUMP_INDEXED_VERSION || trailer.version != GSDUMP_INDEXED_VERSION
+		|| trailer.index + index_size + sizeof(trailer) != m_map_size || trailer.keyframes == 0) {
+		fprintf(stderr, "%s is not an indexed dump or is truncated\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	m_crc = header.crc;
+
+	const uint8* index = m_map + trailer.index;
+
+	m_blocks.resize(trailer.blocks);
+	memcpy(m_blocks.data(), index, trailer.blocks * sizeof(GSDumpIndexedBlock));
+	index += trailer.blocks * sizeof(GSDumpIndexedBlock);
+
+	m_frames.resize(trailer.frames);
+	memcpy(m_frames.data(), index, trailer.frames * sizeof(uint64));
+	index += trailer.frames * sizeof(uint64);
+
+	m_keyframes.resize(trailer.keyframes);
+	memcpy(m_keyframes.data(), index, trailer.keyframes * sizeof(GSDumpIndexedKeyFrame));
+
+	for (const auto& b : m_blocks) {
+		if (b.offset + (b.packed_size ? b.packed_size : b.size) > trailer.index) {
+			fprintf(stderr, "%s has a corrupted block table\n", filename);
+			throw "BAD"; // Just exit the program
+		}
+	}
+
+	m_block = m_blocks.size();
+	m_data  = nullptr;
+	m_size  = 0;
+	m_pos   = 0;
+
+	Seek(0);
+}
+
+GSDumpIndexedFile::~GSDumpIndexedFile() {
+	if (m_unpacked)
+		_aligned_free(m_unpacked);
+
+#ifdef _WIN32
+	if (m_map)
+		UnmapViewOfFile(m_map);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	CloseHandle(m_file);
+#else
+	if (m_map)
+		munmap((void*)m_map, m_map_size);
+	close(m_fd);
+#endif
+}
+
+void GSDumpIndexedFile::Load(size_t block) {
+	const GSDumpIndexedBlock& b = m_blocks[block];
+
+	if (b.packed_size == 0) {
+		m_data = m_map + b.offset;
+	} else {
+		if (m_unpacked_size < b.size) {
+			if (m_unpacked)
+				_aligned_free(m_unpacked);
+			m_unpacked_size = (b.size + 31) & ~31u;
+			m_unpacked = (uint8*)_aligned_malloc(m_unpacked_size, 32);
+		}
+
+		uint64_t memlimit = UINT64_MAX;
+		size_t in_pos = 0;
+		size_t out_pos = 0;
+
+		lzma_ret ret = lzma_stream_buffer_decode(&memlimit, 0, nullptr, m_map + b.offset, &in_pos, b.packed_size, m_unpacked, &out_pos, b.size);
+
+		if (ret != LZMA_OK || out_pos != b.size) {
+			fprintf(stderr, "Decoder error: (error code %u)\n", ret);
+			throw "BAD"; // Just exit the program
+		}
+
+		m_data = m_unpacked;
+	}
+
+	m_block = block;
+	m_size  = b.size;
+	m_pos   = 0;
+}
+
+int GSDumpIndexedFile::Seek(int frame) {
+	auto kf = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), (uint32)std::max(frame, 0),
+		[](uint32 f, const GSDumpIndexedKeyFrame& k) {return f < k.frame;});
+
+	if (kf != m_keyframes.begin())
+		--kf;
+
+	auto b = std::upper_bound(m_blocks.begin(), m_blocks.end(), kf->start,
+		[](uint64 start, const GSDumpIndexedBlock& b) {return start < b.start;});
+
+	if (b == m_blocks.begin()) {
+		m_block = m_blocks.size();
+		m_size  = 0;
+		m_pos   = 0;
+		return 0;
+	}
+
+	--b;
+
+	size_t block = b - m_blocks.begin();
+
+	if (block != m_block || m_data == nullptr)
+		Load(block);
+
+	m_pos = (size_t)(kf->start - b->start);
+
+	return (int)kf->frame;
+}
+
+bool GSDumpIndexedFile::Read(GSDumpPacket& p) {
+	while (m_pos >= m_size) {
+		if (m_block + 1 >= m_blocks.size())
+			return false;
+
+		Load(m_block + 1);
+	}
+
+	static const size_t s_header[] = {5, 1, 4, 0, 4}; // bytes following the type, up to the data
+
+	const uint8* data = m_data;
+	size_t pos = m_pos;
+
+	p.type  = data[pos++];
+
+	if (p.type >= countof(s_header) || pos + s_header[p.type] > m_size) {
+		fprintf(stderr, "Unknown or truncated packet %d\n", p.type);
+		return false;
+	}
+
+	p.param = 0;
+	p.size  = 0;
+	p.data  = nullptr;
+
+	switch (p.type) {
+	case 0:
+		p.param = data[pos++];
+		memcpy(&p.size, data + pos, 4);
+		pos = (pos + 4 + 15) & ~(size_t)15;
+		p.data = data + pos;
+		pos += p.size;
+		break;
+	case 1:
+		p.param = data[pos++];
+		break;
+	case 2:
+		memcpy(&p.size, data + pos, 4);
+		pos += 4;
+		break;
+	case 3:
+		p.size = sizeof(GSPrivRegSet);
+		p.data = data + pos;
+		pos += p.size;
+		break;
+	case 4:
+		memcpy(&p.size, data + pos, 4);
+		pos += 4;
+		p.data = data + pos; // the privileged registers follow the state
+		pos += p.size + sizeof(GSPrivRegSet);
+		break;
+	}
+
+	if (pos > m_size) {
+		fprintf(stderr, "Truncated packet\n");
+		return false;
+	}
+
+	m_pos = pos;
+
+	return true;
+}
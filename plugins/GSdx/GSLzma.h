@@ -18,7 +18,10 @@
  *
  */
 
+#pragma once
+
 #include <lzma.h>
+#include "GSDump.h"
 
 class GSDumpFile {
 	FILE*		m_repack_fp;
@@ -75,3 +78,46 @@ class GSDumpRaw : public GSDumpFile {
 	bool IsEof() final;
 	bool Read(void* ptr, size_t size) final;
 };
+
+struct GSDumpPacket {
+	uint8 type, param;
+	uint32 size;
+	const uint8* data; // points into the file mapping or the unpacked block, valid until the next Read/Seek
+};
+
+class GSDumpIndexedFile {
+#ifdef _WIN32
+	HANDLE		m_file;
+	HANDLE		m_mapping;
+#else
+	int		m_fd;
+#endif
+	const uint8*	m_map;
+	size_t		m_map_size;
+
+	uint32		m_crc;
+	std::vector<GSDumpIndexedBlock>		m_blocks;
+	std::vector<uint64>			m_frames;
+	std::vector<GSDumpIndexedKeyFrame>	m_keyframes;
+
+	uint8*		m_unpacked;
+	size_t		m_unpacked_size;
+
+	size_t		m_block;
+	const uint8*	m_data;
+	size_t		m_size;
+	size_t		m_pos;
+
+	void Load(size_t block);
+
+	public:
+
+	GSDumpIndexedFile(const char* filename);
+	virtual ~GSDumpIndexedFile();
+
+	uint32 GetCRC() const {return m_crc;}
+	int GetFrameCount() const {return (int)m_frames.size();}
+
+	int Seek(int frame); // moves to the keyframe at or before frame, returns its frame number
+	bool Read(GSDumpPacket& p);
+};
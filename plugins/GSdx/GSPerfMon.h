@@ -36,6 +36,10 @@ public:
 	enum counter_t 
 	{
 		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint,
+		SyncPages, // waits on specific in-flight draws only (SyncPoint counts full rasterizer drains)
+		SyncReset, SyncVSync, SyncOutput, SyncDump, SyncSource, SyncTarget, SyncWrite, SyncRead, // reasons of either kind
+		TextureHit, TextureMiss, TextureEvict, TextureReuse, // SW texture cache, update bytes are counted by Unswizzle
+		TextureSwizzled, // SW draws sampling the swizzled texture in place
 		CounterLast,
 	};
 
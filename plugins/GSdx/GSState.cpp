@@ -29,7 +29,10 @@
 int GSState::s_n = 0;
 
 GSState::GSState()
-	: m_version(6)
+	: m_gif_map("GIFPacked", this)
+	, m_gif_key(0)
+	, m_gif_loop(NULL)
+	, m_version(6)
 	, m_mt(false)
 	, m_irq(NULL)
 	, m_path3hack(0)
@@ -295,6 +298,10 @@ void GSState::ResetHandlers()
 		m_fpGIFPackedRegHandlerXYZ[P][1] = &GSState::GIFPackedRegHandlerXYZF2<P, 1, auto_flush>; \
 		m_fpGIFPackedRegHandlerXYZ[P][2] = &GSState::GIFPackedRegHandlerXYZ2<P, 0, auto_flush>; \
 		m_fpGIFPackedRegHandlerXYZ[P][3] = &GSState::GIFPackedRegHandlerXYZ2<P, 1, auto_flush>; \
+		m_fpGIFPackedRegHandlerXYZJIT[P][0] = &GSState::GIFPackedRegHandlerXYZF2JIT<P, 0, auto_flush>; \
+		m_fpGIFPackedRegHandlerXYZJIT[P][1] = &GSState::GIFPackedRegHandlerXYZF2JIT<P, 1, auto_flush>; \
+		m_fpGIFPackedRegHandlerXYZJIT[P][2] = &GSState::GIFPackedRegHandlerXYZ2JIT<P, 0, auto_flush>; \
+		m_fpGIFPackedRegHandlerXYZJIT[P][3] = &GSState::GIFPackedRegHandlerXYZ2JIT<P, 1, auto_flush>; \
 		m_fpGIFRegHandlerXYZ[P][0] = &GSState::GIFRegHandlerXYZF2<P, 0, auto_flush>; \
 		m_fpGIFRegHandlerXYZ[P][1] = &GSState::GIFRegHandlerXYZF2<P, 1, auto_flush>; \
 		m_fpGIFRegHandlerXYZ[P][2] = &GSState::GIFRegHandlerXYZ2<P, 0, auto_flush>; \
@@ -675,6 +682,18 @@ void GSState::GIFPackedRegHandlerXYZ2(const GIFPackedReg* RESTRICT r)
 	VertexKick<prim, auto_flush>(adc ? 1 : r->XYZ2.Skip());
 }
 
+template<uint32 prim, uint32 adc, bool auto_flush>
+void GSState::GIFPackedRegHandlerXYZF2JIT(GSState* RESTRICT s, const GIFPackedReg* RESTRICT r)
+{
+	s->GIFPackedRegHandlerXYZF2<prim, adc, auto_flush>(r);
+}
+
+template<uint32 prim, uint32 adc, bool auto_flush>
+void GSState::GIFPackedRegHandlerXYZ2JIT(GSState* RESTRICT s, const GIFPackedReg* RESTRICT r)
+{
+	s->GIFPackedRegHandlerXYZ2<prim, adc, auto_flush>(r);
+}
+
 void GSState::GIFPackedRegHandlerFOG(const GIFPackedReg* RESTRICT r)
 {
 	m_v.FOG = r->FOG.F;
@@ -1574,6 +1593,11 @@ void GSState::FlushWrite()
 */
 }
 
+void GSState::UpdateVertexTrace()
+{
+	m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM));
+}
+
 void GSState::FlushPrim()
 {
 	if(m_index.tail > 0)
@@ -1650,7 +1674,7 @@ void GSState::FlushPrim()
 
 		if(GSLocalMemory::m_psm[m_context->FRAME.PSM].fmt < 3 && GSLocalMemory::m_psm[m_context->ZBUF.PSM].fmt < 3)
 		{
-			m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM));
+			UpdateVertexTrace();
 
 			m_context->SaveReg();
 
@@ -2167,6 +2191,28 @@ template<int index> void GSState::Transfer(const uint8* mem, uint32 size)
 
 					switch(path.type)
 					{
+					case GIFPath::TYPE_JIT:
+
+						if(!m_frameskip) // frame skipping replaces the vertex kicks with NOPs, let the handlers below take care of it
+						{
+							GSGIFPackedSelector sel;
+
+							sel.key = path.jit;
+							sel.prim = PRIM->PRIM;
+
+							if(sel.key != m_gif_key)
+							{
+								m_gif_key = sel.key;
+								m_gif_loop = m_gif_map[sel.key];
+							}
+
+							m_gif_loop(this, (GIFPackedReg*)mem, path.nloop);
+
+							mem += total * sizeof(GIFPackedReg);
+
+							break;
+						}
+
 					case GIFPath::TYPE_UNKNOWN:
 
 						{
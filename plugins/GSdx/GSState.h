@@ -34,6 +34,7 @@
 #include "GSCrc.h"
 #include "GSAlignedClass.h"
 #include "GSDump.h"
+#include "GSGIFPackedCodeGenerator.h"
 
 struct GSFrameInfo
 {
@@ -83,6 +84,23 @@ class GSState : public GSAlignedClass<32>
 	template<uint32 prim, bool auto_flush> void GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uint32 size);
 	void GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, uint32 size);
 
+	// PACKED loops of GIFPath::TYPE_JIT tags are compiled per register list and primitive, the generated code
+	// does the register moves inline and calls these for the vertex kicks
+
+	friend class GSGIFPackedCodeGenerator;
+
+	typedef void (*GIFPackedRegHandlerJIT)(GSState* RESTRICT s, const GIFPackedReg* RESTRICT r);
+	typedef void (*GIFPackedLoopPtr)(GSState* s, const GIFPackedReg* r, uint32 loops);
+
+	GIFPackedRegHandlerJIT m_fpGIFPackedRegHandlerXYZJIT[8][4];
+
+	template<uint32 prim, uint32 adc, bool auto_flush> static void GIFPackedRegHandlerXYZF2JIT(GSState* RESTRICT s, const GIFPackedReg* RESTRICT r);
+	template<uint32 prim, uint32 adc, bool auto_flush> static void GIFPackedRegHandlerXYZ2JIT(GSState* RESTRICT s, const GIFPackedReg* RESTRICT r);
+
+	GSCodeGeneratorFunctionMap<GSGIFPackedCodeGenerator, uint64, GIFPackedLoopPtr> m_gif_map;
+	uint64 m_gif_key;
+	GIFPackedLoopPtr m_gif_loop;
+
 	template<int i> void ApplyTEX0(GIFRegTEX0& TEX0);
 	void ApplyPRIM(uint32 prim);
 
@@ -258,6 +276,7 @@ public:
 	void Flush();
 	void FlushPrim();
 	void FlushWrite();
+	virtual void UpdateVertexTrace();
 	virtual void Draw() = 0;
 	virtual void PurgePool() = 0;
 	virtual void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r) {}
@@ -87,14 +87,21 @@ public:
 		return m_queue.empty();
 	}
 
-	void Push(const T& item) {
-		while(!m_queue.push(item))
-			std::this_thread::yield();
+	bool TryPush(const T& item) {
+		if (!m_queue.push(item))
+			return false;
 
 		{
 			std::lock_guard<std::mutex> l(m_lock);
 		}
 		m_notempty.notify_one();
+
+		return true;
+	}
+
+	void Push(const T& item) {
+		while(!TryPush(item))
+			std::this_thread::yield();
 	}
 
 	void Wait()
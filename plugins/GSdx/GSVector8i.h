@@ -1229,6 +1229,19 @@ public:
 		b = c.bd(d);
 	}
 
+	__forceinline static void sw4(GSVector8i& a, GSVector8i& b)
+	{
+		const __m256i epi32_0f0f0f0f = _mm256_set1_epi32(0x0f0f0f0f);
+
+		GSVector8i mask(epi32_0f0f0f0f);
+
+		GSVector8i c = (b << 4).blend(a, mask);
+		GSVector8i d = b.blend(a >> 4, mask);
+
+		a = c.upl8(d);
+		b = c.uph8(d);
+	}
+
 	__forceinline static void sw4(GSVector8i& a, GSVector8i& b, GSVector8i& c, GSVector8i& d)
 	{
 		const __m256i epi32_0f0f0f0f = _mm256_set1_epi32(0x0f0f0f0f);
@@ -360,12 +360,13 @@ void GSRenderer::VSync(int field)
 			std::string s2 = m_regs->SMODE2.INT ? (std::string("Interlaced ") + (m_regs->SMODE2.FFMD ? "(frame)" : "(field)")) : "Progressive";
 
 			s = format(
-				"%lld | %d x %d | %.2f fps (%d%%) | %s - %s | %s | %d S/%d P/%d D | %d%% CPU | %.2f | %.2f",
+				"%lld | %d x %d | %.2f fps (%d%%) | %s - %s | %s | %d S/%d SP/%d P/%d D | %d%% CPU | %.2f | %.2f",
 				m_perfmon.GetFrame(), GetInternalResolution().x, GetInternalResolution().y, fps, (int)(100.0 * fps / GetTvRefreshRate()),
 				s2.c_str(),
 				theApp.m_gs_interlace[m_interlace].name.c_str(),
 				theApp.m_gs_aspectratio[m_aspectratio].name.c_str(),
 				(int)m_perfmon.Get(GSPerfMon::SyncPoint),
+				(int)m_perfmon.Get(GSPerfMon::SyncPages),
 				(int)m_perfmon.Get(GSPerfMon::Prim),
 				(int)m_perfmon.Get(GSPerfMon::Draw),
 				m_perfmon.CPU(),
@@ -452,7 +453,9 @@ void GSRenderer::VSync(int field)
 			fd.data = new uint8[fd.size];
 			Freeze(&fd, false);
 
-			if (m_control_key)
+			if (theApp.GetConfigB("dump_indexed"))
+				m_dump = std::unique_ptr<GSDumpBase>(new GSDumpIndexed(m_snapshot, m_crc, fd, m_regs, !m_control_key));
+			else if (m_control_key)
 				m_dump = std::unique_ptr<GSDumpBase>(new GSDump(m_snapshot, m_crc, fd, m_regs));
 			else
 				m_dump = std::unique_ptr<GSDumpBase>(new GSDumpXz(m_snapshot, m_crc, fd, m_regs));
@@ -470,7 +473,20 @@ void GSRenderer::VSync(int field)
 	else if(m_dump)
 	{
 		if(m_dump->VSync(field, !m_control_key, m_regs))
+		{
 			m_dump.reset();
+		}
+		else if(m_dump->NeedKeyFrame())
+		{
+			GSFreezeData fd = {0, nullptr};
+			Freeze(&fd, true);
+			fd.data = new uint8[fd.size];
+			Freeze(&fd, false);
+
+			m_dump->KeyFrame(fd, m_regs);
+
+			delete [] fd.data;
+		}
 	}
 
 	// capture
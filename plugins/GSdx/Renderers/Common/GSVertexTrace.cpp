@@ -79,6 +79,24 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count,
 		(this->*m_fmm[m_accurate_stq][color][fst][tme][iip][primclass])(vertex, index, i_count);
 	}
 
+	UpdateFlags(vertex, v_count);
+}
+
+void GSVertexTrace::Update(const void* vertex, int v_count, GS_PRIM_CLASS primclass, const GSVector4& pmin, const GSVector4& pmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4i& cmin, const GSVector4i& cmax)
+{
+	m_primclass = primclass;
+
+	uint32 tme = m_state->PRIM->TME;
+	uint32 fst = m_state->PRIM->FST;
+	uint32 color = !(m_state->PRIM->TME && m_state->m_context->TEX0.TFX == TFX_DECAL && m_state->m_context->TEX0.TCC);
+
+	SetMinMax(pmin, pmax, tmin, tmax, cmin, cmax, tme, fst, color);
+
+	UpdateFlags(vertex, v_count);
+}
+
+void GSVertexTrace::UpdateFlags(const void* vertex, int v_count)
+{
 	m_eq.value = (m_min.c == m_max.c).mask() | ((m_min.p == m_max.p).mask() << 16) | ((m_min.t == m_max.t).mask() << 20);
 
 	m_alpha.valid = false;
@@ -157,8 +175,6 @@ void GSVertexTrace::Update(const void* vertex, const uint32* index, int v_count,
 template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
 void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int count)
 {
-	const GSDrawingContext* context = m_state->m_context;
-
 	int n = 1;
 
 	switch(primclass)
@@ -528,11 +544,18 @@ void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int coun
 
 	#endif
 
+	SetMinMax(GSVector4(pmin), GSVector4(pmax), tmin, tmax, cmin, cmax, tme, fst, color);
+}
+
+void GSVertexTrace::SetMinMax(const GSVector4& pmin, const GSVector4& pmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4i& cmin, const GSVector4i& cmax, uint32 tme, uint32 fst, uint32 color)
+{
+	const GSDrawingContext* context = m_state->m_context;
+
 	GSVector4 o(context->XYOFFSET);
 	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
 
-	m_min.p = (GSVector4(pmin) - o) * s;
-	m_max.p = (GSVector4(pmax) - o) * s;
+	m_min.p = (pmin - o) * s;
+	m_max.p = (pmax - o) * s;
 
 	if(tme)
 	{
@@ -50,6 +50,9 @@ protected:
 	template<GS_PRIM_CLASS primclass, uint32 iip, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
 	void FindMinMax(const void* vertex, const uint32* index, int count);
 
+	void SetMinMax(const GSVector4& pmin, const GSVector4& pmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4i& cmin, const GSVector4i& cmax, uint32 tme, uint32 fst, uint32 color);
+	void UpdateFlags(const void* vertex, int v_count);
+
 public:
 	GS_PRIM_CLASS m_primclass;
 
@@ -79,6 +82,9 @@ public:
 
 	void Update(const void* vertex, const uint32* index, int v_count, int i_count, GS_PRIM_CLASS primclass);
 
+	// min/max already found by the caller, in the same unscaled form as FindMinMax (xyzf with z halved, stq/q or uv, packed rgba)
+	void Update(const void* vertex, int v_count, GS_PRIM_CLASS primclass, const GSVector4& pmin, const GSVector4& pmax, const GSVector4& tmin, const GSVector4& tmax, const GSVector4i& cmin, const GSVector4i& cmax);
+
 	bool IsLinear() const {return m_filter.opt_linear;}
 	bool IsRealLinear() const {return m_filter.linear;}
 
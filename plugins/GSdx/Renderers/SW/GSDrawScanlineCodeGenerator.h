@@ -33,6 +33,11 @@ using namespace Xbyak;
 #define RegLong Reg32
 #endif
 
+// GSScanlineSelector::tsw, only the x64 AVX generator reads textures from the swizzled memory
+#if defined(ENABLE_JIT_RASTERIZER) && _M_SSE < 0x501 && (defined(_M_AMD64) || defined(_WIN64))
+#define ENABLE_SWIZZLED_TEXTURE
+#endif
+
 class GSDrawScanlineCodeGenerator : public GSCodeGenerator
 {
 	void operator = (const GSDrawScanlineCodeGenerator&);
@@ -126,6 +131,11 @@ class GSDrawScanlineCodeGenerator : public GSCodeGenerator
 	void WritePixel_AVX(const Xmm& src, const RegLong& addr, uint8 i, int psm);
 	void ReadTexel_AVX(int pixels, int mip_offset = 0);
 	void ReadTexel_AVX(const Xmm& dst, const Xmm& addr, uint8 i);
+	#if defined(_M_AMD64) || defined(_WIN64)
+	void SwizzledAddress_AVX(int pixels);
+	void ReadTable_AVX(const Xmm& a, const Reg64& base);
+	void ReadTexel4_AVX(const Xmm& dst, const Xmm& addr, const Xmm& temp);
+	#endif
 
 	#endif
 
@@ -494,7 +494,7 @@ void GSDrawScanlineCodeGenerator::Init_AVX()
 
 	mov(_m_local__gd__vm, _rip_global(vm));
 	if(m_sel.fb && m_sel.tfx != TFX_NONE)
-		mov(_m_local__gd__tex, _rip_global(tex));
+		mov(_m_local__gd__tex, m_sel.tsw ? _rip_global(tbr) : _rip_global(tex));
 }
 
 void GSDrawScanlineCodeGenerator::Step_AVX()
@@ -824,7 +824,9 @@ void GSDrawScanlineCodeGenerator::SampleTexture_AVX()
 
 	vpunpcklwd(xmm2, xmm4, xmm0);
 	vpunpckhwd(xmm3, xmm4, xmm0);
-	vpslld(xmm3, static_cast<uint8>(m_sel.tw + 3));
+
+	if(!m_sel.tsw)
+		vpslld(xmm3, static_cast<uint8>(m_sel.tw + 3));
 
 	// xmm0 = 0
 	// xmm2 = x0
@@ -840,7 +842,9 @@ void GSDrawScanlineCodeGenerator::SampleTexture_AVX()
 
 		vpunpcklwd(xmm4, xmm5, xmm0);
 		vpunpckhwd(xmm5, xmm5, xmm0);
-		vpslld(xmm5, static_cast<uint8>(m_sel.tw + 3));
+
+		if(!m_sel.tsw)
+			vpslld(xmm5, static_cast<uint8>(m_sel.tw + 3));
 
 		// xmm2 = x0
 		// xmm3 = y0
@@ -849,15 +853,22 @@ void GSDrawScanlineCodeGenerator::SampleTexture_AVX()
 		// xmm6 = uf
 		// xmm7 = vf
 
-		// GSVector4i addr00 = y0 + x0;
-		// GSVector4i addr01 = y0 + x1;
-		// GSVector4i addr10 = y1 + x0;
-		// GSVector4i addr11 = y1 + x1;
-
-		vpaddd(xmm0, xmm3, xmm2);
-		vpaddd(xmm1, xmm3, xmm4);
-		vpaddd(xmm2, xmm5, xmm2);
-		vpaddd(xmm3, xmm5, xmm4);
+		if(m_sel.tsw)
+		{
+			SwizzledAddress_AVX(4);
+		}
+		else
+		{
+			// GSVector4i addr00 = y0 + x0;
+			// GSVector4i addr01 = y0 + x1;
+			// GSVector4i addr10 = y1 + x0;
+			// GSVector4i addr11 = y1 + x1;
+
+			vpaddd(xmm0, xmm3, xmm2);
+			vpaddd(xmm1, xmm3, xmm4);
+			vpaddd(xmm2, xmm5, xmm2);
+			vpaddd(xmm3, xmm5, xmm4);
+		}
 
 		// xmm0 = addr00
 		// xmm1 = addr01
@@ -955,9 +966,16 @@ void GSDrawScanlineCodeGenerator::SampleTexture_AVX()
 	}
 	else
 	{
-		// GSVector4i addr00 = y0 + x0;
+		if(m_sel.tsw)
+		{
+			SwizzledAddress_AVX(1);
+		}
+		else
+		{
+			// GSVector4i addr00 = y0 + x0;
 
-		vpaddd(xmm0, xmm3, xmm2);
+			vpaddd(xmm0, xmm3, xmm2);
+		}
 
 		// c00 = addr00.gather32_32((const uint32/uint8*)tex[, clut]);
 
@@ -2016,9 +2034,17 @@ void GSDrawScanlineCodeGenerator::ReadTexel_AVX(int pixels, int mip_offset)
 {
 	const int in[] = {0, 1, 2, 3};
 	const int out[] = {4, 5, 0, 1};
+	const int temp[] = {5, 0, 1, 2};
 
 	for(int i = 0; i < pixels; i++)
 	{
+		if(m_sel.tsw == 3)
+		{
+			ReadTexel4_AVX(Xmm(out[i]), Xmm(in[i]), Xmm(temp[i]));
+
+			continue;
+		}
+
 		for(uint8 j = 0; j < 4; j++)
 		{
 			ReadTexel_AVX(Xmm(out[i]), Xmm(in[i]), j);
@@ -2028,19 +2054,182 @@ void GSDrawScanlineCodeGenerator::ReadTexel_AVX(int pixels, int mip_offset)
 
 void GSDrawScanlineCodeGenerator::ReadTexel_AVX(const Xmm& dst, const Xmm& addr, uint8 i)
 {
-	const Address& src = m_sel.tlu ? ptr[_m_local__gd__clut + rax * 4] : ptr[_m_local__gd__tex + rax * 4];
+	const Reg64& tex = m_sel.tsw ? _m_local__gd__vm : _m_local__gd__tex;
+
+	const Address& src = m_sel.tlu ? ptr[_m_local__gd__clut + rax * 4] : ptr[tex + rax * 4];
 
 	// Extract address offset
 	if(i == 0) vmovd(eax, addr);
 	else vpextrd(eax, addr, i);
 
 	// If clut, load the value as a byte index
-	if(m_sel.tlu) movzx(eax, byte[_m_local__gd__tex + rax]);
+	if(m_sel.tlu) movzx(eax, byte[tex + rax]);
 
 	if(i == 0) vmovd(dst, src);
 	else vpinsrd(dst, src, i);
 }
 
+void GSDrawScanlineCodeGenerator::ReadTexel4_AVX(const Xmm& dst, const Xmm& addr, const Xmm& temp)
+{
+	// PSMT4 in vm, addr is in nibbles, addr and temp are destroyed
+
+	for(uint8 i = 0; i < 4; i++)
+	{
+		if(i == 0) vmovd(eax, addr);
+		else vpextrd(eax, addr, i);
+
+		shr(eax, 1);
+		movzx(eax, byte[_m_local__gd__vm + rax]);
+
+		if(i == 0) vmovd(dst, eax);
+		else vpinsrd(dst, eax, i);
+	}
+
+	// dst = addr & 1 ? dst >> 4 : dst & 15;
+
+	vpsrld(temp, dst, 4);
+	vpslld(dst, 28);
+	vpsrld(dst, 28);
+	vpslld(addr, 31);
+	vpsrad(addr, 31);
+	vpblendvb(dst, dst, temp, addr);
+
+	for(uint8 i = 0; i < 4; i++)
+	{
+		vpextrd(eax, dst, i);
+		vpinsrd(dst, ptr[_m_local__gd__clut + rax * 4], i);
+	}
+}
+
+void GSDrawScanlineCodeGenerator::ReadTable_AVX(const Xmm& a, const Reg64& base)
+{
+	// a[i] = base[a[i]]
+
+	for(uint8 i = 0; i < 4; i++)
+	{
+		vpextrd(eax, a, i);
+		vpinsrd(a, ptr[base + rax * 4], i);
+	}
+}
+
+void GSDrawScanlineCodeGenerator::SwizzledAddress_AVX(int pixels)
+{
+	// in
+	// xmm2 = x0
+	// xmm3 = y0
+	// xmm4 = x1 (pixels == 4)
+	// xmm5 = y1 (pixels == 4)
+	// _m_local__gd__tex = m_local.gd->tbr
+
+	// out
+	// xmm0 = addr00
+	// xmm1 = addr01 (pixels == 4)
+	// xmm2 = addr10 (pixels == 4)
+	// xmm3 = addr11 (pixels == 4)
+
+	// addr = tbr[y] + col[x], as GSOffset::pixel, the 8 and 4 bit formats alternate two column
+	// tables every 4 rows, rowOffset8/4[1] directly follows [0] so that is col[x + (((y + 2) & 4) << 10)]
+
+	static const int psm[] = {PSM_PSMCT32, PSM_PSMCT32, PSM_PSMT8, PSM_PSMT4};
+	static const int bits[] = {20, 20, 22, 23}; // size of vm in pixels
+
+	mov(rbx, (size_t)GSLocalMemory::m_psm[psm[m_sel.tsw]].rowOffset[0]);
+
+	if(m_sel.tsw == 1)
+	{
+		ReadTable_AVX(xmm2, rbx);
+		ReadTable_AVX(xmm3, _m_local__gd__tex);
+
+		vpaddd(xmm0, xmm3, xmm2);
+
+		if(pixels == 4)
+		{
+			ReadTable_AVX(xmm4, rbx);
+			ReadTable_AVX(xmm5, _m_local__gd__tex);
+
+			vpaddd(xmm1, xmm3, xmm4);
+			vpaddd(xmm2, xmm5, xmm2);
+			vpaddd(xmm3, xmm5, xmm4);
+		}
+	}
+	else
+	{
+		// GSVector4i two = GSVector4i::x00000001() + GSVector4i::x00000001();
+
+		vpcmpeqd(xmm1, xmm1);
+		vpsrld(xmm1, 31);
+		vpaddd(xmm1, xmm1);
+
+		// GSVector4i c0 = ((y0 + 2) & 4) << 10;
+
+		vpaddd(xmm0, xmm3, xmm1);
+		vpslld(xmm0, 29);
+		vpsrld(xmm0, 31);
+		vpslld(xmm0, 12);
+
+		ReadTable_AVX(xmm3, _m_local__gd__tex);
+
+		if(pixels == 4)
+		{
+			// GSVector4i c1 = ((y1 + 2) & 4) << 10;
+
+			vpaddd(xmm1, xmm5, xmm1);
+			vpslld(xmm1, 29);
+			vpsrld(xmm1, 31);
+			vpslld(xmm1, 12);
+
+			ReadTable_AVX(xmm5, _m_local__gd__tex);
+
+			// no mipmapping here, its temporaries are free
+
+			vmovdqa(_rip_local(temp.uv[0]), xmm2);
+			vmovdqa(_rip_local(temp.uv[1]), xmm4);
+
+			vpaddd(xmm2, xmm1);
+			vpaddd(xmm4, xmm1);
+			vpaddd(xmm1, xmm0, _rip_local(temp.uv[0]));
+			vpaddd(xmm0, _rip_local(temp.uv[1]));
+
+			ReadTable_AVX(xmm0, rbx);
+			ReadTable_AVX(xmm1, rbx);
+			ReadTable_AVX(xmm2, rbx);
+			ReadTable_AVX(xmm4, rbx);
+
+			// xmm0 = col[x1 + c0]
+			// xmm1 = col[x0 + c0]
+			// xmm2 = col[x0 + c1]
+			// xmm3 = tbr[y0]
+			// xmm4 = col[x1 + c1]
+			// xmm5 = tbr[y1]
+
+			vpaddd(xmm2, xmm5);
+			vpaddd(xmm4, xmm5);
+			vpaddd(xmm5, xmm3, xmm1);
+			vpaddd(xmm1, xmm3, xmm0);
+			vmovdqa(xmm0, xmm5);
+			vmovdqa(xmm3, xmm4);
+		}
+		else
+		{
+			vpaddd(xmm2, xmm0);
+
+			ReadTable_AVX(xmm2, rbx);
+
+			vpaddd(xmm0, xmm3, xmm2);
+		}
+	}
+
+	// the address wraps around at the end of vm
+
+	vpcmpeqd(xmm4, xmm4);
+	vpsrld(xmm4, 32 - bits[m_sel.tsw]);
+
+	for(int i = 0; i < pixels; i++)
+	{
+		vpand(Xmm(i), xmm4);
+	}
+}
+
 // Gather example (AVX2). Not faster on Haswell but potentially better on recent CPU
 // Worst case reduce Icache.
 //
@@ -135,6 +135,8 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
 
+	data->PrepareDraw();
+
 	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
 
 	m_pixels.actual = 0;
@@ -1170,6 +1172,13 @@ void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 	int top = r.top >> m_thread_height;
 	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
 
+	if(top >= bottom)
+	{
+		data->PrepareDraw(); // nobody will draw it, but the work it carries still has to be done
+
+		return;
+	}
+
 	while(top < bottom)
 	{
 		m_workers[m_scanline[top++]]->Push(data);
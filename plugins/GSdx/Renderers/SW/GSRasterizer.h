@@ -66,6 +66,8 @@ public:
 	{
 		if(buff != NULL) _aligned_free(buff);
 	}
+
+	virtual void PrepareDraw() {} // called by each thread drawing this, before it starts
 };
 
 class IDrawScanline : public GSAlignedClass<32>
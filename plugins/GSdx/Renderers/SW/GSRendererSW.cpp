@@ -41,7 +41,8 @@ void GSRendererSW::InitVectors()
 }
 
 GSRendererSW::GSRendererSW(int threads)
-	: m_fzb(NULL)
+	: m_vertex_buff(NULL)
+	, m_fzb(NULL)
 {
 	m_nativeres = true; // ignore ini, sw is always native
 
@@ -53,6 +54,10 @@ GSRendererSW::GSRendererSW(int threads)
 
 	m_output = (uint8*)_aligned_malloc(1024 * 1024 * sizeof(uint32), 32);
 
+#ifdef ENABLE_SWIZZLED_TEXTURE
+	m_swizzled_texture = Xbyak::util::Cpu().has(Xbyak::util::Cpu::tAVX); // the SSE generator has no x64 version
+#endif
+
 	for (uint32 i = 0; i < countof(m_fzb_pages); i++) {
 		m_fzb_pages[i] = 0;
 	}
@@ -60,6 +65,10 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(m_sync_fzb, 0, sizeof(m_sync_fzb));
+	memset(m_sync_tex, 0, sizeof(m_sync_tex));
+	m_sync_count = 0;
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -75,6 +84,27 @@ GSRendererSW::GSRendererSW(int threads)
 	InitCVB(GS_TRIANGLE_CLASS);
 	InitCVB(GS_SPRITE_CLASS);
 
+	#if _M_SSE >= 0x401
+
+	#define InitCTVB3(P, TME, FST) \
+		m_ctvb[P][TME][FST][0][0] = &GSRendererSW::ConvertTraceVertexBuffer<P, TME, FST, 0, 0>; \
+		m_ctvb[P][TME][FST][0][1] = &GSRendererSW::ConvertTraceVertexBuffer<P, TME, FST, 0, 1>; \
+		m_ctvb[P][TME][FST][1][0] = &GSRendererSW::ConvertTraceVertexBuffer<P, TME, FST, 1, 0>; \
+		m_ctvb[P][TME][FST][1][1] = &GSRendererSW::ConvertTraceVertexBuffer<P, TME, FST, 1, 1>;
+
+	#define InitCTVB(P) \
+		InitCTVB3(P, 0, 0) \
+		InitCTVB3(P, 0, 1) \
+		InitCTVB3(P, 1, 0) \
+		InitCTVB3(P, 1, 1)
+
+	InitCTVB(GS_POINT_CLASS);
+	InitCTVB(GS_LINE_CLASS);
+	InitCTVB(GS_TRIANGLE_CLASS);
+	InitCTVB(GS_SPRITE_CLASS);
+
+	#endif
+
 	m_dump_root = root_sw;
 
 	// Reset handler with the auto flush hack enabled on the SW renderer.
@@ -97,6 +127,8 @@ GSRendererSW::~GSRendererSW()
 	delete m_rl;
 
 	_aligned_free(m_output);
+
+	if(m_vertex_buff != NULL) _aligned_free(m_vertex_buff);
 }
 
 void GSRendererSW::Reset()
@@ -384,6 +416,304 @@ void GSRendererSW::ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex*
 	#endif
 }
 
+void GSRendererSW::DivideVertexQ(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count)
+{
+	// the q_div part of ConvertVertexBuffer, for vertices that UpdateVertexTrace converted before q_div was known
+
+	GSVector4 tsize = GSVector4(0x10000 << m_context->TEX0.TW, 0x10000 << m_context->TEX0.TH, 1, 0);
+
+	if(m_vt.m_primclass == GS_SPRITE_CLASS)
+	{
+		for(size_t i = 0; i < count; i += 2, src += 2, dst += 2)
+		{
+			GSVector4 stcq0 = GSVector4::load<true>(&src[0].m[0]);
+			GSVector4 stcq1 = GSVector4::load<true>(&src[1].m[0]);
+
+			GSVector4 q = stcq1.wwww();
+
+			dst[0].t = ((stcq0 / q) * tsize).insert32<3, 3>(dst[0].t);
+			dst[1].t = ((stcq1 / q) * tsize).insert32<3, 3>(dst[1].t);
+		}
+	}
+	else
+	{
+		for(size_t i = 0; i < count; i++, src++, dst++)
+		{
+			GSVector4 stcq = GSVector4::load<true>(&src->m[0]);
+
+			dst->t = (stcq / stcq.wwww()) * tsize;
+		}
+	}
+}
+
+#if _M_SSE >= 0x401
+
+template<uint32 primclass, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
+void GSRendererSW::ConvertTraceVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count, VertexBounds& b)
+{
+	// ConvertVertexBuffer<primclass, tme, fst, 0> and GSVertexTrace::FindMinMax in one pass over the vertex buffer,
+	// every vertex below m_vertex.next is referenced by the index buffer, except for fans (see UpdateVertexTrace)
+
+	GSVector4i off = (GSVector4i)m_context->XYOFFSET;
+	GSVector4 tsize = GSVector4(0x10000 << m_context->TEX0.TW, 0x10000 << m_context->TEX0.TH, 1, 0);
+	GSVector4i z_max = GSVector4i::xffffffff().srl32(GSLocalMemory::m_psm[m_context->ZBUF.PSM].fmt * 8);
+
+	GSVector4i pmin = GSVector4i::xffffffff();
+	GSVector4i pmax = GSVector4i::zero();
+	GSVector4 tmin = GSVector4(FLT_MAX);
+	GSVector4 tmax = GSVector4(-FLT_MAX);
+	GSVector4i cmin = GSVector4i::xffffffff();
+	GSVector4i cmax = GSVector4i::zero();
+
+	size_t i = 0;
+
+	#if _M_SSE >= 0x501
+
+	{
+		GSVector8i off2(off, off);
+		GSVector8 tsize2(tsize, tsize);
+		GSVector8i z_max2(z_max, z_max);
+
+		GSVector8i pmin2 = GSVector8i::xffffffff();
+		GSVector8i pmax2 = GSVector8i::zero();
+		GSVector8 tmin2 = GSVector8(FLT_MAX);
+		GSVector8 tmax2 = GSVector8(-FLT_MAX);
+		GSVector8i cmin2 = GSVector8i::xffffffff();
+		GSVector8i cmax2 = GSVector8i::zero();
+
+		// two vertices per iteration, one in each 128-bit lane, a sprite is exactly one iteration
+
+		for(; i + 2 <= count; i += 2, src += 2, dst += 2)
+		{
+			GSVector8i v0 = GSVector8i::load<true>(src[0].m);
+			GSVector8i v1 = GSVector8i::load<true>(src[1].m);
+
+			GSVector8 stcq = GSVector8::cast(v0.ac(v1));
+			GSVector8i xyzuvf = v0.bd(v1);
+
+			GSVector8i xy = xyzuvf.upl16() - off2;
+			GSVector8i zf = xyzuvf.ywww().min_u32(GSVector8i::xffffff00());
+
+			GSVector8 p = GSVector8(xy).xyxy(GSVector8(zf) + (GSVector8::m_x4f800000 & GSVector8::cast(zf.sra32(31)))) * m_pos_scale2;
+			GSVector8 c = GSVector8(GSVector8i::cast(stcq).uph8().upl16() << 7);
+
+			GSVector8 t = GSVector8::zero();
+
+			if(color)
+			{
+				cmin2 = cmin2.min_u8(GSVector8i::cast(stcq));
+				cmax2 = cmax2.max_u8(GSVector8i::cast(stcq));
+			}
+
+			if(tme)
+			{
+				if(fst)
+				{
+					GSVector8i uv = xyzuvf.uph16();
+
+					t = GSVector8(uv << (16 - 4));
+
+					GSVector8 st = GSVector8(uv).xyxy();
+
+					tmin2 = tmin2.min(st);
+					tmax2 = tmax2.max(st);
+				}
+				else
+				{
+					t = stcq.xyww() * tsize2;
+
+					GSVector8 q = primclass == GS_SPRITE_CLASS ? stcq.bb().wwww() : stcq.wwww();
+
+					GSVector8 stq;
+
+					if(accurate_stq)
+						stq = (stcq.xyww() / q).xyww(q);
+					else
+						stq = (stcq.xyww() * q.rcpnr()).xyww(q);
+
+					tmin2 = tmin2.min(stq);
+					tmax2 = tmax2.max(stq);
+				}
+			}
+
+			GSVector8i pt = xyzuvf.upl16().blend16<0xf0>(xyzuvf.yyyy().uph32(xyzuvf));
+
+			if(primclass == GS_SPRITE_CLASS)
+			{
+				pt = pt.blend16<0xc0>(pt.bb()); // fog of the second vertex
+
+				t = t.insert32<1, 3>(GSVector8::cast(xyzuvf.min_u32(z_max2)));
+			}
+
+			pmin2 = pmin2.min_u32(pt);
+			pmax2 = pmax2.max_u32(pt);
+
+			GSVector8::storel(&dst[0].p, p);
+			GSVector8::store<true>(&dst[0].t, t.ac(c));
+			GSVector8::storeh(&dst[1].p, p);
+			GSVector8::store<true>(&dst[1].t, t.bd(c));
+		}
+
+		pmin = pmin2.extract<0>().min_u32(pmin2.extract<1>());
+		pmax = pmax2.extract<0>().max_u32(pmax2.extract<1>());
+		tmin = tmin2.extract<0>().min(tmin2.extract<1>());
+		tmax = tmax2.extract<0>().max(tmax2.extract<1>());
+		cmin = cmin2.extract<0>().min_u8(cmin2.extract<1>());
+		cmax = cmax2.extract<0>().max_u8(cmax2.extract<1>());
+	}
+
+	#endif
+
+	for(; i < count; i++, src++, dst++)
+	{
+		GSVector4 stcq = GSVector4::load<true>(&src->m[0]); // s t rgba q
+
+		GSVector4i xyzuvf(src->m[1]);
+
+		GSVector4i xy = xyzuvf.upl16() - off;
+		GSVector4i zf = xyzuvf.ywww().min_u32(GSVector4i::xffffff00());
+
+		dst->p = GSVector4(xy).xyxy(GSVector4(zf) + (GSVector4::m_x4f800000 & GSVector4::cast(zf.sra32(31)))) * m_pos_scale;
+		dst->c = GSVector4(GSVector4i::cast(stcq).zzzz().u8to32() << 7);
+
+		GSVector4 t = GSVector4::zero();
+
+		if(color)
+		{
+			cmin = cmin.min_u8(GSVector4i::cast(stcq));
+			cmax = cmax.max_u8(GSVector4i::cast(stcq));
+		}
+
+		// the first vertex of a sprite takes q and fog from the second one
+
+		bool first = primclass == GS_SPRITE_CLASS && (i & 1) == 0;
+
+		if(tme)
+		{
+			if(fst)
+			{
+				GSVector4i uv = xyzuvf.uph16();
+
+				t = GSVector4(uv << (16 - 4));
+
+				GSVector4 st = GSVector4(uv).xyxy();
+
+				tmin = tmin.min(st);
+				tmax = tmax.max(st);
+			}
+			else
+			{
+				t = stcq.xyww() * tsize;
+
+				GSVector4 q = first ? GSVector4::load<true>(&src[1].m[0]).wwww() : stcq.wwww();
+
+				GSVector4 stq;
+
+				if(accurate_stq)
+					stq = (stcq.xyww() / q).xyww(q);
+				else
+					stq = (stcq.xyww() * q.rcpnr()).xyww(q);
+
+				tmin = tmin.min(stq);
+				tmax = tmax.max(stq);
+			}
+		}
+
+		GSVector4i pt = xyzuvf.upl16().blend16<0xf0>(xyzuvf.yyyy().uph32(first ? GSVector4i(src[1].m[1]) : xyzuvf));
+
+		pmin = pmin.min_u32(pt);
+		pmax = pmax.max_u32(pt);
+
+		if(primclass == GS_SPRITE_CLASS)
+		{
+			t = t.insert32<1, 3>(GSVector4::cast(xyzuvf.min_u32(z_max)));
+		}
+
+		dst->t = t;
+	}
+
+	// see GSVertexTrace::FindMinMax, z is halved
+
+	b.pmin = pmin.blend16<0x30>(pmin.srl32(1));
+	b.pmax = pmax.blend16<0x30>(pmax.srl32(1));
+	b.tmin = tmin;
+	b.tmax = tmax;
+	b.cmin = cmin;
+	b.cmax = cmax;
+}
+
+#endif
+
+void GSRendererSW::UpdateVertexTrace()
+{
+	if(m_vertex_buff != NULL) // Draw did not get to take the previous one
+	{
+		_aligned_free(m_vertex_buff);
+
+		m_vertex_buff = NULL;
+	}
+
+	#if _M_SSE >= 0x401
+
+	// fans may leave unreferenced vertices behind (see GSState::VertexKick), let GSVertexTrace walk the index buffer for them
+
+	if(PRIM->PRIM != GS_TRIANGLEFAN)
+	{
+		GS_PRIM_CLASS primclass = GSUtil::GetPrimClass(PRIM->PRIM);
+
+		uint32 tme = PRIM->TME;
+		uint32 fst = PRIM->FST;
+		uint32 color = !(PRIM->TME && m_context->TEX0.TFX == TFX_DECAL && m_context->TEX0.TCC);
+
+		// flat shaded primitives take the color of their last vertex, only the index buffer knows which ones those are
+
+		uint32 flat = color && !PRIM->IIP && primclass != GS_POINT_CLASS;
+
+		size_t count = m_vertex.next;
+
+		m_vertex_buff = (uint8*)_aligned_malloc(sizeof(GSVertexSW) * ((count + 1) & ~1) + sizeof(uint32) * m_index.tail, 64);
+
+		VertexBounds b;
+
+		(this->*m_ctvb[primclass][tme][fst][color && !flat][m_vt.m_accurate_stq])((GSVertexSW*)m_vertex_buff, m_vertex.buff, count, b);
+
+		// Potential float overflow detected, see GSVertexTrace::Update
+
+		if(tme && !fst && !m_vt.m_accurate_stq && b.tmin.z > 1e30)
+		{
+			fprintf(stderr, "Vertex Trace: float overflow detected ! min %e max %e\n", b.tmin.z, b.tmax.z);
+
+			m_vt.m_accurate_stq = true;
+
+			(this->*m_ctvb[primclass][tme][fst][color && !flat][1])((GSVertexSW*)m_vertex_buff, m_vertex.buff, count, b);
+		}
+
+		if(flat)
+		{
+			int n = primclass == GS_TRIANGLE_CLASS ? 3 : 2;
+
+			b.cmin = GSVector4i::xffffffff();
+			b.cmax = GSVector4i::zero();
+
+			for(size_t i = n - 1; i < m_index.tail; i += n)
+			{
+				GSVector4i c(m_vertex.buff[m_index.buff[i]].m[0]);
+
+				b.cmin = b.cmin.min_u8(c);
+				b.cmax = b.cmax.max_u8(c);
+			}
+		}
+
+		m_vt.Update(m_vertex.buff, m_vertex.tail, primclass, GSVector4(b.pmin), GSVector4(b.pmax), b.tmin, b.tmax, b.cmin, b.cmax);
+
+		return;
+	}
+
+	#endif
+
+	GSState::UpdateVertexTrace();
+}
+
 void GSRendererSW::Draw()
 {
 	const GSDrawingContext* context = m_context;
@@ -393,7 +723,20 @@ void GSRendererSW::Draw()
 	std::shared_ptr<GSRasterizerData> data(sd);
 
 	sd->primclass = m_vt.m_primclass;
-	sd->buff = (uint8*)_aligned_malloc(sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1) + sizeof(uint32) * m_index.tail, 64);
+
+	bool converted = m_vertex_buff != NULL;
+
+	if(converted)
+	{
+		sd->buff = m_vertex_buff;
+
+		m_vertex_buff = NULL;
+	}
+	else
+	{
+		sd->buff = (uint8*)_aligned_malloc(sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1) + sizeof(uint32) * m_index.tail, 64);
+	}
+
 	sd->vertex = (GSVertexSW*)sd->buff;
 	sd->vertex_count = m_vertex.next;
 	sd->index = (uint32*)(sd->buff + sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1));
@@ -404,7 +747,14 @@ void GSRendererSW::Draw()
 	// If you have both GS_SPRITE_CLASS && m_vt.m_eq.q, it will depends on the first part of the 'OR'
 	uint32 q_div = !IsMipMapActive() && ((m_vt.m_eq.q && m_vt.m_min.t.z != 1.0f) || (!m_vt.m_eq.q && m_vt.m_primclass == GS_SPRITE_CLASS));
 
-	(this->*m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST][q_div])(sd->vertex, m_vertex.buff, m_vertex.next);
+	if(!converted)
+	{
+		(this->*m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST][q_div])(sd->vertex, m_vertex.buff, m_vertex.next);
+	}
+	else if(q_div && PRIM->TME && !PRIM->FST)
+	{
+		DivideVertexQ(sd->vertex, m_vertex.buff, m_vertex.next);
+	}
 
 	memcpy(sd->index, m_index.buff, sizeof(uint32) * m_index.tail);
 
@@ -471,18 +821,31 @@ void GSRendererSW::Draw()
 		zb_pages = m_context->offset.zb->GetPages(r);
 	}
 
-	// check if there is an overlap between this and previous targets
+	// check if there is an overlap between this and previous targets, and if the texture is
+	// not part of a target currently in use; only the draws using those pages are waited for.
+	// This has to be done before the pages of this draw are referenced below.
 
 	if(CheckTargetPages(fb_pages, zb_pages, r))
 	{
-		sd->m_syncpoint = SharedData::SyncTarget;
+		SyncPages(5);
 	}
 
-	// check if the texture is not part of a target currently in use
-
 	if(CheckSourcePages(sd))
 	{
-		sd->m_syncpoint = SharedData::SyncSource;
+		SyncPages(4);
+	}
+
+	// content sharing reads the whole texture from GS memory here, skip it while queued draws still write some of it
+
+	if(!sd->global.sel.tsw)
+	{
+		for(size_t i = 0; sd->m_tex[i].t != NULL; i++)
+		{
+			if(!IsDrawingTo(sd->m_tex[i].t->m_pages.n))
+			{
+				m_tc->Share(sd->m_tex[i].t);
+			}
+		}
 	}
 
 	// addref source and target pages
@@ -592,20 +955,10 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 {
 	SharedData* sd = (SharedData*)item.get();
 
-	if(sd->m_syncpoint == SharedData::SyncSource) 
-	{
-		Sync(4);
-	}
-
 	// update previously invalidated parts
 
 	sd->UpdateSource();
 
-	if(sd->m_syncpoint == SharedData::SyncTarget)
-	{
-		Sync(5);
-	}
-
 	if(LOG)
 	{
 		GSScanlineGlobalData& gd = ((SharedData*)item.get())->global;
@@ -673,6 +1026,74 @@ void GSRendererSW::Sync(int reason)
 	if(LOG) {fprintf(s_fp, "sync n=%d r=%d t=%llu p=%d %c\n", s_n, reason, t, pixels, t > 10000000 ? '*' : ' '); fflush(s_fp);}
 
 	m_perfmon.Put(GSPerfMon::Fillrate, pixels);
+
+	PutSyncReason(reason);
+}
+
+void GSRendererSW::AddSyncPage(uint32 page, uint32 fzb, bool tex)
+{
+	if(m_sync_fzb[page] == 0 && m_sync_tex[page] == 0)
+	{
+		m_sync_list[m_sync_count++] = (uint16)page;
+	}
+
+	m_sync_fzb[page] |= fzb;
+	m_sync_tex[page] |= tex ? 1 : 0;
+}
+
+void GSRendererSW::SyncPages(int reason)
+{
+	// Waits for the in-flight draws referencing the pages collected by AddSyncPage, the rest of
+	// the queues keep running. Page references are dropped when the last worker is done with
+	// a draw (SharedData::ReleasePages), so a page becoming free means all its users finished.
+
+	if(m_sync_count == 0)
+	{
+		return;
+	}
+
+	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
+
+	uint64 t = __rdtsc();
+
+	for(int i = 0; i < m_sync_count; i++)
+	{
+		uint32 page = m_sync_list[i];
+
+		while((m_fzb_pages[page] & m_sync_fzb[page]) != 0 || (m_sync_tex[page] && m_tex_pages[page] != 0))
+		{
+			std::this_thread::yield();
+		}
+
+		m_sync_fzb[page] = 0;
+		m_sync_tex[page] = 0;
+	}
+
+	t = __rdtsc() - t;
+
+	if(LOG) {fprintf(s_fp, "sync pages n=%d r=%d c=%d t=%llu\n", s_n, reason, m_sync_count, t); fflush(s_fp);}
+
+	m_sync_count = 0;
+
+	m_perfmon.Put(GSPerfMon::SyncPages, 1);
+
+	PutSyncReason(reason);
+}
+
+void GSRendererSW::PutSyncReason(int reason)
+{
+	switch(reason)
+	{
+	case -1: m_perfmon.Put(GSPerfMon::SyncReset, 1); break;
+	case 0: m_perfmon.Put(GSPerfMon::SyncVSync, 1); break;
+	case 1: m_perfmon.Put(GSPerfMon::SyncOutput, 1); break;
+	case 2: case 3: m_perfmon.Put(GSPerfMon::SyncDump, 1); break;
+	case 4: m_perfmon.Put(GSPerfMon::SyncSource, 1); break;
+	case 5: m_perfmon.Put(GSPerfMon::SyncTarget, 1); break;
+	case 6: m_perfmon.Put(GSPerfMon::SyncWrite, 1); break;
+	case 7: m_perfmon.Put(GSPerfMon::SyncRead, 1); break;
+	default: break;
+	}
 }
 
 void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r)
@@ -691,11 +1112,11 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 		{
 			if(m_fzb_pages[*p] | m_tex_pages[*p])
 			{
-				Sync(6);
-
-				break;
+				AddSyncPage(*p, 0xffffffff, true);
 			}
 		}
+
+		SyncPages(6);
 	}
 
 	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
@@ -715,11 +1136,11 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 		{
 			if(m_fzb_pages[*p])
 			{
-				Sync(7);
-
-				break;
+				AddSyncPage(*p, 0xffffffff, false);
 			}
 		}
+
+		SyncPages(7);
 	}
 }
 
@@ -767,6 +1188,8 @@ void GSRendererSW::ReleasePages(const uint32* pages, const int type)
 
 bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
 {
+	// Collects the conflicting pages for SyncPages instead of syncing the whole rasterizer.
+
 	bool synced = m_rl->IsSynced();
 
 	bool fb = fb_pages != NULL;
@@ -786,8 +1209,6 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 		memset(m_fzb_cur_pages, 0, sizeof(m_fzb_cur_pages));
 
-		uint32 used = 0;
-
 		for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 		{
 			uint32 i = *p;
@@ -797,8 +1218,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			if(!synced && (m_fzb_pages[i] | m_tex_pages[i]))
+			{
+				AddSyncPage(i, 0xffffffff, true);
+
+				res = true;
+			}
 		}
 
 		for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
@@ -810,20 +1235,17 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
-		}
-
-		if(!synced)
-		{
-			if(used)
+			if(!synced && (m_fzb_pages[i] | m_tex_pages[i]))
 			{
-				if(LOG) {fprintf(s_fp, "syncpoint 0\n"); fflush(s_fp);}
+				AddSyncPage(i, 0xffffffff, true);
 
 				res = true;
 			}
+		}
 
-			//if(LOG) {fprintf(s_fp, "no syncpoint *\n"); fflush(s_fp);}
+		if(res)
+		{
+			if(LOG) {fprintf(s_fp, "syncpoint 0\n"); fflush(s_fp);}
 		}
 	}
 	else
@@ -843,8 +1265,6 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			if(fb_pages == NULL) fb_pages = m_context->offset.fb->GetPages(r);
 			if(zb_pages == NULL) zb_pages = m_context->offset.zb->GetPages(r);
 
-			uint32 used = 0;
-
 			for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 			{
 				uint32 i = *p;
@@ -856,7 +1276,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(!synced && m_fzb_pages[i])
+					{
+						AddSyncPage(i, 0xffffffff, false);
+
+						res = true;
+					}
 				}
 			}
 
@@ -871,18 +1296,18 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(!synced && m_fzb_pages[i])
+					{
+						AddSyncPage(i, 0xffffffff, false);
+
+						res = true;
+					}
 				}
 			}
 
-			if(!synced)
+			if(res)
 			{
-				if(used)
-				{
-					if(LOG) {fprintf(s_fp, "syncpoint 1\n"); fflush(s_fp);}
-
-					res = true;
-				}
+				if(LOG) {fprintf(s_fp, "syncpoint 1\n"); fflush(s_fp);}
 			}
 		}
 
@@ -891,7 +1316,7 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			// chross-check frame and z-buffer pages, they cannot overlap with eachother and with previous batches in queue,
 			// have to be careful when the two buffers are mutually enabled/disabled and alternating (Bully FBP/ZBP = 0x2300)
 
-			if(fb && !res)
+			if(fb)
 			{
 				for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 				{
@@ -899,14 +1324,23 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 					{
 						if(LOG) {fprintf(s_fp, "syncpoint 2\n"); fflush(s_fp);}
 
+						AddSyncPage(*p, 0xffff0000, false);
+
 						res = true;
+					}
+
+					if(m_tex_pages[*p])
+					{
+						// textures of queued draws are unswizzled by the workers (SharedData::PrepareDraw), they may still read this page
+
+						AddSyncPage(*p, 0, true);
 
-						break;
+						res = true;
 					}
 				}
 			}
 
-			if(zb && !res)
+			if(zb)
 			{
 				for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
 				{
@@ -914,9 +1348,16 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 					{
 						if(LOG) {fprintf(s_fp, "syncpoint 3\n"); fflush(s_fp);}
 
+						AddSyncPage(*p, 0x0000ffff, false);
+
 						res = true;
+					}
 
-						break;
+					if(m_tex_pages[*p])
+					{
+						AddSyncPage(*p, 0, true);
+
+						res = true;
 					}
 				}
 			}
@@ -929,8 +1370,26 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 	return res;
 }
 
+bool GSRendererSW::IsDrawingTo(const uint32* pages) const
+{
+	if(!m_rl->IsSynced())
+	{
+		for(const uint32* p = pages; *p != GSOffset::EOP; p++)
+		{
+			if(m_fzb_pages[*p])
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 bool GSRendererSW::CheckSourcePages(SharedData* sd)
 {
+	bool res = false;
+
 	if(!m_rl->IsSynced())
 	{
 		for(size_t i = 0; sd->m_tex[i].t != NULL; i++)
@@ -945,17 +1404,61 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 
 				if(m_fzb_pages[*p]) // currently being drawn to? => sync
 				{
-					return true;
+					AddSyncPage(*p, 0xffffffff, false);
+
+					res = true;
 				}
 			}
 		}
 	}
 
-	return false;
+	return res;
 }
 
 #include "GSTextureSW.h"
 
+int GSRendererSW::GetSwizzledTexture(SharedData* data, GSTextureCacheSW::Texture* t, const GSVector4i& r, const GIFRegTEX0& TEX0)
+{
+	// Sampling the swizzled texture in place costs a few table lookups per texel read, unswizzling it into the
+	// cache costs a pass over the invalid blocks of the uv range. Textures drawn only once or minified a lot,
+	// like a previous render target or fmv frames, have more texels to unswizzle than pixels to draw.
+
+	int tsw = TEX0.PSM == PSM_PSMCT32 ? 1 : TEX0.PSM == PSM_PSMT8 ? 2 : TEX0.PSM == PSM_PSMT4 ? 3 : 0;
+
+	if(tsw == 0)
+	{
+		return 0;
+	}
+
+	GSVector4i rd = data->bbox.rintersect(data->scissor);
+
+	uint32 pixels = (uint32)std::max<int>(rd.width(), 0) * (uint32)std::max<int>(rd.height(), 0);
+
+	if(t->GetInvalidTexels(r) < pixels << (data->global.sel.ltf ? 2 : 0))
+	{
+		return 0;
+	}
+
+	// the cached texture is a snapshot, vm is not, the draw must not write what it samples
+
+	uint32 pages[MAX_PAGES / 32];
+
+	for(GSOffset* off : {m_context->offset.fb, m_context->offset.zb})
+	{
+		off->GetPagesAsBits(rd, pages);
+
+		for(size_t i = 0; i < countof(pages); i++)
+		{
+			if(pages[i] & t->m_pages.bm[i])
+			{
+				return 0;
+			}
+		}
+	}
+
+	return tsw;
+}
+
 bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 {
 	GSScanlineGlobalData& gd = data->global;
@@ -1089,6 +1592,20 @@ bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 
 			gd.sel.tw = t->m_tw - 3;
 
+#ifdef ENABLE_SWIZZLED_TEXTURE
+			if(m_swizzled_texture && !mipmap)
+			{
+				gd.sel.tsw = GetSwizzledTexture(data, t, r, TEX0);
+
+				if(gd.sel.tsw)
+				{
+					gd.tbr = t->m_offset->pixel.row;
+
+					m_perfmon.Put(GSPerfMon::TextureSwizzled, 1);
+				}
+			}
+#endif
+
 			if(mipmap)
 			{
 				// TEX1.MMIN
@@ -1431,7 +1948,6 @@ GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
 	, m_fpsm(0)
 	, m_zpsm(0)
 	, m_using_pages(false)
-	, m_syncpoint(SyncNone)
 {
 	m_tex[0].t = NULL;
 
@@ -1536,9 +2052,19 @@ void GSRendererSW::SharedData::UpdateSource()
 {
 	for(size_t i = 0; m_tex[i].t != NULL; i++)
 	{
+		if(global.sel.tsw)
+		{
+			continue; // sampled in place
+		}
+
 		if(m_tex[i].t->Update(m_tex[i].r))
 		{
 			global.tex[i] = m_tex[i].t->m_buff;
+
+			if(m_tex[i].t->m_job && !m_tex[i].t->m_job->IsDone())
+			{
+				m_tex[i].job = m_tex[i].t->m_job;
+			}
 		}
 		else
 		{
@@ -1564,6 +2090,15 @@ void GSRendererSW::SharedData::UpdateSource()
 
 				s = format("%05d_f%lld_itex%d_%05x_%s.bmp", m_parent->s_n, frame, i, TEX0.TBP0, psm_str(TEX0.PSM));
 
+				if(m_tex[i].job)
+				{
+					m_tex[i].job->Run();
+				}
+				else if(global.sel.tsw && m_tex[i].t->Update(m_tex[i].r) && m_tex[i].t->m_job)
+				{
+					m_tex[i].t->m_job->Run();
+				}
+
 				m_tex[i].t->Save(root_sw+s);
 			}
 
@@ -1582,3 +2117,16 @@ void GSRendererSW::SharedData::UpdateSource()
 		}
 	}
 }
+
+void GSRendererSW::SharedData::PrepareDraw()
+{
+	// each worker drawing this helps unswizzling the invalid parts of the textures before sampling them
+
+	for(size_t i = 0; m_tex[i].t != NULL; i++)
+	{
+		if(m_tex[i].job)
+		{
+			m_tex[i].job->Run();
+		}
+	}
+}
@@ -37,6 +37,7 @@ class GSRendererSW : public GSRenderer
 		{
 			GSVector4i r; 
 			GSTextureCacheSW::Texture* t;
+			std::shared_ptr<GSTextureCacheSW::UpdateJob> job;
 		};
 
 	public:
@@ -47,7 +48,6 @@ class GSRendererSW : public GSRenderer
 		int m_zpsm;
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
-		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
 
 	public:
 		SharedData(GSRendererSW* parent);
@@ -58,6 +58,7 @@ class GSRendererSW : public GSRenderer
 
 		void SetSource(GSTextureCacheSW::Texture* t, const GSVector4i& r, int level);
 		void UpdateSource();
+		void PrepareDraw();
 	};
 
 	typedef void (GSRendererSW::*ConvertVertexBufferPtr)(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
@@ -67,6 +68,27 @@ class GSRendererSW : public GSRenderer
 	template<uint32 primclass, uint32 tme, uint32 fst, uint32 q_div>
 	void ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
 
+	void DivideVertexQ(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
+
+#if _M_SSE >= 0x401
+
+	struct VertexBounds {GSVector4i pmin, pmax, cmin, cmax; GSVector4 tmin, tmax;};
+
+	typedef void (GSRendererSW::*ConvertTraceVertexBufferPtr)(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count, VertexBounds& b);
+
+	ConvertTraceVertexBufferPtr m_ctvb[4][2][2][2][2];
+
+	template<uint32 primclass, uint32 tme, uint32 fst, uint32 color, uint32 accurate_stq>
+	void ConvertTraceVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count, VertexBounds& b);
+
+#endif
+
+	uint8* m_vertex_buff; // converted by UpdateVertexTrace, Draw takes it over
+
+#ifdef ENABLE_SWIZZLED_TEXTURE
+	bool m_swizzled_texture;
+#endif
+
 protected:
 	IRasterizer* m_rl;
 	GSTextureCacheSW* m_tc;
@@ -78,6 +100,10 @@ protected:
 	std::atomic<uint32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<uint16> m_tex_pages[512];
 	uint32 m_tmp_pages[512 + 1];
+	uint32 m_sync_fzb[512]; // m_fzb_pages bits to wait for
+	uint8 m_sync_tex[512]; // wait for m_tex_pages too
+	uint16 m_sync_list[512];
+	int m_sync_count;
 
 	void Reset();
 	void VSync(int field);
@@ -85,9 +111,13 @@ protected:
 	GSTexture* GetOutput(int i, int& y_offset);
 	GSTexture* GetFeedbackOutput();
 
+	void UpdateVertexTrace();
 	void Draw();
 	void Queue(std::shared_ptr<GSRasterizerData>& item);
 	void Sync(int reason);
+	void AddSyncPage(uint32 page, uint32 fzb, bool tex);
+	void SyncPages(int reason);
+	void PutSyncReason(int reason);
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
@@ -96,7 +126,9 @@ protected:
 
 	bool CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
 	bool CheckSourcePages(SharedData* sd);
+	bool IsDrawingTo(const uint32* pages) const;
 
+	int GetSwizzledTexture(SharedData* data, GSTextureCacheSW::Texture* t, const GSVector4i& r, const GIFRegTEX0& TEX0);
 	bool GetScanlineGlobalData(SharedData* data);
 
 public:
@@ -69,6 +69,7 @@ union GSScanlineSelector
 		uint32 lcm:1; // 53
 		uint32 mmin:2; // 54
 		uint32 notest:1; // 55 (no ztest, no atest, no date, no scissor test, and horizontally aligned to 4 pixels)
+		uint32 tsw:2; // 56 (sample the swizzled texture in vm, 1: PSMCT32, 2: PSMT8, 3: PSMT4)
 		// TODO: 1D texture flag? could save 2 texture reads and 4 lerps with bilinear, and also the texture coordinate clamp/wrap code in one direction
 
 		uint32 breakpoint:1; // Insert a trap to stop the program, helpful to stop debugger on a program
@@ -114,11 +115,11 @@ union GSScanlineSelector
 	void Print() const
 	{
 		fprintf(stderr, "fpsm:%d zpsm:%d ztst:%d ztest:%d atst:%d afail:%d iip:%d rfb:%d fb:%d zb:%d zw:%d "
-				"tfx:%d tcc:%d fst:%d ltf:%d tlu:%d wms:%d wmt:%d mmin:%d lcm:%d tw:%d "
+				"tfx:%d tcc:%d fst:%d ltf:%d tlu:%d wms:%d wmt:%d mmin:%d lcm:%d tw:%d tsw:%d "
 				"fba:%d cclamp:%d date:%d datm:%d "
 				"prim:%d abe:%d %d%d%d%d fge:%d dthe:%d notest:%d\n",
 				fpsm, zpsm, ztst, ztest, atst, afail, iip, rfb, fb, zb, zwrite,
-				tfx, tcc, fst, ltf, tlu, wms, wmt, mmin, lcm, tw,
+				tfx, tcc, fst, ltf, tlu, wms, wmt, mmin, lcm, tw, tsw,
 				fba, colclamp, date, datm,
 				prim, abe, aba, abb, abc, abd , fge, dthe, notest);
 	}
@@ -143,6 +144,7 @@ struct alignas(32) GSScanlineGlobalData // per batch variables, this is like a p
 	const int* zbc;
 	const GSVector2i* fzbr;
 	const GSVector2i* fzbc;
+	const int* tbr; // sel.tsw, GSOffset::pixel.row of the texture
 
 	GSVector4i aref;
 	GSVector4i afix;
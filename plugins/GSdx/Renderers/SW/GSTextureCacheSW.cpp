@@ -36,16 +36,13 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 {
 	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 
-	auto& m = m_map[TEX0.TBP0 >> 5];
+	uint64 key = TEX0.u32[0] | ((uint64)(TEX0.u32[1] & 3) << 32); // TBP0 TBW PSM TW TH
 
-	for(auto i = m.begin(); i != m.end(); ++i)
-	{
-		Texture* t = *i;
+	auto range = m_index.equal_range(key);
 
-		if(((TEX0.u32[0] ^ t->m_TEX0.u32[0]) | ((TEX0.u32[1] ^ t->m_TEX0.u32[1]) & 3)) != 0) // TBP0 TBW PSM TW TH
-		{
-			continue;
-		}
+	for(auto i = range.first; i != range.second; ++i)
+	{
+		Texture* t = i->second;
 
 		if((psm.trbpp == 16 || psm.trbpp == 24) && TEX0.TCC && TEXA != t->m_TEXA)
 		{
@@ -58,25 +55,79 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 		}
 
 		// Lookup hit
-		m.MoveFront(i.Index());
+
 		t->m_age = 0;
+
+		m_state->m_perfmon.Put(GSPerfMon::TextureHit, 1);
+
 		return t;
 	}
 
 	// Lookup miss
+
 	Texture* t = new Texture(m_state, tw0, TEX0, TEXA);
 
 	m_textures.insert(t);
 
+	m_index.insert(std::make_pair(key, t));
+
 	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
 	{
 		const uint32 page = *p;
 		t->m_erase_it[page] = m_map[page].InsertFront(t);
 	}
 
+	m_state->m_perfmon.Put(GSPerfMon::TextureMiss, 1);
+
 	return t;
 }
 
+void GSTextureCacheSW::Share(Texture* t)
+{
+	// Reads the GS memory of t, the caller makes sure no queued draw is writing it anymore.
+	// Hashing runs on the GS thread, so only small textures take part and a new texture is
+	// only hashed if there is a donor of the same shape.
+
+	if(t->m_hashed || t->GetBlockCount() > Texture::MaxShareBlocks)
+	{
+		return;
+	}
+
+	if(t->m_complete)
+	{
+		// used again and fully decoded, others uploading the same data somewhere else can copy it
+
+		if(!t->m_job || t->m_job->IsDone())
+		{
+			t->m_hash = t->Hash();
+
+			AddContent(t);
+		}
+	}
+	else if(t->m_buff == NULL && m_shapes.find(t->GetShape()) != m_shapes.end())
+	{
+		// not decoded at all yet
+
+		uint64 hash = t->Hash();
+
+		auto range = m_content.equal_range(hash);
+
+		for(auto i = range.first; i != range.second; ++i)
+		{
+			if(t->CanShare(i->second) && t->HasSameSource(i->second) && t->CopyFrom(i->second))
+			{
+				t->m_hash = hash;
+
+				AddContent(t);
+
+				m_state->m_perfmon.Put(GSPerfMon::TextureReuse, 1);
+
+				break;
+			}
+		}
+	}
+}
+
 void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 {
 	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
@@ -102,6 +153,11 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 				}
 
 				t->m_complete = false;
+
+				if(t->m_hashed)
+				{
+					RemoveContent(t);
+				}
 			}
 		}
 	}
@@ -117,6 +173,10 @@ void GSTextureCacheSW::RemoveAll()
 	{
 		l.clear();
 	}
+
+	m_index.clear();
+	m_content.clear();
+	m_shapes.clear();
 }
 
 void GSTextureCacheSW::IncAge()
@@ -129,13 +189,9 @@ void GSTextureCacheSW::IncAge()
 		{
 			i = m_textures.erase(i);
 
-			for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-			{
-				const uint32 page = *p;
-				m_map[page].EraseIndex(t->m_erase_it[page]);
-			}
+			Remove(t);
 
-			delete t;
+			m_state->m_perfmon.Put(GSPerfMon::TextureEvict, 1);
 		}
 		else
 		{
@@ -144,6 +200,69 @@ void GSTextureCacheSW::IncAge()
 	}
 }
 
+void GSTextureCacheSW::Remove(Texture* t)
+{
+	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+	{
+		const uint32 page = *p;
+		m_map[page].EraseIndex(t->m_erase_it[page]);
+	}
+
+	uint64 key = t->m_TEX0.u32[0] | ((uint64)(t->m_TEX0.u32[1] & 3) << 32);
+
+	auto range = m_index.equal_range(key);
+
+	for(auto i = range.first; i != range.second; ++i)
+	{
+		if(i->second == t)
+		{
+			m_index.erase(i);
+
+			break;
+		}
+	}
+
+	if(t->m_hashed)
+	{
+		RemoveContent(t);
+	}
+
+	delete t;
+}
+
+void GSTextureCacheSW::AddContent(Texture* t)
+{
+	m_content.insert(std::make_pair(t->m_hash, t));
+
+	m_shapes[t->GetShape()]++;
+
+	t->m_hashed = true;
+}
+
+void GSTextureCacheSW::RemoveContent(Texture* t)
+{
+	auto range = m_content.equal_range(t->m_hash);
+
+	for(auto i = range.first; i != range.second; ++i)
+	{
+		if(i->second == t)
+		{
+			m_content.erase(i);
+
+			break;
+		}
+	}
+
+	auto shape = m_shapes.find(t->GetShape());
+
+	if(shape != m_shapes.end() && --shape->second == 0)
+	{
+		m_shapes.erase(shape);
+	}
+
+	t->m_hashed = false;
+}
+
 //
 
 GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
@@ -153,6 +272,8 @@ GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0&
 	, m_age(0)
 	, m_complete(false)
 	, m_p2t(NULL)
+	, m_hash(0)
+	, m_hashed(false)
 {
 	m_TEX0 = TEX0;
 	m_TEXA = TEXA;
@@ -214,33 +335,91 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 		m_complete = true; // lame, but better than nothing
 	}
 
-	if(m_buff == NULL)
+	if(!Allocate())
 	{
-		uint32 pitch = (1 << m_tw) << shift;
-		
-		m_buff = _aligned_malloc(pitch * th * 4, 32);
+		return false;
+	}
+
+	// the invalid blocks are only collected here, the workers drawing with this texture share the unswizzling (UpdateJob::Run)
+
+	std::shared_ptr<UpdateJob> job;
+
+	uint32 blocks = 0;
 
-		if(m_buff == NULL)
+	ForEachBlock(r, [&](uint32 block, uint32 offset, uint32 i)
+	{
+		uint32 row = i >> 5;
+		uint32 col = 1 << (i & 31);
+
+		if((m_valid[row] & col) == 0)
 		{
-			return false;
+			m_valid[row] |= col;
+
+			if(!job) job = std::make_shared<UpdateJob>(this, m_job);
+
+			job->Add(block, offset);
+
+			blocks++;
 		}
+	});
+
+	if(blocks > 0)
+	{
+		m_state->m_perfmon.Put(GSPerfMon::Unswizzle, (bs.x >> 3) * (bs.y >> 3) * blocks << (shift + 3));
+
+		m_job = job;
+	}
+	else if(m_job && m_job->IsDone())
+	{
+		m_job.reset();
 	}
 
-	GSLocalMemory& mem = m_state->m_mem;
+	return true;
+}
+
+uint32 GSTextureCacheSW::Texture::GetInvalidTexels(const GSVector4i& rect) const
+{
+	// what Update(rect) would unswizzle
 
-	const GSOffset* RESTRICT off = m_offset;
+	if(m_complete)
+	{
+		return 0;
+	}
+
+	GSVector2i bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
 
 	uint32 blocks = 0;
 
-	GSLocalMemory::readTextureBlock rtxbP = psm.rtxbP;
+	ForEachBlock(rect.ralign<Align_Outside>(bs), [&](uint32 block, uint32 offset, uint32 i)
+	{
+		if((m_valid[i >> 5] & (1 << (i & 31))) == 0)
+		{
+			blocks++;
+		}
+	});
+
+	return blocks * bs.x * bs.y;
+}
+
+template<class T> void GSTextureCacheSW::Texture::ForEachBlock(const GSVector4i& rect, const T& f) const
+{
+	// rect is aligned to the block size, f(block, offset of the block in m_buff, m_valid bit)
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	const GSOffset* RESTRICT off = m_offset;
+
+	GSVector2i bs = psm.bs;
+
+	int shift = psm.pal == 0 ? 2 : 0;
 
 	uint32 pitch = (1 << m_tw) << shift;
 
-	uint8* dst = (uint8*)m_buff + pitch * r.top;
+	uint32 offset = pitch * rect.top;
 
-	int block_pitch = pitch * bs.y;
+	uint32 block_pitch = pitch * bs.y;
 
-	r = r.srl32(3);
+	GSVector4i r = rect.srl32(3);
 
 	bs.x >>= 3;
 	bs.y >>= 3;
@@ -249,7 +428,7 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 
 	if(m_repeating)
 	{
-		for(int y = r.top; y < r.bottom; y += bs.y, dst += block_pitch)
+		for(int y = r.top; y < r.bottom; y += bs.y, offset += block_pitch)
 		{
 			uint32 base = off->block.row[y];
 
@@ -257,23 +436,13 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 			{
 				uint32 block = (base + off->block.col[x]) % MAX_BLOCKS;
 
-				uint32 row = i >> 5;
-				uint32 col = 1 << (i & 31);
-
-				if((m_valid[row] & col) == 0)
-				{
-					m_valid[row] |= col;
-
-					(mem.*rtxbP)(block, &dst[x << shift], pitch, m_TEXA);
-
-					blocks++;
-				}
+				f(block, offset + (x << shift), (uint32)i);
 			}
 		}
 	}
 	else
 	{
-		for(int y = r.top; y < r.bottom; y += bs.y, dst += block_pitch)
+		for(int y = r.top; y < r.bottom; y += bs.y, offset += block_pitch)
 		{
 			uint32 base = off->block.row[y];
 
@@ -281,29 +450,238 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 			{
 				uint32 block = (base + off->block.col[x]) % MAX_BLOCKS;
 
-				uint32 row = block >> 5;
-				uint32 col = 1 << (block & 31);
+				f(block, offset + (x << shift), block);
+			}
+		}
+	}
+}
 
-				if((m_valid[row] & col) == 0)
-				{
-					m_valid[row] |= col;
+bool GSTextureCacheSW::Texture::Allocate()
+{
+	if(m_buff == NULL)
+	{
+		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
 
-					(mem.*rtxbP)(block, &dst[x << shift], pitch, m_TEXA);
+		uint32 pitch = (1 << m_tw) << (psm.pal == 0 ? 2 : 0);
+		uint32 th = std::max<int>(1 << m_TEX0.TH, psm.bs.y);
 
-					blocks++;
-				}
+		m_buff = _aligned_malloc(pitch * th * 4, 32);
+	}
+
+	return m_buff != NULL;
+}
+
+bool GSTextureCacheSW::Texture::CanShare(const Texture* t) const
+{
+	// same decoded layout, the address and the buffer width may differ
+
+	if(t == this || !t->m_hashed || t->m_buff == NULL || t->m_tw != m_tw)
+	{
+		return false;
+	}
+
+	if(t->m_job && !t->m_job->IsDone())
+	{
+		return false; // still being unswizzled by the workers, not going to wait for that here
+	}
+
+	if(t->m_TEX0.PSM != m_TEX0.PSM || t->m_TEX0.TW != m_TEX0.TW || t->m_TEX0.TH != m_TEX0.TH)
+	{
+		return false;
+	}
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	if((psm.trbpp == 16 || psm.trbpp == 24) && t->m_TEXA != m_TEXA)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+uint32 GSTextureCacheSW::Texture::GetBlockCount() const
+{
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	int tw = std::max<int>(1 << m_TEX0.TW, psm.bs.x);
+	int th = std::max<int>(1 << m_TEX0.TH, psm.bs.y);
+
+	return (tw / psm.bs.x) * (th / psm.bs.y);
+}
+
+uint32 GSTextureCacheSW::Texture::GetShape() const
+{
+	// what CanShare compares, besides TEXA
+
+	return m_TEX0.PSM | (m_TEX0.TW << 6) | (m_TEX0.TH << 10) | (m_tw << 14);
+}
+
+bool GSTextureCacheSW::Texture::HasSameSource(const Texture* t) const
+{
+	// equal hashes are not proof enough, compare the blocks in texture order (the layouts match, see CanShare)
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	GSVector4i r(0, 0, std::max<int>(1 << m_TEX0.TW, psm.bs.x), std::max<int>(1 << m_TEX0.TH, psm.bs.y));
+
+	uint32 blocks[MaxShareBlocks];
+	uint32 n = 0;
+
+	ASSERT(t->GetBlockCount() <= MaxShareBlocks);
+
+	t->ForEachBlock(r, [&](uint32 block, uint32 offset, uint32 i)
+	{
+		blocks[n++] = block;
+	});
+
+	const GSLocalMemory& mem = m_state->m_mem;
+
+	bool same = true;
+
+	n = 0;
+
+	ForEachBlock(r, [&](uint32 block, uint32 offset, uint32 i)
+	{
+		if(same && memcmp(mem.BlockPtr(block), mem.BlockPtr(blocks[n]), 256) != 0)
+		{
+			same = false;
+		}
+
+		n++;
+	});
+
+	return same;
+}
+
+uint64 GSTextureCacheSW::Texture::Hash() const
+{
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	int tw = std::max<int>(1 << m_TEX0.TW, psm.bs.x);
+	int th = std::max<int>(1 << m_TEX0.TH, psm.bs.y);
+
+	const GSLocalMemory& mem = m_state->m_mem;
+
+	// four independent lanes of 64-bit multiply/xorshift over the blocks in texture order
+
+	uint64 h[4] = {0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0x27d4eb2f165667c5ull};
+
+	ForEachBlock(GSVector4i(0, 0, tw, th), [&](uint32 block, uint32 offset, uint32 i)
+	{
+		const uint64* RESTRICT src = (const uint64*)mem.BlockPtr(block);
+
+		for(int j = 0; j < 32; j += 4)
+		{
+			for(int k = 0; k < 4; k++)
+			{
+				uint64 x = (h[k] ^ src[j + k]) * 0xff51afd7ed558ccdull;
+
+				h[k] = x ^ (x >> 32);
 			}
 		}
-	}
+	});
 
-	if(blocks > 0)
+	uint64 x = h[0] ^ (h[1] * 31) ^ (h[2] * 961) ^ (h[3] * 29791);
+
+	x = (x ^ (x >> 33)) * 0xc4ceb9fe1a85ec53ull;
+
+	return x ^ (x >> 33);
+}
+
+bool GSTextureCacheSW::Texture::CopyFrom(const Texture* t)
+{
+	if(!Allocate())
 	{
-		m_state->m_perfmon.Put(GSPerfMon::Unswizzle, bs.x * bs.y * blocks << shift);
+		return false;
 	}
 
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	uint32 pitch = (1 << m_tw) << (psm.pal == 0 ? 2 : 0);
+	uint32 th = std::max<int>(1 << m_TEX0.TH, psm.bs.y);
+
+	memcpy(m_buff, t->m_buff, pitch * th);
+
+	int tw = std::max<int>(1 << m_TEX0.TW, psm.bs.x);
+
+	ForEachBlock(GSVector4i(0, 0, tw, (int)th), [&](uint32 block, uint32 offset, uint32 i)
+	{
+		m_valid[i >> 5] |= 1 << (i & 31);
+	});
+
+	m_complete = true;
+
 	return true;
 }
 
+// GSTextureCacheSW::UpdateJob
+
+GSTextureCacheSW::UpdateJob::UpdateJob(const Texture* t, const std::shared_ptr<UpdateJob>& prev)
+	: m_tex(t)
+	, m_next(0)
+	, m_done(0)
+{
+	if(prev && !prev->IsDone())
+	{
+		m_prev = prev;
+	}
+}
+
+void GSTextureCacheSW::UpdateJob::Run()
+{
+	// Called by every thread about to sample the texture. Tiles are handed out in small batches,
+	// a thread running out of batches waits for the others to finish theirs.
+
+	if(m_prev)
+	{
+		m_prev->Run();
+	}
+
+	const int count = (int)m_tiles.size();
+
+	if(m_done == count)
+	{
+		return;
+	}
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_tex->m_TEX0.PSM];
+
+	GSLocalMemory& mem = m_tex->m_state->m_mem;
+
+	GSLocalMemory::readTextureBlock rtxbP = psm.rtxbP;
+
+	int pitch = (1 << m_tex->m_tw) << (psm.pal == 0 ? 2 : 0);
+
+	uint8* buff = (uint8*)m_tex->m_buff;
+
+	const int batch = 32;
+
+	for(;;)
+	{
+		int i = m_next.fetch_add(batch);
+
+		if(i >= count)
+		{
+			break;
+		}
+
+		int n = std::min<int>(batch, count - i);
+
+		for(const Tile* RESTRICT tile = &m_tiles[i], * RESTRICT tile_end = tile + n; tile < tile_end; tile++)
+		{
+			(mem.*rtxbP)(tile->block, &buff[tile->offset], pitch, m_tex->m_TEXA);
+		}
+
+		m_done.fetch_add(n);
+	}
+
+	while(m_done < count)
+	{
+		std::this_thread::yield();
+	}
+}
+
 #include "GSTextureSW.h"
 
 bool GSTextureCacheSW::Texture::Save(const std::string& fn, bool dds) const
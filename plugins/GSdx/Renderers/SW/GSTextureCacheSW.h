@@ -27,9 +27,13 @@
 class GSTextureCacheSW
 {
 public:
+	class UpdateJob;
+
 	class Texture
 	{
 	public:
+		enum {MaxShareBlocks = 256}; // 64KB of GS memory, largest texture Share hashes
+
 		GSState* m_state;
 		GSOffset* m_offset;
 		GIFRegTEX0 m_TEX0;
@@ -44,6 +48,9 @@ public:
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		struct {uint32 bm[16]; const uint32* n;} m_pages;
 		const uint32* RESTRICT m_sharedbits;
+		std::shared_ptr<UpdateJob> m_job; // last tiles collected by Update, unswizzled by the rasterizer threads
+		uint64 m_hash; // GS memory contents, valid while m_hashed
+		bool m_hashed;
 
 		// m_valid
 		// fast mode: each uint32 bits map to the 32 blocks of that page
@@ -53,19 +60,56 @@ public:
 		virtual ~Texture();
 
 		bool Update(const GSVector4i& r);
+		uint32 GetInvalidTexels(const GSVector4i& r) const;
 		bool Save(const std::string& fn, bool dds = false) const;
+
+		bool Allocate();
+		bool CanShare(const Texture* t) const;
+		bool HasSameSource(const Texture* t) const;
+		uint32 GetBlockCount() const;
+		uint32 GetShape() const;
+		uint64 Hash() const;
+		bool CopyFrom(const Texture* t);
+
+		template<class T> void ForEachBlock(const GSVector4i& r, const T& f) const;
+	};
+
+	class UpdateJob
+	{
+		struct Tile {uint32 block, offset;};
+
+		const Texture* m_tex;
+		std::vector<Tile> m_tiles;
+		std::atomic<int> m_next;
+		std::atomic<int> m_done;
+		std::shared_ptr<UpdateJob> m_prev; // still unfinished when this was created, covers the same tiles
+
+	public:
+		UpdateJob(const Texture* t, const std::shared_ptr<UpdateJob>& prev);
+
+		void Add(uint32 block, uint32 offset) {m_tiles.push_back({block, offset});}
+		bool IsDone() const {return m_done == (int)m_tiles.size();}
+		void Run();
 	};
 
 protected:
 	GSState* m_state;
 	std::unordered_set<Texture*> m_textures;
-	std::array<FastList<Texture*>, MAX_PAGES> m_map;
+	std::array<FastList<Texture*>, MAX_PAGES> m_map; // for InvalidatePages
+	std::unordered_multimap<uint64, Texture*> m_index; // TBP0 TBW PSM TW TH => Lookup
+	std::unordered_multimap<uint64, Texture*> m_content; // Texture::m_hash => textures with the same decoded data at other addresses
+	std::unordered_map<uint32, uint32> m_shapes; // Texture::GetShape => number of those in m_content
+
+	void AddContent(Texture* t);
+	void RemoveContent(Texture* t);
+	void Remove(Texture* t);
 
 public:
 	GSTextureCacheSW(GSState* state);
 	virtual ~GSTextureCacheSW();
 
 	Texture* Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0 = 0);
+	void Share(Texture* t);
 
 	void InvalidatePages(const uint32* pages, uint32 psm);
 
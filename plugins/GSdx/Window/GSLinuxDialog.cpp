@@ -552,6 +552,7 @@ void populate_debug_table(GtkWidget* debug_table)
 void populate_record_table(GtkWidget* record_table)
 {
 	GtkWidget* capture_check = CreateCheckBox("Enable Recording (with F12)", "capture_enabled");
+	GtkWidget* y4m_check     = CreateCheckBox("Y4M Video (uncompressed)", "capture_y4m");
 	GtkWidget* resxy_label   = left_label("Resolution:");
 	GtkWidget* resx_spin     = CreateSpinButton(256, 8192, "CaptureWidth");
 	GtkWidget* resy_spin     = CreateSpinButton(256, 8192, "CaptureHeight");
@@ -562,7 +563,7 @@ void populate_record_table(GtkWidget* record_table)
 	GtkWidget* png_label     = left_label("PNG Compression Level:");
 	GtkWidget* png_level     = CreateSpinButton(1, 9, "png_compression_level");
 
-	InsertWidgetInTable(record_table , capture_check);
+	InsertWidgetInTable(record_table , capture_check , y4m_check);
 	InsertWidgetInTable(record_table , resxy_label   , resx_spin      , resy_spin);
 	InsertWidgetInTable(record_table , threads_label , threads_spin);
 	InsertWidgetInTable(record_table , png_label     , png_level);
@@ -0,0 +1,309 @@
+//
+// ipucheck - compares the AVX2 IPU kernels with the reference code they replace, on this
+// cpu.  Exits with 0 when every kernel matches (or when the cpu has no AVX2), 1 otherwise.
+//
+// usage: ipucheck
+//
+// Links pcsx2/IPU/mpeg2lib/Idct.cpp, pcsx2/IPU/yuv2rgb.cpp and pcsx2/IPU/IPUdither.cpp
+// as they are built into the emulator, see the ipucheck target in pcsx2/CMakeLists.txt.
+//
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+
+#include "IPU/IPU.h"
+#include "IPU/yuv2rgb.h"
+#include "IPU/mpeg2lib/Mpeg.h"
+
+#include <cstdio>
+#include <cstring>
+
+// IPU state the kernels work on; the emulator defines these in IPU.cpp and Memory.cpp.
+__aligned16 decoder_t decoder;
+rgb16_t vqclut[16];
+__pagealigned u8 eeHw[Ps2MemSize::Hardware];
+
+// xorshift32, so every run checks the same inputs.
+class Random
+{
+	u32 m_state;
+
+public:
+	explicit Random(u32 seed) : m_state(seed) {}
+
+	u32 operator()()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+};
+
+// Reports the first few mismatches of a kernel and counts all of them.
+class Mismatches
+{
+	const char* m_kernel;
+	int m_count;
+
+public:
+	explicit Mismatches(const char* kernel) : m_kernel(kernel), m_count(0) {}
+
+	void Report(const char* what)
+	{
+		if (m_count++ < 4)
+			std::fprintf(stderr, "%s mismatch: %s\n", m_kernel, what);
+	}
+
+	bool Passed() const
+	{
+		std::printf("%-16s %s\n", m_kernel, m_count ? "FAILED" : "ok");
+		return m_count == 0;
+	}
+};
+
+// --------------------------------------------------------------------------------------
+//  IDCT
+// --------------------------------------------------------------------------------------
+// Runs both IDCTs on the same block and compares the output and the cleared block.  The copy
+// variant is only compared when every output of the add variant fits clip_lut, since CLIP
+// isn't defined outside of it.
+
+static bool idct_check_block(const s16 (&input)[64])
+{
+	static const int stride = 16;
+	__aligned16 s16 ref_block[64], fast_block[64];
+	__aligned16 s16 ref_add[8 * stride], fast_add[8 * stride];
+	__aligned16 u8 ref_copy[8 * stride], fast_copy[8 * stride];
+
+	memcpy(ref_block, input, sizeof(ref_block));
+	memcpy(fast_block, input, sizeof(fast_block));
+	memset(ref_add, 0x55, sizeof(ref_add));
+	memset(fast_add, 0x55, sizeof(fast_add));
+
+	idct_add_c(ref_block, ref_add, stride);
+	idct_add_avx2(fast_block, fast_add, stride);
+
+	if (memcmp(ref_add, fast_add, sizeof(ref_add)) || memcmp(ref_block, fast_block, sizeof(ref_block)))
+		return false;
+
+	for (int i = 0; i < 8; i++)
+		for (int j = 0; j < 8; j++)
+			if (ref_add[i * stride + j] < -384 || ref_add[i * stride + j] > 639)
+				return true;
+
+	memcpy(ref_block, input, sizeof(ref_block));
+	memcpy(fast_block, input, sizeof(fast_block));
+	memset(ref_copy, 0x55, sizeof(ref_copy));
+	memset(fast_copy, 0x55, sizeof(fast_copy));
+
+	idct_copy_c(ref_block, ref_copy, stride);
+	idct_copy_avx2(fast_block, fast_copy, stride);
+
+	return !memcmp(ref_copy, fast_copy, sizeof(ref_copy)) && !memcmp(ref_block, fast_block, sizeof(ref_block));
+}
+
+// Dequantized coefficients are saturated to [-2048, 2047] before they reach the IDCT.
+static bool idct_check(Random& random)
+{
+	static const s16 edges[] = { -2048, -2047, -256, -1, 1, 255, 2046, 2047 };
+
+	s16 block[64];
+	Mismatches mismatches("idct_avx2");
+	const auto check = [&](const char* what) {
+		if (!idct_check_block(block))
+			mismatches.Report(what);
+	};
+
+	memzero(block);
+	check("zero block");
+
+	for (s16 v : edges)
+	{
+		memzero(block);
+		block[0] = v;
+		check("DC only");
+
+		for (int i = 0; i < 64; i++)
+			block[i] = v;
+		check("constant block");
+
+		for (int i = 0; i < 64; i++)
+			block[i] = (i + (i >> 3)) & 1 ? v : -v - 1;
+		check("checkerboard");
+
+		for (int pos = 1; pos < 64; pos++)
+		{
+			memzero(block);
+			block[pos] = v;
+			check("single AC coefficient");
+		}
+	}
+
+	for (int n = 0; n < 4096; n++)
+	{
+		for (int i = 0; i < 64; i++)
+			block[i] = (s16)(random() % 4096) - 2048;
+		check("random block");
+
+		// typical blocks: a few low frequency coefficients
+		memzero(block);
+		for (int i = random() % 8; i >= 0; i--)
+			block[random() % 24] = (s16)(random() % 1024) - 512;
+		check("sparse block");
+	}
+
+	return mismatches.Passed();
+}
+
+// --------------------------------------------------------------------------------------
+//  CSC (yuv2rgb)
+// --------------------------------------------------------------------------------------
+// Every Cb/Cr pair is converted with varying luma, plus macroblocks of edge values.
+
+static bool yuv2rgb_check()
+{
+	static const u8 edges[] = { 0, 1, 15, 16, 17, 127, 128, 129, 234, 235, 236, 239, 240, 241, 254, 255 };
+
+	Mismatches mismatches("yuv2rgb_avx2");
+	const auto check = [&](const char* what) {
+		yuv2rgb_reference();
+		const macroblock_rgb32 ref = decoder.rgb32;
+		yuv2rgb_sse2();
+		const macroblock_rgb32 sse2 = decoder.rgb32;
+		yuv2rgb_avx2();
+
+		if (memcmp(&ref, &decoder.rgb32, sizeof(ref)) || memcmp(&sse2, &decoder.rgb32, sizeof(sse2)))
+			mismatches.Report(what);
+	};
+
+	// 1024 macroblocks of 64 chroma pairs cover all 65536 of them
+	for (int n = 0; n < 1024; n++)
+	{
+		for (int i = 0; i < 64; i++)
+		{
+			const int pair = n * 64 + i;
+			decoder.mb8.Cb[i >> 3][i & 7] = pair & 0xff;
+			decoder.mb8.Cr[i >> 3][i & 7] = pair >> 8;
+		}
+		for (int y = 0; y < 16; y++)
+			for (int x = 0; x < 16; x++)
+				decoder.mb8.Y[y][x] = (n * 7 + y * 16 + x) & 0xff;
+		check("chroma sweep");
+	}
+
+	for (u8 y : edges)
+		for (u8 cb : edges)
+			for (u8 cr : edges)
+			{
+				memset(decoder.mb8.Y, y, sizeof(decoder.mb8.Y));
+				memset(decoder.mb8.Cb, cb, sizeof(decoder.mb8.Cb));
+				memset(decoder.mb8.Cr, cr, sizeof(decoder.mb8.Cr));
+				check("edge values");
+			}
+
+	return mismatches.Passed();
+}
+
+// --------------------------------------------------------------------------------------
+//  Dither
+// --------------------------------------------------------------------------------------
+// With and without dithering, with the 0x40 alpha threshold mixed in.
+
+static bool ipu_dither_check(Random& random)
+{
+	macroblock_rgb32 rgb32;
+	Mismatches mismatches("ipu_dither_avx2");
+	const auto check = [&](const char* what) {
+		for (int dte = 0; dte < 2; dte++)
+		{
+			macroblock_rgb16 ref, sse2, avx2;
+			ipu_dither_reference(rgb32, ref, dte);
+			ipu_dither_sse2(rgb32, sse2, dte);
+			ipu_dither_avx2(rgb32, avx2, dte);
+
+			if (memcmp(&ref, &avx2, sizeof(ref)) || memcmp(&sse2, &avx2, sizeof(sse2)))
+				mismatches.Report(what);
+		}
+	};
+
+	// every channel value, including the alpha threshold and the saturating ends
+	for (int v = 0; v < 256; v++)
+	{
+		memset(&rgb32, v, sizeof(rgb32));
+		check("constant macroblock");
+	}
+
+	for (int n = 0; n < 1024; n++)
+	{
+		u8* bytes = reinterpret_cast<u8*>(&rgb32);
+		for (size_t i = 0; i < sizeof(rgb32); i++)
+			bytes[i] = random() & 0xff;
+		for (int y = 0; y < 16; y++)
+			for (int x = 0; x < 16; x++)
+				if (random() & 1)
+					rgb32.c[y][x].a = 0x40;
+		check("random macroblock");
+	}
+
+	return mismatches.Passed();
+}
+
+// --------------------------------------------------------------------------------------
+//  VQ
+// --------------------------------------------------------------------------------------
+// All 32768 colours are searched against a random CLUT, one with duplicate entries (ties go
+// to the lowest index) and one with the extreme colours.
+
+static bool ipu_vq_check(Random& random)
+{
+	static const char* const cluts[] = { "random clut", "clut with ties", "extreme clut" };
+
+	Mismatches mismatches("ipu_vq_avx2");
+	for (int clut = 0; clut < 3; clut++)
+	{
+		for (int k = 0; k < 16; k++)
+		{
+			const u32 c = (clut == 0) ? random() : (clut == 1) ? (k >> 2) * 0x2108421 : (k & 1) ? 0x7fff : 0;
+			vqclut[k].r = c & 0x1f;
+			vqclut[k].g = (c >> 5) & 0x1f;
+			vqclut[k].b = (c >> 10) & 0x1f;
+			vqclut[k].a = 0;
+		}
+
+		macroblock_rgb16 rgb16;
+		for (int n = 0; n < 128; n++)
+		{
+			for (int i = 0; i < 256; i++)
+				*(u16*)&rgb16.c[i >> 4][i & 15] = (n * 256 + i) | ((i & 1) << 15);
+
+			u8 ref[128], avx2[128];
+			ipu_vq_c(rgb16, ref);
+			ipu_vq_avx2(rgb16, avx2);
+
+			if (memcmp(ref, avx2, sizeof(ref)))
+				mismatches.Report(cluts[clut]);
+		}
+	}
+
+	return mismatches.Passed();
+}
+
+int main(int argc, char* argv[])
+{
+	x86caps.Identify();
+	if (!x86caps.hasAVX2)
+	{
+		std::printf("This cpu has no AVX2, nothing to check.\n");
+		return 0;
+	}
+
+	Random random(0x6C8E9CF5);
+
+	bool ok = idct_check(random);
+	ok &= yuv2rgb_check();
+	ok &= ipu_dither_check(random);
+	ok &= ipu_vq_check(random);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+//
+// tracedump - renders the binary trace logs (emuLog.trace) written by PCSX2 when
+// "Binary trace" is enabled in the log options, back into emuLog.txt text.
+//
+// usage: tracedump emuLog.trace [emuLog.txt]
+//
+// The record layout and the printf format parser are shared with the emulator, see
+// pcsx2/DebugTools/BinaryTrace.h.
+//
+
+#include "../../pcsx2/DebugTools/BinaryTrace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace BinaryTrace;
+
+struct Source
+{
+	std::string name;
+	std::string tag;
+	bool prefix;
+};
+
+static std::vector<std::string> s_formats;
+static std::vector<Source> s_sources;
+static u64 s_dropped = 0;
+
+static bool ReadData(FILE* in, const Record& rec, std::string& data)
+{
+	std::vector<Record> recs(rec.extra);
+	if (rec.extra && fread(recs.data(), sizeof(Record), rec.extra, in) != rec.extra)
+		return false;
+
+	data.assign((const char*)recs.data(), rec.extra * sizeof(Record));
+	return true;
+}
+
+static std::string DataString(const std::string& data, size_t pos = 0)
+{
+	if (pos >= data.size())
+		return std::string();
+	return std::string(data.c_str() + pos);
+}
+
+static void RenderConversion(FILE* out, const Conversion& c, const Record& rec, uint& arg,
+	const std::string& data, size_t& strpos)
+{
+	int stars[2] = {};
+	uint nstars = 0;
+
+	for (uint i = 0; i + 1 < c.count; i++)
+		stars[nstars++] = (arg < MaxArgs) ? (int)rec.args[arg++] : 0;
+
+	u64 value = (arg < MaxArgs) ? rec.args[arg++] : 0;
+
+	// rebuild the conversion with length modifiers that match what the value is stored as
+	std::string spec = c.spec;
+	switch (c.types[c.count - 1])
+	{
+		case Arg_Int64:
+			spec += (c.conv == 'p') ? "llx" : std::string("ll") + c.conv;
+			if (c.conv == 'p') spec.insert(1, "#");
+			break;
+		default:
+			spec += (c.conv == 'p') ? 'x' : c.conv;
+			if (c.conv == 'p') spec.insert(1, "#");
+			break;
+	}
+
+	char buf[MaxText];
+	switch (c.types[c.count - 1])
+	{
+		case Arg_Int32:
+		{
+			u32 v = (u32)value;
+			if (nstars == 2)		snprintf(buf, sizeof(buf), spec.c_str(), stars[0], stars[1], v);
+			else if (nstars == 1)	snprintf(buf, sizeof(buf), spec.c_str(), stars[0], v);
+			else					snprintf(buf, sizeof(buf), spec.c_str(), v);
+			break;
+		}
+		case Arg_Int64:
+		{
+			unsigned long long v = value;
+			if (nstars == 2)		snprintf(buf, sizeof(buf), spec.c_str(), stars[0], stars[1], v);
+			else if (nstars == 1)	snprintf(buf, sizeof(buf), spec.c_str(), stars[0], v);
+			else					snprintf(buf, sizeof(buf), spec.c_str(), v);
+			break;
+		}
+		case Arg_Double:
+		{
+			double v;
+			memcpy(&v, &value, sizeof(v));
+			if (nstars == 2)		snprintf(buf, sizeof(buf), spec.c_str(), stars[0], stars[1], v);
+			else if (nstars == 1)	snprintf(buf, sizeof(buf), spec.c_str(), stars[0], v);
+			else					snprintf(buf, sizeof(buf), spec.c_str(), v);
+			break;
+		}
+		case Arg_String:
+		{
+			size_t len = (size_t)value;
+			std::string v = (strpos < data.size()) ? data.substr(strpos, len) : std::string();
+			strpos += len;
+			if (nstars == 2)		snprintf(buf, sizeof(buf), spec.c_str(), stars[0], stars[1], v.c_str());
+			else if (nstars == 1)	snprintf(buf, sizeof(buf), spec.c_str(), stars[0], v.c_str());
+			else					snprintf(buf, sizeof(buf), spec.c_str(), v.c_str());
+			break;
+		}
+		default:
+			buf[0] = 0;
+			break;
+	}
+
+	fputs(buf, out);
+}
+
+static void RenderEntry(FILE* out, const Record& rec, const std::string& data)
+{
+	if (rec.source < s_sources.size() && s_sources[rec.source].prefix)
+	{
+		const Source& src = s_sources[rec.source];
+		fprintf(out, "%-4s(%8.8x %8.8x): %s", src.name.c_str(), rec.pc, rec.cycle, src.tag.c_str());
+	}
+
+	if (rec.format >= s_formats.size() || s_formats[rec.format].empty())
+	{
+		fprintf(out, "(tracedump) unknown format %u\n", rec.format);
+		return;
+	}
+
+	uint arg = 0;
+	size_t strpos = 0;
+	ParseFormat(s_formats[rec.format].c_str(),
+		[&](const char* text, size_t len) { fwrite(text, 1, len, out); },
+		[&](const Conversion& c) { RenderConversion(out, c, rec, arg, data, strpos); });
+
+	fputc('\n', out);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "usage: %s emuLog.trace [output.txt]\n", argv[0]);
+		return 1;
+	}
+
+	FILE* in = fopen(argv[1], "rb");
+	if (!in)
+	{
+		fprintf(stderr, "tracedump: can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* out = (argc == 3) ? fopen(argv[2], "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "tracedump: can't create %s\n", argv[2]);
+		return 1;
+	}
+
+	FileHeader header;
+	if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != FileMagic)
+	{
+		fprintf(stderr, "tracedump: %s is not a PCSX2 binary trace\n", argv[1]);
+		return 1;
+	}
+
+	if (header.version != FileVersion || header.recordSize != sizeof(Record))
+	{
+		fprintf(stderr, "tracedump: unsupported trace version %u\n", header.version);
+		return 1;
+	}
+
+	Record rec;
+	std::string data;
+	while (fread(&rec, sizeof(rec), 1, in) == 1)
+	{
+		if (rec.type != Record_Thread && rec.type != Record_Dropped && !ReadData(in, rec, data))
+			break;
+
+		switch (rec.type)
+		{
+			case Record_Entry:
+				RenderEntry(out, rec, data);
+				break;
+
+			case Record_Format:
+				if (rec.format >= s_formats.size())
+					s_formats.resize(rec.format + 1);
+				s_formats[rec.format] = DataString(data);
+				break;
+
+			case Record_Source:
+			{
+				if (rec.source >= s_sources.size())
+					s_sources.resize(rec.source + 1);
+
+				Source& src = s_sources[rec.source];
+				src.name = DataString(data);
+				src.tag = DataString(data, src.name.size() + 1);
+				src.prefix = rec.flags != 0;
+				break;
+			}
+
+			case Record_Dropped:
+				fprintf(out, "(tracedump) %llu trace entries dropped\n", (unsigned long long)rec.args[0]);
+				s_dropped += rec.args[0];
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	if (s_dropped)
+		fprintf(stderr, "tracedump: %llu entries were dropped while recording\n", (unsigned long long)s_dropped);
+
+	fclose(in);
+	if (out != stdout)
+		fclose(out);
+
+	return 0;
+}